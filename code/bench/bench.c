@@ -0,0 +1,166 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+bench_config_t bench_config = { 0, 0 };
+
+typedef struct {
+    const char *benchmark;
+    const char *impl;
+    uint32_t threads;
+    uint64_t iterations;
+    double value;
+    const char *unit;
+} bench_result_t;
+
+static bench_result_t *results = NULL;
+static size_t result_count = 0;
+static size_t result_capacity = 0;
+
+void bench_record(const char *benchmark, const char *impl, uint32_t threads,
+                  uint64_t iterations, double value, const char *unit) {
+    if (result_count == result_capacity) {
+        size_t capacity = result_capacity ? result_capacity * 2 : 64;
+        bench_result_t *grown = (bench_result_t *)realloc(results, capacity * sizeof(*grown));
+        if (!grown) return;
+        results = grown;
+        result_capacity = capacity;
+    }
+
+    bench_result_t result = { benchmark, impl, threads, iterations, value, unit };
+    results[result_count++] = result;
+    fprintf(stderr, "%-24s %-8s threads=%-3u %14.1f %s\n", benchmark, impl, threads, value, unit);
+}
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void bench_sleep_us(uint32_t us) {
+    struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+uint64_t bench_iterations(uint64_t full) {
+    uint64_t n = bench_config.quick ? full / 20 : full;
+    return n ? n : 1;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+uint64_t bench_percentile(uint64_t *samples, size_t count, double p) {
+    if (count == 0) return 0;
+    qsort(samples, count, sizeof(*samples), compare_u64);
+    size_t index = (size_t)(p / 100.0 * (double)(count - 1) + 0.5);
+    return samples[index < count ? index : count - 1];
+}
+
+uint32_t bench_thread_counts(uint32_t *counts, uint32_t capacity) {
+    uint32_t n = 0;
+    for (uint32_t t = 1; t < bench_config.max_threads && n < capacity; t *= 2) {
+        counts[n++] = t;
+    }
+    if (n < capacity) counts[n++] = bench_config.max_threads;
+    return n;
+}
+
+static void write_csv(FILE *out) {
+    fprintf(out, "benchmark,impl,threads,iterations,value,unit\n");
+    for (size_t i = 0; i < result_count; i++) {
+        bench_result_t *r = &results[i];
+        fprintf(out, "%s,%s,%u,%llu,%.3f,%s\n", r->benchmark, r->impl, r->threads,
+                (unsigned long long)r->iterations, r->value, r->unit);
+    }
+}
+
+static void write_json(FILE *out) {
+    fprintf(out, "{\n  \"schema\": 1,\n  \"cpus\": %u,\n  \"results\": [\n", bench_config.max_threads);
+    for (size_t i = 0; i < result_count; i++) {
+        bench_result_t *r = &results[i];
+        fprintf(out, "    {\"benchmark\": \"%s\", \"impl\": \"%s\", \"threads\": %u, "
+                     "\"iterations\": %llu, \"value\": %.3f, \"unit\": \"%s\"}%s\n",
+                r->benchmark, r->impl, r->threads, (unsigned long long)r->iterations,
+                r->value, r->unit, i + 1 < result_count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static int write_file(const char *path, void (*writer)(FILE *)) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return -1;
+    }
+    writer(out);
+    fclose(out);
+    return 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--quick] [--threads N] [--only pool|sync|fiber|threads|map]\n"
+            "          [--csv PATH] [--json PATH]\n"
+            "Results go to stdout as CSV unless --csv or --json is given.\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    const char *csv_path = NULL;
+    const char *json_path = NULL;
+    const char *only = NULL;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    bench_config.max_threads = cpus > 0 ? (uint32_t)cpus : 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            bench_config.quick = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            bench_config.max_threads = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (bench_config.max_threads == 0) bench_config.max_threads = 1;
+
+    if (!only || strcmp(only, "pool") == 0) bench_pool();
+    if (!only || strcmp(only, "sync") == 0) bench_sync();
+    if (!only || strcmp(only, "fiber") == 0) bench_fiber();
+    if (!only || strcmp(only, "threads") == 0) bench_threads();
+    if (!only || strcmp(only, "map") == 0) bench_map();
+
+    int status = 0;
+    if (csv_path) status |= write_file(csv_path, write_csv);
+    if (json_path) status |= write_file(json_path, write_json);
+    if (!csv_path && !json_path) write_csv(stdout);
+
+    free(results);
+    return status ? 1 : 0;
+}
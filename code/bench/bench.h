@@ -0,0 +1,56 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_BENCH_H
+#define FOSSIL_THREADS_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Shared plumbing for the benchmark suite. Every benchmark runs once against
+ * the library and once against a raw pthread (or ucontext) baseline and
+ * reports both through bench_record. */
+
+typedef struct {
+    uint32_t quick;      // Scale iteration counts down for smoke runs.
+    uint32_t max_threads;
+} bench_config_t;
+
+extern bench_config_t bench_config;
+
+/** Record one measurement. impl is "fossil" or the baseline's name. */
+void bench_record(const char *benchmark, const char *impl, uint32_t threads,
+                  uint64_t iterations, double value, const char *unit);
+
+/** Monotonic clock in nanoseconds. */
+uint64_t bench_now_ns(void);
+
+/** Sleep for roughly the given number of microseconds. */
+void bench_sleep_us(uint32_t us);
+
+/** Iteration count scaled by --quick. */
+uint64_t bench_iterations(uint64_t full);
+
+/** Sort samples in place and return the p-th percentile (0..100). */
+uint64_t bench_percentile(uint64_t *samples, size_t count, double p);
+
+/** Thread counts to sweep: 1, 2, 4, ... up to max_threads. Returns count. */
+uint32_t bench_thread_counts(uint32_t *counts, uint32_t capacity);
+
+void bench_pool(void);
+void bench_sync(void);
+void bench_fiber(void);
+void bench_threads(void);
+void bench_map(void);
+
+#endif /* FOSSIL_THREADS_BENCH_H */
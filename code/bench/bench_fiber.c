@@ -0,0 +1,102 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include "fossil/threads/fiber.h"
+#include <stdlib.h>
+#include <ucontext.h>
+
+#define FIBER_STACK (64 * 1024)
+
+/* -------- Library fibers -------- */
+
+static fossil_fiber_t main_fiber;
+
+static void empty_fiber(void *arg) {
+    (void)arg;
+}
+
+static void pingpong_fiber(void *arg) {
+    (void)arg;
+    for (;;) {
+        fossil_fiber_switch(main_fiber);
+    }
+}
+
+/* -------- Raw ucontext baseline -------- */
+
+static ucontext_t raw_main;
+static ucontext_t raw_fiber;
+
+static void raw_pingpong(void) {
+    for (;;) {
+        swapcontext(&raw_fiber, &raw_main);
+    }
+}
+
+static void raw_empty(void) {
+}
+
+void bench_fiber(void) {
+    uint64_t creates = bench_iterations(20000);
+    uint64_t switches = bench_iterations(2000000);
+
+    // Create + delete.
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < creates; i++) {
+        fossil_fiber_t fiber = fossil_fiber_create(FIBER_STACK, empty_fiber, NULL);
+        fossil_fiber_delete(fiber);
+    }
+    bench_record("fiber_create", "fossil", 1, creates,
+                 (double)(bench_now_ns() - start) / (double)creates, "ns/op");
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < creates; i++) {
+        ucontext_t *ctx = (ucontext_t *)malloc(sizeof(ucontext_t));
+        getcontext(ctx);
+        ctx->uc_stack.ss_sp = malloc(FIBER_STACK);
+        ctx->uc_stack.ss_size = FIBER_STACK;
+        ctx->uc_link = NULL;
+        makecontext(ctx, raw_empty, 0);
+        free(ctx->uc_stack.ss_sp);
+        free(ctx);
+    }
+    bench_record("fiber_create", "ucontext", 1, creates,
+                 (double)(bench_now_ns() - start) / (double)creates, "ns/op");
+
+    // Switch round trip: main -> fiber -> main.
+    main_fiber = fossil_fiber_convert(NULL);
+    fossil_fiber_t fiber = fossil_fiber_create(FIBER_STACK, pingpong_fiber, NULL);
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < switches; i++) {
+        fossil_fiber_switch(fiber);
+    }
+    bench_record("fiber_switch", "fossil", 1, switches,
+                 (double)(bench_now_ns() - start) / (double)switches, "ns/roundtrip");
+    fossil_fiber_delete(fiber);
+    fossil_fiber_delete(main_fiber);
+
+    void *stack = malloc(FIBER_STACK);
+    getcontext(&raw_fiber);
+    raw_fiber.uc_stack.ss_sp = stack;
+    raw_fiber.uc_stack.ss_size = FIBER_STACK;
+    raw_fiber.uc_link = NULL;
+    makecontext(&raw_fiber, raw_pingpong, 0);
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < switches; i++) {
+        swapcontext(&raw_main, &raw_fiber);
+    }
+    bench_record("fiber_switch", "ucontext", 1, switches,
+                 (double)(bench_now_ns() - start) / (double)switches, "ns/roundtrip");
+    free(stack);
+}
@@ -0,0 +1,92 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include "fossil/threads/epoch.h"
+#include "fossil/threads/map.h"
+#include <pthread.h>
+
+#define MAX_READERS 64
+#define MAP_KEYS 65536
+
+/* -------- Map: read-mostly lookups, lock-free vs one big mutex -------- */
+
+typedef struct {
+    fossil_concurrent_map_t map;
+    pthread_mutex_t lock;
+    uint64_t lookups;
+    int use_lock;
+} map_shared_t;
+
+static void *map_reader(void *arg) {
+    map_shared_t *shared = (map_shared_t *)arg;
+    uint64_t key = (uint64_t)(uintptr_t)&key;
+    uint64_t hits = 0;
+
+    // One critical section per batch, as a real caller would hold it.
+    fossil_epoch_enter();
+    for (uint64_t i = 0; i < shared->lookups; i++) {
+        key = key * 6364136223846793005ull + 1442695040888963407ull;
+        void *value = NULL;
+        if (shared->use_lock) {
+            pthread_mutex_lock(&shared->lock);
+            hits += fossil_concurrent_map_get(&shared->map, (key >> 32) % MAP_KEYS, &value) == 0;
+            pthread_mutex_unlock(&shared->lock);
+        } else {
+            hits += fossil_concurrent_map_get(&shared->map, (key >> 32) % MAP_KEYS, &value) == 0;
+        }
+        if ((i & 1023) == 1023) {
+            fossil_epoch_exit();
+            fossil_epoch_enter();
+        }
+    }
+    fossil_epoch_exit();
+    return (void *)(uintptr_t)hits;
+}
+
+void bench_map(void) {
+    uint32_t counts[16];
+    uint32_t n = bench_thread_counts(counts, 16);
+    uint64_t total = bench_iterations(8000000);
+    map_shared_t shared;
+
+    fossil_concurrent_map_create(&shared.map, MAP_KEYS);
+    pthread_mutex_init(&shared.lock, NULL);
+    for (uint64_t key = 0; key < MAP_KEYS; key++) {
+        fossil_concurrent_map_insert(&shared.map, key, (void *)(uintptr_t)(key + 1));
+    }
+
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t threads = counts[c] < MAX_READERS ? counts[c] : MAX_READERS;
+        pthread_t ids[MAX_READERS];
+        shared.lookups = total / threads;
+
+        for (int lockfree = 1; lockfree >= 0; lockfree--) {
+            shared.use_lock = !lockfree;
+            uint64_t start = bench_now_ns();
+            for (uint32_t i = 0; i < threads; i++) {
+                pthread_create(&ids[i], NULL, map_reader, &shared);
+            }
+            for (uint32_t i = 0; i < threads; i++) {
+                pthread_join(ids[i], NULL);
+            }
+            double elapsed = (double)(bench_now_ns() - start);
+            uint64_t lookups = shared.lookups * threads;
+            bench_record("map_lookup", lockfree ? "fossil" : "mutex", threads,
+                         lookups, (double)lookups * 1e3 / elapsed, "Mops/s");
+        }
+    }
+
+    pthread_mutex_destroy(&shared.lock);
+    fossil_concurrent_map_destroy(&shared.map);
+}
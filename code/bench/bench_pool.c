@@ -0,0 +1,204 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include "fossil/threads/pool.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+/* -------- Raw pthread baseline: one mutex, one condvar, one FIFO -------- */
+
+typedef struct base_task_t {
+    void *(*func)(void *);
+    void *arg;
+    struct base_task_t *next;
+} base_task_t;
+
+typedef struct {
+    pthread_t *threads;
+    uint32_t num_threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    base_task_t *head;
+    base_task_t *tail;
+    int shutdown;
+} base_pool_t;
+
+static void *base_worker(void *arg) {
+    base_pool_t *pool = (base_pool_t *)arg;
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->head && !pool->shutdown) {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+        base_task_t *task = pool->head;
+        if (!task) {
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+        pool->head = task->next;
+        if (!pool->head) pool->tail = NULL;
+        pthread_mutex_unlock(&pool->mutex);
+
+        task->func(task->arg);
+        free(task);
+    }
+}
+
+static void base_pool_create(base_pool_t *pool, uint32_t num_threads) {
+    pool->threads = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+    pool->num_threads = num_threads;
+    pool->head = pool->tail = NULL;
+    pool->shutdown = 0;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    for (uint32_t i = 0; i < num_threads; i++) {
+        pthread_create(&pool->threads[i], NULL, base_worker, pool);
+    }
+}
+
+static void base_pool_submit(base_pool_t *pool, void *(*func)(void *), void *arg) {
+    base_task_t *task = (base_task_t *)malloc(sizeof(*task));
+    task->func = func;
+    task->arg = arg;
+    task->next = NULL;
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->tail) pool->tail->next = task; else pool->head = task;
+    pool->tail = task;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void base_pool_destroy(base_pool_t *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+    for (uint32_t i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+    free(pool->threads);
+}
+
+/* -------- Tasks -------- */
+
+static void *count_task(void *arg) {
+    __atomic_fetch_add((uint64_t *)arg, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+typedef struct {
+    uint64_t started_ns;
+    uint32_t done;
+} latency_probe_t;
+
+static void *latency_task(void *arg) {
+    latency_probe_t *probe = (latency_probe_t *)arg;
+    probe->started_ns = bench_now_ns();
+    __atomic_store_n(&probe->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void wait_count(uint64_t *counter, uint64_t target) {
+    while (__atomic_load_n(counter, __ATOMIC_ACQUIRE) < target) {
+        sched_yield();
+    }
+}
+
+/* -------- Benchmarks -------- */
+
+static void bench_pool_throughput(void) {
+    uint32_t counts[16];
+    uint32_t n = bench_thread_counts(counts, 16);
+    uint64_t tasks = bench_iterations(1000000);
+
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t threads = counts[c];
+        uint64_t done = 0;
+
+        fossil_thread_pool_t pool;
+        fossil_thread_pool_create(&pool, threads);
+        uint64_t start = bench_now_ns();
+        for (uint64_t i = 0; i < tasks; i++) {
+            fossil_thread_pool_submit(&pool, count_task, &done);
+        }
+        wait_count(&done, tasks);
+        uint64_t elapsed = bench_now_ns() - start;
+        fossil_thread_pool_destroy(&pool);
+        bench_record("pool_throughput", "fossil", threads, tasks, tasks * 1e9 / (double)elapsed, "tasks/s");
+
+        done = 0;
+        base_pool_t base;
+        base_pool_create(&base, threads);
+        start = bench_now_ns();
+        for (uint64_t i = 0; i < tasks; i++) {
+            base_pool_submit(&base, count_task, &done);
+        }
+        wait_count(&done, tasks);
+        elapsed = bench_now_ns() - start;
+        base_pool_destroy(&base);
+        bench_record("pool_throughput", "pthread", threads, tasks, tasks * 1e9 / (double)elapsed, "tasks/s");
+    }
+}
+
+// Submit one task at a time and time how long it takes to start. With a gap
+// between samples the workers are parked; without one they are still hot.
+static void bench_pool_latency(uint32_t gap_us, const char *p50, const char *p99) {
+    uint32_t threads = bench_config.max_threads < 4 ? bench_config.max_threads : 4;
+    uint64_t samples = bench_iterations(gap_us ? 2000 : 20000);
+    uint64_t *lat = (uint64_t *)malloc(samples * sizeof(uint64_t));
+    latency_probe_t probe;
+
+    fossil_thread_pool_t pool;
+    fossil_thread_pool_create(&pool, threads);
+    for (uint64_t i = 0; i < samples; i++) {
+        if (gap_us) bench_sleep_us(gap_us);
+        probe.done = 0;
+        uint64_t submitted = bench_now_ns();
+        fossil_thread_pool_submit(&pool, latency_task, &probe);
+        while (!__atomic_load_n(&probe.done, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+        lat[i] = probe.started_ns - submitted;
+    }
+    fossil_thread_pool_destroy(&pool);
+    bench_record(p50, "fossil", threads, samples, (double)bench_percentile(lat, samples, 50.0), "ns");
+    bench_record(p99, "fossil", threads, samples, (double)bench_percentile(lat, samples, 99.0), "ns");
+
+    base_pool_t base;
+    base_pool_create(&base, threads);
+    for (uint64_t i = 0; i < samples; i++) {
+        if (gap_us) bench_sleep_us(gap_us);
+        probe.done = 0;
+        uint64_t submitted = bench_now_ns();
+        base_pool_submit(&base, latency_task, &probe);
+        while (!__atomic_load_n(&probe.done, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+        lat[i] = probe.started_ns - submitted;
+    }
+    base_pool_destroy(&base);
+    bench_record(p50, "pthread", threads, samples, (double)bench_percentile(lat, samples, 50.0), "ns");
+    bench_record(p99, "pthread", threads, samples, (double)bench_percentile(lat, samples, 99.0), "ns");
+
+    free(lat);
+}
+
+void bench_pool(void) {
+    bench_pool_throughput();
+    bench_pool_latency(0, "pool_latency_hot_p50", "pool_latency_hot_p99");
+    bench_pool_latency(200, "pool_latency_parked_p50", "pool_latency_parked_p99");
+}
@@ -0,0 +1,307 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include "fossil/threads/sync.h"
+#include "fossil/threads/threads.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+
+#define MAX_RING 64
+
+/* -------- Mutex: every thread hammers one lock -------- */
+
+typedef struct {
+    fossil_mutex_t fossil;
+    pthread_mutex_t raw;
+    uint64_t counter;
+    uint64_t iterations;
+    int use_fossil;
+} mutex_shared_t;
+
+static void *mutex_worker(void *arg) {
+    mutex_shared_t *shared = (mutex_shared_t *)arg;
+    for (uint64_t i = 0; i < shared->iterations; i++) {
+        if (shared->use_fossil) {
+            fossil_mutex_lock(&shared->fossil);
+            shared->counter++;
+            fossil_mutex_unlock(&shared->fossil);
+        } else {
+            pthread_mutex_lock(&shared->raw);
+            shared->counter++;
+            pthread_mutex_unlock(&shared->raw);
+        }
+    }
+    return NULL;
+}
+
+static double run_threads(uint32_t threads, void *(*func)(void *), void **args) {
+    pthread_t ids[MAX_RING];
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < threads; i++) {
+        pthread_create(&ids[i], NULL, func, args[i]);
+    }
+    for (uint32_t i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    return (double)(bench_now_ns() - start);
+}
+
+static void bench_mutex(void) {
+    uint32_t counts[16];
+    uint32_t n = bench_thread_counts(counts, 16);
+    uint64_t total = bench_iterations(2000000);
+    void *args[MAX_RING];
+
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t threads = counts[c] < MAX_RING ? counts[c] : MAX_RING;
+        mutex_shared_t shared;
+        fossil_mutex_create(&shared.fossil);
+        pthread_mutex_init(&shared.raw, NULL);
+        shared.iterations = total / threads;
+        for (uint32_t i = 0; i < threads; i++) args[i] = &shared;
+
+        for (int fossil = 1; fossil >= 0; fossil--) {
+            shared.counter = 0;
+            shared.use_fossil = fossil;
+            double elapsed = run_threads(threads, mutex_worker, args);
+            bench_record("mutex_contended", fossil ? "fossil" : "pthread", threads,
+                         shared.counter, elapsed / (double)shared.counter, "ns/op");
+        }
+
+        fossil_mutex_destroy(&shared.fossil);
+        pthread_mutex_destroy(&shared.raw);
+    }
+}
+
+/* -------- Semaphore: pass a token around a ring of threads -------- */
+
+typedef struct {
+    fossil_semaphore_t fossil[MAX_RING];
+    sem_t raw[MAX_RING];
+    uint32_t threads;
+    uint64_t rounds;
+    int use_fossil;
+} sem_ring_t;
+
+typedef struct {
+    sem_ring_t *ring;
+    uint32_t index;
+} ring_slot_t;
+
+static void *sem_worker(void *arg) {
+    ring_slot_t *slot = (ring_slot_t *)arg;
+    sem_ring_t *ring = slot->ring;
+    uint32_t next = (slot->index + 1) % ring->threads;
+
+    for (uint64_t i = 0; i < ring->rounds; i++) {
+        if (ring->use_fossil) {
+            fossil_semaphore_wait(&ring->fossil[slot->index]);
+            fossil_semaphore_post(&ring->fossil[next]);
+        } else {
+            sem_wait(&ring->raw[slot->index]);
+            sem_post(&ring->raw[next]);
+        }
+    }
+    return NULL;
+}
+
+static void bench_semaphore(void) {
+    uint32_t counts[16];
+    uint32_t n = bench_thread_counts(counts, 16);
+    uint64_t hops = bench_iterations(200000);
+    ring_slot_t slots[MAX_RING];
+    void *args[MAX_RING];
+
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t threads = counts[c] < 2 ? 2 : (counts[c] < MAX_RING ? counts[c] : MAX_RING);
+        sem_ring_t *ring = (sem_ring_t *)malloc(sizeof(*ring));
+        ring->threads = threads;
+        ring->rounds = hops / threads;
+
+        for (int fossil = 1; fossil >= 0; fossil--) {
+            ring->use_fossil = fossil;
+            for (uint32_t i = 0; i < threads; i++) {
+                fossil_semaphore_create(&ring->fossil[i], i == 0);
+                sem_init(&ring->raw[i], 0, i == 0);
+                slots[i].ring = ring;
+                slots[i].index = i;
+                args[i] = &slots[i];
+            }
+
+            double elapsed = run_threads(threads, sem_worker, args);
+            uint64_t total = ring->rounds * threads;
+            bench_record("semaphore_ring", fossil ? "fossil" : "posix", threads,
+                         total, elapsed / (double)total, "ns/hop");
+
+            for (uint32_t i = 0; i < threads; i++) {
+                fossil_semaphore_destroy(&ring->fossil[i]);
+                sem_destroy(&ring->raw[i]);
+            }
+        }
+        free(ring);
+    }
+}
+
+/* -------- Condition variable: shared turn counter, broadcast on change -------- */
+
+typedef struct {
+    fossil_mutex_t fossil_mutex;
+    fossil_cond_t fossil_cond;
+    pthread_mutex_t raw_mutex;
+    pthread_cond_t raw_cond;
+    uint32_t threads;
+    uint64_t rounds;
+    uint64_t turn;
+    int use_fossil;
+} cond_ring_t;
+
+typedef struct {
+    cond_ring_t *ring;
+    uint32_t index;
+} cond_slot_t;
+
+static void *cond_worker(void *arg) {
+    cond_slot_t *slot = (cond_slot_t *)arg;
+    cond_ring_t *ring = slot->ring;
+
+    for (uint64_t i = 0; i < ring->rounds; i++) {
+        if (ring->use_fossil) {
+            fossil_mutex_lock(&ring->fossil_mutex);
+            while (ring->turn % ring->threads != slot->index) {
+                fossil_cond_wait(&ring->fossil_cond, &ring->fossil_mutex);
+            }
+            ring->turn++;
+            fossil_cond_broadcast(&ring->fossil_cond);
+            fossil_mutex_unlock(&ring->fossil_mutex);
+        } else {
+            pthread_mutex_lock(&ring->raw_mutex);
+            while (ring->turn % ring->threads != slot->index) {
+                pthread_cond_wait(&ring->raw_cond, &ring->raw_mutex);
+            }
+            ring->turn++;
+            pthread_cond_broadcast(&ring->raw_cond);
+            pthread_mutex_unlock(&ring->raw_mutex);
+        }
+    }
+    return NULL;
+}
+
+static void bench_cond(void) {
+    uint32_t counts[16];
+    uint32_t n = bench_thread_counts(counts, 16);
+    uint64_t hops = bench_iterations(100000);
+    cond_slot_t slots[MAX_RING];
+    void *args[MAX_RING];
+
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t threads = counts[c] < 2 ? 2 : (counts[c] < MAX_RING ? counts[c] : MAX_RING);
+        cond_ring_t ring;
+        fossil_mutex_create(&ring.fossil_mutex);
+        fossil_cond_create(&ring.fossil_cond);
+        pthread_mutex_init(&ring.raw_mutex, NULL);
+        pthread_cond_init(&ring.raw_cond, NULL);
+        ring.threads = threads;
+        ring.rounds = hops / threads;
+        for (uint32_t i = 0; i < threads; i++) {
+            slots[i].ring = &ring;
+            slots[i].index = i;
+            args[i] = &slots[i];
+        }
+
+        for (int fossil = 1; fossil >= 0; fossil--) {
+            ring.turn = 0;
+            ring.use_fossil = fossil;
+            double elapsed = run_threads(threads, cond_worker, args);
+            bench_record("cond_ring", fossil ? "fossil" : "pthread", threads,
+                         ring.turn, elapsed / (double)ring.turn, "ns/hop");
+        }
+
+        fossil_mutex_destroy(&ring.fossil_mutex);
+        fossil_cond_destroy(&ring.fossil_cond);
+        pthread_mutex_destroy(&ring.raw_mutex);
+        pthread_cond_destroy(&ring.raw_cond);
+    }
+}
+
+/* -------- Barrier: short phases separated by a barrier -------- */
+
+typedef struct {
+    fossil_barrier_t flat;
+    fossil_barrier_t tree;
+    pthread_barrier_t raw;
+    uint64_t phases;
+    int impl; // 0 = pthread, 1 = fossil flat, 2 = fossil tree
+} barrier_shared_t;
+
+typedef struct {
+    barrier_shared_t *shared;
+    uint32_t index;
+} barrier_slot_t;
+
+static void *barrier_worker(void *arg) {
+    barrier_slot_t *slot = (barrier_slot_t *)arg;
+    barrier_shared_t *shared = slot->shared;
+
+    for (uint64_t i = 0; i < shared->phases; i++) {
+        if (shared->impl == 2) {
+            fossil_barrier_wait_id(&shared->tree, slot->index);
+        } else if (shared->impl == 1) {
+            fossil_barrier_wait(&shared->flat);
+        } else {
+            pthread_barrier_wait(&shared->raw);
+        }
+    }
+    return NULL;
+}
+
+static void bench_barrier(void) {
+    static const char *names[] = { "pthread", "fossil", "fossil_tree" };
+    uint32_t counts[16];
+    uint32_t n = bench_thread_counts(counts, 16);
+    barrier_slot_t slots[MAX_RING];
+    void *args[MAX_RING];
+
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t threads = counts[c] < 2 ? 2 : (counts[c] < MAX_RING ? counts[c] : MAX_RING);
+        barrier_shared_t shared;
+        fossil_barrier_create(&shared.flat, threads);
+        fossil_barrier_create_tree(&shared.tree, threads, 4);
+        pthread_barrier_init(&shared.raw, NULL, threads);
+        shared.phases = bench_iterations(20000);
+        for (uint32_t i = 0; i < threads; i++) {
+            slots[i].shared = &shared;
+            slots[i].index = i;
+            args[i] = &slots[i];
+        }
+
+        for (int impl = 2; impl >= 0; impl--) {
+            shared.impl = impl;
+            double elapsed = run_threads(threads, barrier_worker, args);
+            bench_record("barrier_phase", names[impl], threads,
+                         shared.phases, elapsed / (double)shared.phases, "ns/phase");
+        }
+
+        fossil_barrier_destroy(&shared.flat);
+        fossil_barrier_destroy(&shared.tree);
+        pthread_barrier_destroy(&shared.raw);
+    }
+}
+
+void bench_sync(void) {
+    bench_mutex();
+    bench_semaphore();
+    bench_cond();
+    bench_barrier();
+}
@@ -0,0 +1,54 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include "fossil/threads/threads.h"
+#include <pthread.h>
+
+static void *empty_thread(void *arg) {
+    return arg;
+}
+
+void bench_threads(void) {
+    uint64_t iterations = bench_iterations(5000);
+
+    uint64_t start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        fossil_thread_t thread;
+        fossil_thread_create(&thread, NULL, empty_thread, NULL);
+        fossil_thread_join(thread, NULL);
+    }
+    bench_record("thread_create_join", "fossil", 1, iterations,
+                 (double)(bench_now_ns() - start) / (double)iterations, "ns/op");
+
+    // Same loop with joined threads parked for reuse.
+    fossil_thread_cache_enable(1);
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        fossil_thread_t thread;
+        fossil_thread_create(&thread, NULL, empty_thread, NULL);
+        fossil_thread_join(thread, NULL);
+    }
+    bench_record("thread_create_join", "fossil_cached", 1, iterations,
+                 (double)(bench_now_ns() - start) / (double)iterations, "ns/op");
+    fossil_thread_cache_disable();
+
+    start = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+        pthread_t thread;
+        pthread_create(&thread, NULL, empty_thread, NULL);
+        pthread_join(thread, NULL);
+    }
+    bench_record("thread_create_join", "pthread", 1, iterations,
+                 (double)(bench_now_ns() - start) / (double)iterations, "ns/op");
+}
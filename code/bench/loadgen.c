@@ -0,0 +1,448 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/pool.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Open-loop load generator for fossil_thread_pool_t.
+ *
+ * A single generator thread submits tasks on a precomputed arrival schedule
+ * (constant or Poisson) no matter how far behind the pool is, and each task
+ * spins for a service time drawn from the configured distribution. Latency
+ * is measured from the time the task was scheduled to arrive, not from when
+ * the generator got around to submitting it, so a stalled generator or a
+ * backed-up queue cannot hide delay (coordinated omission). Each worker
+ * records into its own log-linear histogram, merged after the run.
+ */
+
+#define MAX_CONFIGS 16
+#define MAX_POINTS 32
+
+/* -------- Log-Linear Histogram -------- */
+
+// Values below HIST_LINEAR are exact; above, every power of two is split
+// into HIST_HALF buckets, so a reported value is within 1/64 of the truth.
+#define HIST_SUB_BITS 7
+#define HIST_LINEAR (1u << HIST_SUB_BITS)
+#define HIST_HALF (HIST_LINEAR / 2)
+#define HIST_BUCKETS (HIST_LINEAR + (64 - HIST_SUB_BITS) * HIST_HALF)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+} hist_t;
+
+static uint32_t hist_index(uint64_t value) {
+    if (value < HIST_LINEAR) return (uint32_t)value;
+    uint32_t shift = (uint32_t)(63 - __builtin_clzll(value)) - (HIST_SUB_BITS - 1);
+    return HIST_LINEAR + (shift - 1) * HIST_HALF + (uint32_t)((value >> shift) - HIST_HALF);
+}
+
+// Highest value that maps to bucket index.
+static uint64_t hist_value(uint32_t index) {
+    if (index < HIST_LINEAR) return index;
+    uint32_t shift = (index - HIST_LINEAR) / HIST_HALF + 1;
+    uint64_t low = (uint64_t)(HIST_HALF + (index - HIST_LINEAR) % HIST_HALF) << shift;
+    return low + ((uint64_t)1 << shift) - 1;
+}
+
+static void hist_record(hist_t *hist, uint64_t value) {
+    hist->counts[hist_index(value)]++;
+    hist->total++;
+    if (value > hist->max) hist->max = value;
+}
+
+static void hist_merge(hist_t *into, const hist_t *from) {
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        into->counts[i] += from->counts[i];
+    }
+    into->total += from->total;
+    if (from->max > into->max) into->max = from->max;
+}
+
+static uint64_t hist_percentile(const hist_t *hist, double p) {
+    if (hist->total == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(p / 100.0 * (double)hist->total);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint64_t value = hist_value(i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+/* -------- Distributions -------- */
+
+typedef enum { DIST_FIXED, DIST_EXP, DIST_BIMODAL } dist_kind_t;
+
+typedef struct {
+    dist_kind_t kind;
+    double mean_ns; // Fixed value, exponential mean, or short mode.
+    double long_ns; // Bimodal only.
+    double long_fraction;
+} dist_t;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+// Uniform in [0, 1).
+static double rng_uniform(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (double)((rng_state * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double dist_sample(const dist_t *dist) {
+    switch (dist->kind) {
+    case DIST_EXP:
+        return -dist->mean_ns * log(1.0 - rng_uniform());
+    case DIST_BIMODAL:
+        return rng_uniform() < dist->long_fraction ? dist->long_ns : dist->mean_ns;
+    default:
+        return dist->mean_ns;
+    }
+}
+
+static double dist_mean(const dist_t *dist) {
+    if (dist->kind == DIST_BIMODAL) {
+        return dist->mean_ns * (1.0 - dist->long_fraction) + dist->long_ns * dist->long_fraction;
+    }
+    return dist->mean_ns;
+}
+
+// fixed:US, exp:US or bimodal:US:LONG_US:LONG_PERCENT
+static int dist_parse(dist_t *dist, const char *text) {
+    double a = 0, b = 0, c = 0;
+    memset(dist, 0, sizeof(*dist));
+    if (sscanf(text, "fixed:%lf", &a) == 1) {
+        dist->kind = DIST_FIXED;
+    } else if (sscanf(text, "exp:%lf", &a) == 1) {
+        dist->kind = DIST_EXP;
+    } else if (sscanf(text, "bimodal:%lf:%lf:%lf", &a, &b, &c) == 3) {
+        dist->kind = DIST_BIMODAL;
+        dist->long_ns = b * 1000.0;
+        dist->long_fraction = c / 100.0;
+    } else {
+        return -1;
+    }
+    dist->mean_ns = a * 1000.0;
+    return a >= 0 && b >= 0 && c >= 0 && c <= 100 ? 0 : -1;
+}
+
+/* -------- Load Generation -------- */
+
+typedef struct {
+    uint32_t threads[MAX_CONFIGS];
+    uint32_t num_threads;
+    double rates[MAX_POINTS];  // Absolute arrival rates, per second.
+    double loads[MAX_POINTS];  // Or fractions of the nominal capacity.
+    uint32_t num_points;
+    int poisson;
+    int park;
+    double duration_s;
+    const char *service_text;
+    dist_t service;
+} loadgen_config_t;
+
+typedef struct {
+    uint64_t intended_ns;
+    uint64_t submitted_ns;
+    uint64_t service_ns;
+} request_t;
+
+typedef struct {
+    hist_t corrected;   // From the scheduled arrival.
+    hist_t uncorrected; // From the actual submit call.
+} worker_hist_t;
+
+static fossil_thread_pool_local_t worker_hists;
+static fossil_latch_t remaining;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Sleep through long gaps, then spin for precision.
+static uint64_t wait_until(uint64_t deadline) {
+    uint64_t now = now_ns();
+    if (now + 100000 < deadline) {
+        uint64_t nap = deadline - now - 50000;
+        struct timespec ts = { (time_t)(nap / 1000000000ull), (long)(nap % 1000000000ull) };
+        nanosleep(&ts, NULL);
+        now = now_ns();
+    }
+    while (now < deadline) {
+        now = now_ns();
+    }
+    return now;
+}
+
+static void *service_task(void *arg) {
+    request_t *request = (request_t *)arg;
+    uint64_t start = now_ns();
+    uint64_t done = start;
+    while (done - start < request->service_ns) {
+        done = now_ns();
+    }
+
+    worker_hist_t *hist = (worker_hist_t *)fossil_thread_pool_local_get(&worker_hists);
+    if (hist) {
+        hist_record(&hist->corrected, done - request->intended_ns);
+        hist_record(&hist->uncorrected, done - request->submitted_ns);
+    }
+    fossil_latch_count_down(&remaining, 1);
+    return NULL;
+}
+
+static int run_point(const loadgen_config_t *config, uint32_t threads, double rate, FILE *out) {
+    uint64_t count = (uint64_t)(rate * config->duration_s);
+    if (count == 0) count = 1;
+
+    request_t *requests = (request_t *)malloc(count * sizeof(request_t));
+    hist_t *corrected = (hist_t *)calloc(1, sizeof(hist_t));
+    hist_t *uncorrected = (hist_t *)calloc(1, sizeof(hist_t));
+    if (!requests || !corrected || !uncorrected) {
+        fprintf(stderr, "loadgen: out of memory for %llu requests\n", (unsigned long long)count);
+        free(requests);
+        free(corrected);
+        free(uncorrected);
+        return -1;
+    }
+
+    // Precompute the schedule so that sampling costs nothing while submitting.
+    double gap_ns = 1e9 / rate;
+    double offset = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        offset += config->poisson ? -gap_ns * log(1.0 - rng_uniform()) : gap_ns;
+        requests[i].intended_ns = (uint64_t)offset;
+        requests[i].service_ns = (uint64_t)dist_sample(&config->service);
+    }
+
+    fossil_thread_pool_t pool;
+    if (fossil_thread_pool_create(&pool, threads) != 0 ||
+        fossil_thread_pool_local_create(&worker_hists, &pool, sizeof(worker_hist_t)) != 0) {
+        fprintf(stderr, "loadgen: cannot create a pool of %u threads\n", threads);
+        free(requests);
+        free(corrected);
+        free(uncorrected);
+        return -1;
+    }
+    if (config->park) fossil_thread_pool_set_idle(&pool, 0, 0);
+    fossil_latch_create(&remaining, (uint32_t)count);
+
+    uint64_t start = now_ns() + 1000000;
+    uint64_t max_lag = 0;
+    uint64_t errors = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        request_t *request = &requests[i];
+        request->intended_ns += start;
+        uint64_t now = wait_until(request->intended_ns);
+        if (now - request->intended_ns > max_lag) max_lag = now - request->intended_ns;
+        request->submitted_ns = now;
+        if (fossil_thread_pool_submit(&pool, service_task, request) != 0) {
+            errors++;
+            fossil_latch_count_down(&remaining, 1);
+        }
+    }
+    fossil_latch_wait(&remaining);
+    uint64_t elapsed = now_ns() - start;
+
+    uint32_t slots = worker_hists.count;
+    for (uint32_t i = 0; i < slots; i++) {
+        worker_hist_t *hist = (worker_hist_t *)fossil_thread_pool_local_at(&worker_hists, i);
+        hist_merge(corrected, &hist->corrected);
+        hist_merge(uncorrected, &hist->uncorrected);
+    }
+    fossil_thread_pool_local_destroy(&worker_hists);
+    fossil_thread_pool_destroy(&pool);
+    fossil_latch_destroy(&remaining);
+
+    double achieved = (double)count * 1e9 / (double)elapsed;
+    fprintf(stderr, "threads=%-3u rate=%10.0f/s achieved=%10.0f/s  p50=%9.1fus p99=%9.1fus "
+                    "p99.9=%9.1fus max=%9.1fus  (uncorrected p99.9=%.1fus)\n",
+            threads, rate, achieved,
+            hist_percentile(corrected, 50.0) / 1e3, hist_percentile(corrected, 99.0) / 1e3,
+            hist_percentile(corrected, 99.9) / 1e3, corrected->max / 1e3,
+            hist_percentile(uncorrected, 99.9) / 1e3);
+    if (errors) {
+        fprintf(stderr, "  %llu submits failed and are left out of the latencies\n", (unsigned long long)errors);
+    }
+    if (max_lag > 1000000) {
+        fprintf(stderr, "  generator fell %.1fms behind schedule; corrected latencies include it\n", max_lag / 1e6);
+    }
+
+    fprintf(out, "%u,%s,%s,%.0f,%.0f,%llu,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+            threads, config->poisson ? "poisson" : "constant", config->service_text, rate, achieved,
+            (unsigned long long)count, (unsigned long long)errors,
+            hist_percentile(corrected, 50.0) / 1e3, hist_percentile(corrected, 90.0) / 1e3,
+            hist_percentile(corrected, 99.0) / 1e3, hist_percentile(corrected, 99.9) / 1e3,
+            hist_percentile(corrected, 99.99) / 1e3, corrected->max / 1e3,
+            hist_percentile(uncorrected, 99.9) / 1e3);
+    fflush(out);
+
+    free(requests);
+    free(corrected);
+    free(uncorrected);
+    return 0;
+}
+
+/* -------- Command Line -------- */
+
+static uint32_t parse_list(const char *text, double *values, uint32_t capacity) {
+    uint32_t n = 0;
+    char *end;
+    while (*text && n < capacity) {
+        double value = strtod(text, &end);
+        if (end == text || value <= 0) return 0;
+        values[n++] = value;
+        text = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return 0;
+    }
+    return n;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--threads N[,N...]] [--arrival poisson|constant]\n"
+            "          [--service fixed:US|exp:US|bimodal:US:LONG_US:LONG_PCT]\n"
+            "          [--load F[,F...] | --rates R[,R...] | --sweep LO:HI:STEPS]\n"
+            "          [--duration SECONDS] [--idle spin|park] [--quick] [--csv PATH]\n"
+            "Loads are fractions of the nominal capacity threads / mean service time.\n"
+            "Sweeps are geometric. One CSV row per pool configuration and rate goes to\n"
+            "stdout unless --csv is given.\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    loadgen_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.poisson = 1;
+    config.duration_s = 2.0;
+    config.service_text = "exp:10";
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    // Leave a core to the generator.
+    config.threads[0] = cpus > 2 ? (uint32_t)cpus - 1 : 1;
+    config.num_threads = 1;
+
+    static const double default_loads[] = { 0.1, 0.3, 0.5, 0.7, 0.8, 0.9, 0.95 };
+    const char *csv_path = NULL;
+    int quick = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--quick") == 0) {
+            quick = 1;
+            continue;
+        }
+        if (!value) {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+
+        int ok = 1;
+        if (strcmp(arg, "--threads") == 0) {
+            double counts[MAX_CONFIGS];
+            config.num_threads = parse_list(value, counts, MAX_CONFIGS);
+            for (uint32_t c = 0; c < config.num_threads; c++) config.threads[c] = (uint32_t)counts[c];
+            ok = config.num_threads > 0;
+        } else if (strcmp(arg, "--arrival") == 0) {
+            config.poisson = strcmp(value, "poisson") == 0;
+            ok = config.poisson || strcmp(value, "constant") == 0;
+        } else if (strcmp(arg, "--service") == 0) {
+            config.service_text = value;
+        } else if (strcmp(arg, "--load") == 0) {
+            config.num_points = parse_list(value, config.loads, MAX_POINTS);
+            memset(config.rates, 0, sizeof(config.rates));
+            ok = config.num_points > 0;
+        } else if (strcmp(arg, "--rates") == 0) {
+            config.num_points = parse_list(value, config.rates, MAX_POINTS);
+            ok = config.num_points > 0;
+        } else if (strcmp(arg, "--sweep") == 0) {
+            double lo, hi;
+            unsigned steps;
+            ok = sscanf(value, "%lf:%lf:%u", &lo, &hi, &steps) == 3 && lo > 0 && hi >= lo &&
+                 steps >= 1 && steps <= MAX_POINTS;
+            if (ok) {
+                config.num_points = steps;
+                for (unsigned s = 0; s < steps; s++) {
+                    config.rates[s] = steps == 1 ? lo : lo * pow(hi / lo, (double)s / (steps - 1));
+                }
+            }
+        } else if (strcmp(arg, "--duration") == 0) {
+            config.duration_s = strtod(value, NULL);
+            ok = config.duration_s > 0;
+        } else if (strcmp(arg, "--idle") == 0) {
+            config.park = strcmp(value, "park") == 0;
+            ok = config.park || strcmp(value, "spin") == 0;
+        } else if (strcmp(arg, "--csv") == 0) {
+            csv_path = value;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (dist_parse(&config.service, config.service_text) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (config.num_points == 0) {
+        config.num_points = sizeof(default_loads) / sizeof(default_loads[0]);
+        memcpy(config.loads, default_loads, sizeof(default_loads));
+    }
+    if (quick) config.duration_s /= 10;
+
+    FILE *out = stdout;
+    if (csv_path && !(out = fopen(csv_path, "w"))) {
+        perror(csv_path);
+        return 1;
+    }
+    fprintf(out, "threads,arrival,service,target_rate,achieved_rate,requests,errors,"
+                 "p50_us,p90_us,p99_us,p999_us,p9999_us,max_us,uncorrected_p999_us\n");
+
+    int status = 0;
+    double mean_ns = dist_mean(&config.service);
+    for (uint32_t c = 0; c < config.num_threads && status == 0; c++) {
+        uint32_t threads = config.threads[c];
+        for (uint32_t p = 0; p < config.num_points && status == 0; p++) {
+            double rate = config.rates[p];
+            if (rate == 0) {
+                // Fractions of what the workers could sustain with no overhead.
+                rate = mean_ns > 0 ? config.loads[p] * threads * 1e9 / mean_ns : config.loads[p] * 1e6;
+            }
+            status = run_point(&config, threads, rate, out);
+        }
+    }
+
+    if (out != stdout) fclose(out);
+    return status ? 1 : 0;
+}
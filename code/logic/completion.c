@@ -0,0 +1,234 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/completion.h"
+#include "platform.h"
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#elif !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+/* -------- Completion Queue -------- */
+
+struct fossil_completion_node_t {
+    void *result;
+    struct fossil_completion_node_t *next;
+};
+
+typedef struct {
+    fossil_task_t task;
+    void *arg;
+    fossil_completion_queue_t *queue;
+    fossil_completion_node_t *node; // Reserved at submit, so posting cannot fail.
+} completion_task_t;
+
+static void completion_signal(fossil_completion_queue_t *queue) {
+#if defined(__linux__)
+    uint64_t one = 1;
+    ssize_t written = write(queue->write_fd, &one, sizeof(one));
+    (void)written;
+#elif !defined(_WIN32)
+    char byte = 1;
+    ssize_t written = write(queue->write_fd, &byte, 1);
+    (void)written;
+#else
+    (void)queue;
+#endif
+}
+
+// Reset the descriptor to not readable. It is non-blocking, so this never
+// waits even if a racing post already reset it.
+static void completion_clear(fossil_completion_queue_t *queue) {
+#if defined(__linux__)
+    uint64_t count;
+    ssize_t got = read(queue->fd, &count, sizeof(count));
+    (void)got;
+#elif !defined(_WIN32)
+    char bytes[64];
+    while (read(queue->fd, bytes, sizeof(bytes)) > 0) {
+    }
+#else
+    (void)queue;
+#endif
+}
+
+// Make the queue readable unless it already is. Only the first post after a
+// drain pays for the system call.
+static void completion_arm(fossil_completion_queue_t *queue) {
+    if (__atomic_exchange_n(&queue->signalled, 1, __ATOMIC_SEQ_CST)) return;
+    completion_signal(queue);
+    if (__atomic_load_n(&queue->waiters, __ATOMIC_SEQ_CST)) {
+        fossil_platform_futex_wake(&queue->signalled, UINT32_MAX);
+    }
+}
+
+int32_t fossil_completion_create(fossil_completion_queue_t *queue) {
+    memset(queue, 0, sizeof(*queue));
+    queue->fd = -1;
+    queue->write_fd = -1;
+#if defined(__linux__)
+    queue->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->fd < 0) return -1;
+    queue->write_fd = queue->fd;
+#elif !defined(_WIN32)
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    queue->fd = fds[0];
+    queue->write_fd = fds[1];
+#endif
+    return 0;
+}
+
+int fossil_completion_fd(const fossil_completion_queue_t *queue) {
+    return queue->fd;
+}
+
+static void completion_push(fossil_completion_queue_t *queue, fossil_completion_node_t *node) {
+    fossil_completion_node_t *head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&queue->head, &head, node, 1,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    completion_arm(queue);
+}
+
+int32_t fossil_completion_post(fossil_completion_queue_t *queue, void *result) {
+    fossil_completion_node_t *node = (fossil_completion_node_t *)fossil_slab_alloc_size(sizeof(fossil_completion_node_t));
+    if (!node) return -1;
+    node->result = result;
+    completion_push(queue, node);
+    return 0;
+}
+
+size_t fossil_completion_drain(fossil_completion_queue_t *queue, void **results, size_t max) {
+    // Clear before taking the list: a post that misses the list sees the
+    // cleared flag and signals again.
+    if (__atomic_load_n(&queue->signalled, __ATOMIC_SEQ_CST)) {
+        completion_clear(queue);
+        __atomic_store_n(&queue->signalled, 0, __ATOMIC_SEQ_CST);
+    }
+
+    fossil_completion_node_t *list = __atomic_exchange_n(&queue->head, NULL, __ATOMIC_SEQ_CST);
+    if (list) {
+        // Newest first on the stack; reverse onto the end of the backlog.
+        fossil_completion_node_t *ordered = NULL;
+        fossil_completion_node_t *last = list;
+        while (list) {
+            fossil_completion_node_t *next = list->next;
+            list->next = ordered;
+            ordered = list;
+            list = next;
+        }
+        if (queue->backlog_tail) {
+            queue->backlog_tail->next = ordered;
+        } else {
+            queue->backlog = ordered;
+        }
+        queue->backlog_tail = last;
+    }
+
+    size_t count = 0;
+    while (count < max && queue->backlog) {
+        fossil_completion_node_t *node = queue->backlog;
+        queue->backlog = node->next;
+        results[count++] = node->result;
+        fossil_slab_free_size(node, sizeof(*node));
+    }
+    if (!queue->backlog) {
+        queue->backlog_tail = NULL;
+    } else {
+        completion_arm(queue);
+    }
+    return count;
+}
+
+int32_t fossil_completion_wait(fossil_completion_queue_t *queue, uint64_t timeout_ns) {
+    uint64_t deadline = timeout_ns == FOSSIL_PLATFORM_INFINITE ? 0 : fossil_platform_now_ns() + timeout_ns;
+    int32_t result = 0;
+
+    if (__atomic_load_n(&queue->signalled, __ATOMIC_SEQ_CST)) return 0;
+
+    fossil_thread_pool_enter_blocking();
+    __atomic_fetch_add(&queue->waiters, 1, __ATOMIC_SEQ_CST);
+    while (!__atomic_load_n(&queue->signalled, __ATOMIC_SEQ_CST)) {
+        uint64_t remaining = FOSSIL_PLATFORM_INFINITE;
+        if (deadline) {
+            uint64_t now = fossil_platform_now_ns();
+            if (now >= deadline) {
+                result = -1;
+                break;
+            }
+            remaining = deadline - now;
+        }
+        fossil_platform_futex_wait(&queue->signalled, 0, remaining);
+    }
+    __atomic_fetch_sub(&queue->waiters, 1, __ATOMIC_RELAXED);
+    fossil_thread_pool_leave_blocking();
+    return result;
+}
+
+// A task the pool discards still completes, so consumers counting results
+// never wait for one that is not coming.
+static void completion_invoke(void *storage, int32_t run) {
+    completion_task_t *state = (completion_task_t *)storage;
+    state->node->result = run ? state->task(state->arg) : FOSSIL_COMPLETION_DISCARDED;
+    completion_push(state->queue, state->node);
+}
+
+int32_t fossil_thread_pool_submit_completion(fossil_thread_pool_t *pool, fossil_completion_queue_t *queue,
+                                             fossil_task_t task, fossil_argumet_t arg) {
+    fossil_completion_node_t *node = (fossil_completion_node_t *)fossil_slab_alloc_size(sizeof(fossil_completion_node_t));
+    if (!node) return -1;
+
+    completion_task_t state = {task, arg, queue, node};
+    if (fossil_thread_pool_submit_inline(pool, completion_invoke, &state, sizeof(state)) != 0) {
+        fossil_slab_free_size(node, sizeof(*node));
+        return -1;
+    }
+    return 0;
+}
+
+int32_t fossil_completion_destroy(fossil_completion_queue_t *queue) {
+    fossil_completion_node_t *lists[2] = {
+        __atomic_exchange_n(&queue->head, NULL, __ATOMIC_ACQUIRE), queue->backlog
+    };
+    for (int i = 0; i < 2; i++) {
+        while (lists[i]) {
+            fossil_completion_node_t *next = lists[i]->next;
+            fossil_slab_free_size(lists[i], sizeof(*lists[i]));
+            lists[i] = next;
+        }
+    }
+    queue->backlog = NULL;
+    queue->backlog_tail = NULL;
+
+#ifndef _WIN32
+    if (queue->write_fd >= 0 && queue->write_fd != queue->fd) close(queue->write_fd);
+    if (queue->fd >= 0) close(queue->fd);
+#endif
+    queue->fd = -1;
+    queue->write_fd = -1;
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/counter.h"
+#include "platform.h"
+#include <string.h>
+
+/* -------- Sharded Counter -------- */
+
+/*
+ * The shard is picked from the current CPU when the rseq area makes that a
+ * single load, and from a per-thread ticket otherwise. Migration between
+ * reading the CPU and adding is harmless because the add is atomic; it only
+ * costs an occasional shared line.
+ */
+
+struct fossil_counter_shard_t {
+    FOSSIL_CACHE_ALIGNED int64_t value;
+};
+
+static uint32_t counter_next_ticket = 0;
+static FOSSIL_THREAD_LOCAL uint32_t counter_ticket = 0;
+static FOSSIL_THREAD_LOCAL uint32_t counter_has_ticket = 0;
+
+static inline uint32_t counter_slot(void) {
+    int32_t cpu = fossil_platform_current_cpu();
+    if (cpu >= 0) return (uint32_t)cpu;
+
+    if (!counter_has_ticket) {
+        counter_ticket = __atomic_fetch_add(&counter_next_ticket, 1, __ATOMIC_RELAXED);
+        counter_has_ticket = 1;
+    }
+    return counter_ticket;
+}
+
+int32_t fossil_sharded_counter_create(fossil_sharded_counter_t *counter, uint32_t shards) {
+    if (!counter) return -1;
+    if (shards == 0) shards = fossil_platform_cpu_count();
+
+    uint32_t count = 1;
+    while (count < shards && count < (1u << 16)) count <<= 1;
+
+    counter->shards = (fossil_counter_shard_t *)fossil_platform_aligned_alloc(
+        FOSSIL_CACHE_LINE, count * sizeof(fossil_counter_shard_t));
+    if (!counter->shards) return -1;
+
+    memset(counter->shards, 0, count * sizeof(fossil_counter_shard_t));
+    counter->mask = count - 1;
+    counter->cached_ns = 0;
+    counter->cached = 0;
+    return 0;
+}
+
+void fossil_sharded_counter_add(fossil_sharded_counter_t *counter, int64_t delta) {
+    fossil_counter_shard_t *shard = &counter->shards[counter_slot() & counter->mask];
+    __atomic_fetch_add(&shard->value, delta, __ATOMIC_RELAXED);
+}
+
+int64_t fossil_sharded_counter_read(fossil_sharded_counter_t *counter) {
+    int64_t total = 0;
+    for (uint32_t i = 0; i <= counter->mask; i++) {
+        total += __atomic_load_n(&counter->shards[i].value, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+int64_t fossil_sharded_counter_read_approx(fossil_sharded_counter_t *counter, uint64_t max_age_ns) {
+    uint64_t now = fossil_platform_now_ns();
+    uint64_t stamp = __atomic_load_n(&counter->cached_ns, __ATOMIC_ACQUIRE);
+    if (stamp && now - stamp <= max_age_ns) {
+        return __atomic_load_n(&counter->cached, __ATOMIC_RELAXED);
+    }
+
+    // Racing refreshes each store a valid recent sum; any of them will do.
+    int64_t total = fossil_sharded_counter_read(counter);
+    __atomic_store_n(&counter->cached, total, __ATOMIC_RELAXED);
+    __atomic_store_n(&counter->cached_ns, now, __ATOMIC_RELEASE);
+    return total;
+}
+
+int64_t fossil_sharded_counter_drain(fossil_sharded_counter_t *counter) {
+    int64_t total = 0;
+    for (uint32_t i = 0; i <= counter->mask; i++) {
+        total += __atomic_exchange_n(&counter->shards[i].value, 0, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+int32_t fossil_sharded_counter_destroy(fossil_sharded_counter_t *counter) {
+    if (!counter) return -1;
+    fossil_platform_aligned_free(counter->shards);
+    counter->shards = NULL;
+    return 0;
+}
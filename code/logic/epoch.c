@@ -0,0 +1,361 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/epoch.h"
+#include "fossil/threads/slab.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+/* -------- Epoch-Based Reclamation -------- */
+
+#define EPOCH_BUCKETS 3
+#define EPOCH_ACTIVE 1ull
+
+typedef struct epoch_node_t {
+    void *ptr;
+    fossil_reclaim_t reclaim;
+    struct epoch_node_t *next;
+} epoch_node_t;
+
+typedef struct {
+    uint64_t epoch;
+    epoch_node_t *head;
+} epoch_bucket_t;
+
+// One per registered thread. Records are never freed: a released record is
+// adopted, with whatever it still has to reclaim, by the next thread.
+typedef struct epoch_record_t {
+    // Written by the owner, read by every thread that advances or scans.
+    FOSSIL_CACHE_ALIGNED uint64_t state;
+    void *hazards[FOSSIL_HAZARD_SLOTS];
+
+    // Owner only.
+    FOSSIL_CACHE_ALIGNED struct epoch_record_t *next;
+    uint32_t in_use;
+    uint32_t nesting;
+    size_t retired;
+    size_t collect_at;
+    epoch_bucket_t limbo[EPOCH_BUCKETS];
+    epoch_node_t *hazard_list;
+    size_t hazard_count;
+} epoch_record_t;
+
+static FOSSIL_CACHE_ALIGNED uint64_t global_epoch = EPOCH_BUCKETS;
+static epoch_record_t *records = NULL;
+static uint32_t record_count = 0;
+
+static FOSSIL_THREAD_LOCAL epoch_record_t *current_record = NULL;
+
+static uint32_t exit_hook_state = 0;
+#ifdef _WIN32
+static DWORD exit_hook_key;
+#else
+static pthread_key_t exit_hook_key;
+#endif
+
+static void epoch_release(epoch_record_t *record);
+
+#ifdef _WIN32
+static VOID NTAPI epoch_exit_callback(PVOID value) {
+    if (value && current_record) epoch_release(current_record);
+}
+#else
+static void epoch_exit_callback(void *value) {
+    (void)value;
+    if (current_record) epoch_release(current_record);
+}
+#endif
+
+static void exit_hook_init(void) {
+#ifdef _WIN32
+    exit_hook_key = FlsAlloc(epoch_exit_callback);
+#else
+    pthread_key_create(&exit_hook_key, epoch_exit_callback);
+#endif
+}
+
+static void reclaim_list(epoch_node_t *node) {
+    while (node) {
+        epoch_node_t *next = node->next;
+        node->reclaim(node->ptr);
+        fossil_slab_free_size(node, sizeof(*node));
+        node = next;
+    }
+}
+
+static epoch_node_t *node_create(void *ptr, fossil_reclaim_t reclaim) {
+    epoch_node_t *node = (epoch_node_t *)fossil_slab_alloc_size(sizeof(epoch_node_t));
+    if (node) {
+        node->ptr = ptr;
+        node->reclaim = reclaim;
+        node->next = NULL;
+    }
+    return node;
+}
+
+static epoch_record_t *epoch_acquire(void) {
+    epoch_record_t *record = current_record;
+    if (record) return record;
+
+    for (record = __atomic_load_n(&records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        uint32_t expected = 0;
+        if (__atomic_load_n(&record->in_use, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&record->in_use, &expected, 1, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (!record) {
+        record = (epoch_record_t *)fossil_platform_aligned_alloc(FOSSIL_CACHE_LINE, sizeof(*record));
+        if (!record) return NULL;
+        memset(record, 0, sizeof(*record));
+        record->in_use = 1;
+
+        epoch_record_t *head = __atomic_load_n(&records, __ATOMIC_RELAXED);
+        do {
+            record->next = head;
+        } while (!__atomic_compare_exchange_n(&records, &head, record, 1,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+        __atomic_fetch_add(&record_count, 1, __ATOMIC_RELAXED);
+    }
+
+    fossil_platform_once(&exit_hook_state, exit_hook_init);
+#ifdef _WIN32
+    FlsSetValue(exit_hook_key, (PVOID)1);
+#else
+    pthread_setspecific(exit_hook_key, (void *)1);
+#endif
+    current_record = record;
+    return record;
+}
+
+// Advance the global epoch if every active thread has observed it.
+static void epoch_try_advance(uint64_t epoch) {
+    for (epoch_record_t *record = __atomic_load_n(&records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        uint64_t state = __atomic_load_n(&record->state, __ATOMIC_ACQUIRE);
+        if ((state & EPOCH_ACTIVE) && (state >> 1) != epoch) return;
+    }
+    __atomic_compare_exchange_n(&global_epoch, &epoch, epoch + 1, 0,
+                                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+// Objects retired in epoch e are unreachable once the global epoch is e + 2.
+static size_t epoch_collect(epoch_record_t *record) {
+    epoch_try_advance(__atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE));
+    uint64_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    size_t freed = 0;
+
+    for (uint32_t i = 0; i < EPOCH_BUCKETS; i++) {
+        epoch_bucket_t *bucket = &record->limbo[i];
+        if (bucket->head && bucket->epoch + 2 <= epoch) {
+            for (epoch_node_t *node = bucket->head; node; node = node->next) freed++;
+            reclaim_list(bucket->head);
+            bucket->head = NULL;
+        }
+    }
+    record->retired -= freed;
+    return freed;
+}
+
+static int hazard_compare(const void *a, const void *b) {
+    uintptr_t x = *(const uintptr_t *)a;
+    uintptr_t y = *(const uintptr_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Reclaim every hazard-retired object that no slot currently protects.
+// Records pushed after the snapshot belong to threads that started reading
+// after our objects were unlinked, so they cannot hold them.
+static size_t hazard_scan(epoch_record_t *record) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    epoch_record_t *head = __atomic_load_n(&records, __ATOMIC_ACQUIRE);
+
+    size_t capacity = 0;
+    for (epoch_record_t *it = head; it; it = it->next) capacity += FOSSIL_HAZARD_SLOTS;
+    uintptr_t *protected_ptrs = (uintptr_t *)malloc(capacity * sizeof(uintptr_t));
+    if (!protected_ptrs) return 0;
+
+    size_t count = 0;
+    for (epoch_record_t *it = head; it; it = it->next) {
+        for (uint32_t i = 0; i < FOSSIL_HAZARD_SLOTS; i++) {
+            void *hazard = __atomic_load_n(&it->hazards[i], __ATOMIC_SEQ_CST);
+            if (hazard) protected_ptrs[count++] = (uintptr_t)hazard;
+        }
+    }
+    qsort(protected_ptrs, count, sizeof(uintptr_t), hazard_compare);
+
+    size_t freed = 0;
+    epoch_node_t **link = &record->hazard_list;
+    while (*link) {
+        epoch_node_t *node = *link;
+        uintptr_t key = (uintptr_t)node->ptr;
+        if (count && bsearch(&key, protected_ptrs, count, sizeof(uintptr_t), hazard_compare)) {
+            link = &node->next;
+            continue;
+        }
+        *link = node->next;
+        node->next = NULL;
+        reclaim_list(node);
+        freed++;
+    }
+    record->hazard_count -= freed;
+    free(protected_ptrs);
+    return freed;
+}
+
+static void epoch_release(epoch_record_t *record) {
+    record->nesting = 0;
+    __atomic_store_n(&record->state, 0, __ATOMIC_RELEASE);
+    for (uint32_t i = 0; i < FOSSIL_HAZARD_SLOTS; i++) {
+        __atomic_store_n(&record->hazards[i], NULL, __ATOMIC_RELEASE);
+    }
+    if (record->retired) epoch_collect(record);
+    if (record->hazard_count) hazard_scan(record);
+
+    current_record = NULL;
+    __atomic_store_n(&record->in_use, 0, __ATOMIC_RELEASE);
+}
+
+int32_t fossil_epoch_register(void) {
+    return epoch_acquire() ? 0 : -1;
+}
+
+int32_t fossil_epoch_unregister(void) {
+    epoch_record_t *record = current_record;
+    if (!record) return 0;
+    if (record->nesting) return -1;
+    epoch_release(record);
+    return 0;
+}
+
+int32_t fossil_epoch_enter(void) {
+    epoch_record_t *record = epoch_acquire();
+    if (!record) return -1;
+    if (record->nesting++) return 0;
+
+    // The store must be visible before any shared pointer is read.
+    uint64_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_RELAXED);
+    __atomic_store_n(&record->state, (epoch << 1) | EPOCH_ACTIVE, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return 0;
+}
+
+void fossil_epoch_exit(void) {
+    epoch_record_t *record = current_record;
+    if (!record || record->nesting == 0) return;
+    if (--record->nesting) return;
+    __atomic_store_n(&record->state, 0, __ATOMIC_RELEASE);
+}
+
+int32_t fossil_epoch_retire(void *ptr, fossil_reclaim_t reclaim) {
+    if (!reclaim) return -1;
+    epoch_record_t *record = epoch_acquire();
+    if (!record) return -1;
+
+    epoch_node_t *node = node_create(ptr, reclaim);
+    if (!node) return -1;
+
+    // A bucket still tagged with an older epoch of the same residue is at
+    // least three epochs old, so it is safe to empty on the spot.
+    uint64_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+    epoch_bucket_t *bucket = &record->limbo[epoch % EPOCH_BUCKETS];
+    if (bucket->epoch != epoch) {
+        size_t freed = 0;
+        for (epoch_node_t *it = bucket->head; it; it = it->next) freed++;
+        reclaim_list(bucket->head);
+        record->retired -= freed;
+        bucket->head = NULL;
+        bucket->epoch = epoch;
+    }
+    node->next = bucket->head;
+    bucket->head = node;
+
+    // Collect every FOSSIL_EPOCH_BATCH retires, even while a stalled reader
+    // keeps the backlog from shrinking.
+    if (++record->retired >= record->collect_at) {
+        epoch_collect(record);
+        record->collect_at = record->retired + FOSSIL_EPOCH_BATCH;
+    }
+    return 0;
+}
+
+size_t fossil_epoch_reclaim(void) {
+    epoch_record_t *record = current_record;
+    if (!record) return 0;
+
+    size_t freed = 0;
+    if (record->retired) freed += epoch_collect(record);
+    if (record->hazard_count) freed += hazard_scan(record);
+    return freed;
+}
+
+int32_t fossil_epoch_barrier(void) {
+    epoch_record_t *record = epoch_acquire();
+    if (!record) return -1;
+    if (record->nesting) return -1;
+
+    uint64_t target = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE) + 2;
+    while (1) {
+        uint64_t epoch = __atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE);
+        if (epoch >= target) break;
+        epoch_try_advance(epoch);
+        if (__atomic_load_n(&global_epoch, __ATOMIC_ACQUIRE) == epoch) fossil_platform_yield();
+    }
+    epoch_collect(record);
+    return 0;
+}
+
+/* -------- Hazard Pointers -------- */
+
+void *fossil_hazard_protect(uint32_t slot, void **src) {
+    epoch_record_t *record = epoch_acquire();
+    if (!record || slot >= FOSSIL_HAZARD_SLOTS) return NULL;
+
+    void *ptr = __atomic_load_n(src, __ATOMIC_ACQUIRE);
+    while (1) {
+        __atomic_store_n(&record->hazards[slot], ptr, __ATOMIC_SEQ_CST);
+        void *again = __atomic_load_n(src, __ATOMIC_SEQ_CST);
+        if (again == ptr) return ptr;
+        ptr = again;
+    }
+}
+
+void fossil_hazard_clear(uint32_t slot) {
+    epoch_record_t *record = current_record;
+    if (!record || slot >= FOSSIL_HAZARD_SLOTS) return;
+    __atomic_store_n(&record->hazards[slot], NULL, __ATOMIC_RELEASE);
+}
+
+int32_t fossil_hazard_retire(void *ptr, fossil_reclaim_t reclaim) {
+    if (!reclaim) return -1;
+    epoch_record_t *record = epoch_acquire();
+    if (!record) return -1;
+
+    epoch_node_t *node = node_create(ptr, reclaim);
+    if (!node) return -1;
+    node->next = record->hazard_list;
+    record->hazard_list = node;
+
+    // Scan once the list outgrows twice the number of live hazards, so each
+    // scan frees at least half of what it looks at.
+    size_t threshold = (size_t)__atomic_load_n(&record_count, __ATOMIC_RELAXED) * FOSSIL_HAZARD_SLOTS * 2;
+    if (threshold < FOSSIL_EPOCH_BATCH) threshold = FOSSIL_EPOCH_BATCH;
+    if (++record->hazard_count >= threshold) hazard_scan(record);
+    return 0;
+}
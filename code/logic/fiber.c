@@ -12,28 +12,104 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/threads/fiber.h"
+#include "fossil/threads/epoch.h"
+#include "fossil/threads/slab.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <ucontext.h>
+
+#define FIBER_MIN_STACK 16384
+
+struct fossil_fiber_context_t {
+    ucontext_t context;
+    void (*task)(void *);
+    void *arg;
+    void *stack;
+    struct fossil_fiber_context_t *caller;
+    int32_t finished;
+};
+
+// The fiber running on this thread, and the implicit fiber of a thread that
+// switches without having been converted.
+static FOSSIL_THREAD_LOCAL fossil_fiber_t current_fiber = NULL;
+static FOSSIL_THREAD_LOCAL struct fossil_fiber_context_t thread_fiber;
+
+// Control blocks come from the slab size classes: fibers are created and
+// deleted far more often than their stacks change size.
+static fossil_fiber_t fiber_block_alloc(void) {
+    fossil_fiber_t fiber = (fossil_fiber_t)fossil_slab_alloc_size(sizeof(*fiber));
+    if (fiber) memset(fiber, 0, sizeof(*fiber));
+    return fiber;
+}
+
+static void fiber_block_free(fossil_fiber_t fiber) {
+    fossil_slab_free_size(fiber, sizeof(*fiber));
+}
+
+static void fiber_entry(void);
+
+// Point the context at a fresh stack that starts in fiber_entry. Kept apart
+// from fossil_fiber_create so that nothing live in that frame spans
+// getcontext, which may return twice.
+static int32_t fiber_prepare(fossil_fiber_t fiber, size_t stack_size) {
+    if (getcontext(&fiber->context) != 0) return -1;
+    fiber->context.uc_stack.ss_sp = fiber->stack;
+    fiber->context.uc_stack.ss_size = stack_size;
+    fiber->context.uc_link = NULL;
+    makecontext(&fiber->context, fiber_entry, 0);
+    return 0;
+}
+
+static void fiber_entry(void) {
+    fossil_fiber_t self = current_fiber;
+    fossil_epoch_register();
+    self->task(self->arg);
+    self->finished = 1;
+
+    fossil_fiber_t caller = self->caller;
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_FIBER_SWITCH, caller, (uintptr_t)self);
+    current_fiber = caller;
+    setcontext(&caller->context);
+}
+#endif
 
 fossil_fiber_t fossil_fiber_create(size_t stack_size, void (*task)(void *), void *arg) {
 #ifdef _WIN32
     return CreateFiber(stack_size, (LPFIBER_START_ROUTINE)task, arg);
 #else
-    ucontext_t *fiber = (ucontext_t *)malloc(sizeof(ucontext_t));
+    if (!task) return NULL;
+    if (stack_size < FIBER_MIN_STACK) stack_size = FIBER_MIN_STACK;
+
+    fossil_fiber_t fiber = fiber_block_alloc();
     if (!fiber) return NULL;
-    getcontext(fiber);
-    fiber->uc_stack.ss_sp = malloc(stack_size);
-    fiber->uc_stack.ss_size = stack_size;
-    makecontext(fiber, (void (*)(void))task, 1, arg);
+
+    fiber->task = task;
+    fiber->arg = arg;
+    fiber->stack = malloc(stack_size);
+    if (!fiber->stack || fiber_prepare(fiber, stack_size) != 0) {
+        free(fiber->stack);
+        fiber_block_free(fiber);
+        return NULL;
+    }
     return fiber;
 #endif
 }
 
 void fossil_fiber_switch(fossil_fiber_t fiber) {
 #ifdef _WIN32
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_FIBER_SWITCH, fiber, (uintptr_t)GetCurrentFiber());
     SwitchToFiber(fiber);
 #else
-    ucontext_t *current_context = (ucontext_t *)malloc(sizeof(ucontext_t));
-    getcontext(current_context);
-    swapcontext(current_context, (ucontext_t *)fiber);
+    fossil_fiber_t self = current_fiber ? current_fiber : &thread_fiber;
+    if (!fiber || fiber == self || fiber->finished) return;
+
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_FIBER_SWITCH, fiber, (uintptr_t)self);
+    fiber->caller = self;
+    current_fiber = fiber;
+    swapcontext(&self->context, &fiber->context);
 #endif
 }
 
@@ -41,9 +117,10 @@ void fossil_fiber_delete(fossil_fiber_t fiber) {
 #ifdef _WIN32
     DeleteFiber(fiber);
 #else
-    ucontext_t *f = (ucontext_t *)fiber;
-    free(f->uc_stack.ss_sp);
-    free(f);
+    if (!fiber || fiber == &thread_fiber) return;
+    if (current_fiber == fiber) current_fiber = NULL;
+    free(fiber->stack);
+    fiber_block_free(fiber);
 #endif
 }
 
@@ -51,6 +128,13 @@ fossil_fiber_t fossil_fiber_convert(void *arg) {
 #ifdef _WIN32
     return ConvertThreadToFiber(arg);
 #else
-    return NULL; // Not available in POSIX
+    if (current_fiber) return current_fiber;
+    fossil_epoch_register();
+
+    fossil_fiber_t fiber = fiber_block_alloc();
+    if (!fiber) return NULL;
+    fiber->arg = arg;
+    current_fiber = fiber;
+    return fiber;
 #endif
 }
@@ -0,0 +1,128 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_COMPLETION_H
+#define FOSSIL_THREADS_COMPLETION_H
+
+#include "pool.h"
+
+/* Result posted in place of the return value of a task submitted with
+ * fossil_thread_pool_submit_completion that the pool discarded unrun. */
+#define FOSSIL_COMPLETION_DISCARDED ((void *)(intptr_t)-1)
+
+/* Queued result, private to completion.c. */
+typedef struct fossil_completion_node_t fossil_completion_node_t;
+
+/* Hands results from any number of threads to one consumer, typically an
+ * event loop. The queue exposes a file descriptor (an eventfd on Linux, a
+ * pipe elsewhere) that is readable while results are pending. Posting only
+ * touches the descriptor when the queue goes from drained to non-empty, so
+ * a burst of completions costs the loop a single wakeup. */
+typedef struct fossil_completion_queue_t {
+    fossil_completion_node_t *head;         // Pushed by producers, newest first.
+    fossil_completion_node_t *backlog;      // Consumer only, oldest first.
+    fossil_completion_node_t *backlog_tail;
+    uint32_t signalled;
+    uint32_t waiters;
+    int fd;
+    int write_fd;
+} fossil_completion_queue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes an empty completion queue.
+ *
+ * @param queue Pointer to the completion queue.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_completion_create(fossil_completion_queue_t *queue);
+
+/**
+ * @brief Returns the descriptor to register with epoll, poll or select.
+ *
+ * It becomes readable when results are pending and stays readable until
+ * fossil_completion_drain has taken all of them. Only drain reads it.
+ *
+ * @param queue Pointer to the completion queue.
+ * @return int The descriptor, or -1 on platforms without one.
+ */
+int fossil_completion_fd(const fossil_completion_queue_t *queue);
+
+/**
+ * @brief Posts a result. Safe from any thread, including pool tasks.
+ *
+ * @param queue Pointer to the completion queue.
+ * @param result Value handed to the consumer; the queue does not own it.
+ * @return int32_t 0 if successful, -1 when out of memory.
+ */
+int32_t fossil_completion_post(fossil_completion_queue_t *queue, void *result);
+
+/**
+ * @brief Takes up to max pending results, oldest first per producer.
+ *
+ * Only one thread may drain a queue. If results remain afterwards the
+ * descriptor stays readable.
+ *
+ * @param queue Pointer to the completion queue.
+ * @param results Array receiving the results.
+ * @param max Capacity of results.
+ * @return size_t Number of results stored.
+ */
+size_t fossil_completion_drain(fossil_completion_queue_t *queue, void **results, size_t max);
+
+/**
+ * @brief Blocks until results are pending, for consumers without an event loop.
+ *
+ * Like the descriptor, it may occasionally report results that an earlier
+ * drain already took.
+ *
+ * @param queue Pointer to the completion queue.
+ * @param timeout_ns Maximum time to wait, or UINT64_MAX for no limit.
+ * @return int32_t 0 if the queue is signalled, -1 on timeout.
+ */
+int32_t fossil_completion_wait(fossil_completion_queue_t *queue, uint64_t timeout_ns);
+
+/**
+ * @brief Submits a task to a pool and posts its return value to queue.
+ *
+ * Room for the result is reserved here, so every accepted task posts exactly
+ * one result: its return value, or FOSSIL_COMPLETION_DISCARDED when the pool
+ * discards it unrun, as FOSSIL_THREAD_POOL_DROP_OLDEST does. Destroy the
+ * pool before the queue.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param queue Completion queue that receives the task's return value.
+ * @param task Pointer to the task function to be executed.
+ * @param arg Argument to pass to the task function.
+ * @return int32_t 0 if the task is successfully submitted, -1 otherwise.
+ */
+int32_t fossil_thread_pool_submit_completion(fossil_thread_pool_t *pool, fossil_completion_queue_t *queue,
+                                             fossil_task_t task, fossil_argumet_t arg);
+
+/**
+ * @brief Closes the descriptors and frees the queue. Results still pending
+ *        are dropped without being touched.
+ *
+ * @param queue Pointer to the completion queue.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_completion_destroy(fossil_completion_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_COMPLETION_H */
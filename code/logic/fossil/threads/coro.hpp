@@ -0,0 +1,514 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_CORO_HPP
+#define FOSSIL_THREADS_CORO_HPP
+
+/*
+ * C++20 coroutines over the thread pool.
+ *
+ *   fossil::task<int> work(fossil::thread_pool &pool) {
+ *       co_await pool.schedule();      // continue on a worker
+ *       co_return 42;
+ *   }
+ *
+ * task<T> is lazy: it starts when first awaited and resumes its awaiter by
+ * symmetric transfer when it finishes, so chains of co_await never grow the
+ * stack. Coroutine frames are allocated from the slab size classes, which
+ * recycle them through per-thread caches.
+ */
+
+#include "pool.hpp"
+#include "slab.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace fossil {
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+/* Routes coroutine frame allocation through the slab allocator. */
+struct frame_allocated {
+    static void *operator new(std::size_t size) {
+        void *frame = fossil_slab_alloc_size(size);
+        if (!frame) throw std::bad_alloc();
+        return frame;
+    }
+
+    static void operator delete(void *frame, std::size_t size) noexcept {
+        fossil_slab_free_size(frame, size);
+    }
+};
+
+struct final_awaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+        std::coroutine_handle<> next = handle.promise().continuation;
+        return next ? next : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct promise_base : frame_allocated {
+    std::coroutine_handle<> continuation;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter final_suspend() const noexcept { return {}; }
+};
+
+template <typename T>
+struct task_promise : promise_base {
+    std::variant<std::monostate, T, std::exception_ptr> result;
+
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U &&value) {
+        result.template emplace<1>(std::forward<U>(value));
+    }
+
+    void unhandled_exception() noexcept { result.template emplace<2>(std::current_exception()); }
+
+    T take() {
+        if (result.index() == 2) std::rethrow_exception(std::get<2>(result));
+        return std::move(std::get<1>(result));
+    }
+};
+
+template <>
+struct task_promise<void> : promise_base {
+    std::exception_ptr error;
+
+    task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+/* Fire-and-forget coroutine used to drive tasks from non-coroutine code. */
+struct detached {
+    struct promise_type : frame_allocated {
+        detached get_return_object() noexcept {
+            return detached{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    void start() { handle.resume(); }
+};
+
+/* Counts down arrivals; the awaiter counts as one so a group that finishes
+ * before anyone waits does not suspend at all. */
+class arrival_latch {
+public:
+    explicit arrival_latch(std::size_t count) noexcept : remaining_(count + 1) {}
+
+    void arrive() noexcept {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) continuation_.resume();
+    }
+
+    bool await_ready() const noexcept { return remaining_.load(std::memory_order_acquire) == 1; }
+
+    bool await_suspend(std::coroutine_handle<> handle) noexcept {
+        continuation_ = handle;
+        return remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    std::atomic<std::size_t> remaining_;
+    std::coroutine_handle<> continuation_;
+};
+
+} // namespace detail
+
+/* Lazily started, move-only coroutine producing a T. */
+template <typename T>
+class task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using value_type = T;
+
+    task() noexcept = default;
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+    task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    task &operator=(task &&other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    auto operator co_await() && noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().take(); }
+        };
+        return awaiter{handle_};
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T>
+inline task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+template <typename T>
+detached run_into(task<T> &child, std::optional<T> &out, std::exception_ptr &error, arrival_latch &latch) {
+    try {
+        out.emplace(co_await std::move(child));
+    } catch (...) {
+        error = std::current_exception();
+    }
+    latch.arrive();
+}
+
+inline detached run_into(task<void> &child, std::exception_ptr &error, arrival_latch &latch) {
+    try {
+        co_await std::move(child);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    latch.arrive();
+}
+
+template <typename T>
+struct when_any_state {
+    std::vector<task<T>> tasks;
+    std::atomic<bool> decided{false};
+    arrival_latch latch{1};
+    std::size_t index = 0;
+    std::conditional_t<std::is_void_v<T>, std::monostate, std::optional<T>> value;
+    std::exception_ptr error;
+};
+
+template <typename T>
+detached run_any(std::shared_ptr<when_any_state<T>> state, std::size_t index) {
+    std::exception_ptr error;
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(state->tasks[index]);
+            if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+                state->index = index;
+                state->latch.arrive();
+            }
+        } else {
+            T value = co_await std::move(state->tasks[index]);
+            if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+                state->index = index;
+                state->value.emplace(std::move(value));
+                state->latch.arrive();
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (error && !state->decided.exchange(true, std::memory_order_acq_rel)) {
+        state->index = index;
+        state->error = error;
+        state->latch.arrive();
+    }
+}
+
+} // namespace detail
+
+/**
+ * Runs every task concurrently and completes when all of them have. Each
+ * task runs on the thread that starts it until its first suspension, so
+ * tasks that should run in parallel begin with co_await pool.schedule().
+ * The first exception, in task order, is rethrown.
+ */
+template <typename T>
+task<std::vector<T>> when_all(std::vector<task<T>> tasks) {
+    detail::arrival_latch latch(tasks.size());
+    std::vector<std::optional<T>> results(tasks.size());
+    std::vector<std::exception_ptr> errors(tasks.size());
+
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        detail::run_into(tasks[i], results[i], errors[i], latch).start();
+    }
+    co_await latch;
+
+    std::vector<T> values;
+    values.reserve(results.size());
+    for (std::size_t i = 0; i < results.size(); i++) {
+        if (errors[i]) std::rethrow_exception(errors[i]);
+        values.push_back(std::move(*results[i]));
+    }
+    co_return values;
+}
+
+inline task<void> when_all(std::vector<task<void>> tasks) {
+    detail::arrival_latch latch(tasks.size());
+    std::vector<std::exception_ptr> errors(tasks.size());
+
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        detail::run_into(tasks[i], errors[i], latch).start();
+    }
+    co_await latch;
+
+    for (auto &error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+/* Heterogeneous form: co_await when_all(a(), b()) yields a tuple. */
+template <typename... Ts>
+task<std::tuple<Ts...>> when_all(task<Ts>... tasks) {
+    static_assert((!std::is_void_v<Ts> && ...), "use the vector form for task<void>");
+    detail::arrival_latch latch(sizeof...(Ts));
+    std::tuple<std::optional<Ts>...> results;
+    std::exception_ptr errors[sizeof...(Ts)];
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (detail::run_into(tasks, std::get<I>(results), errors[I], latch).start(), ...);
+    }(std::index_sequence_for<Ts...>{});
+    co_await latch;
+
+    for (auto &error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    co_return std::apply([](auto &...values) { return std::tuple<Ts...>(std::move(*values)...); }, results);
+}
+
+/**
+ * Completes as soon as the first task does, yielding its index (and value).
+ * The remaining tasks keep running to completion in the background, so they
+ * must not reference state that the caller destroys early.
+ */
+template <typename T>
+auto when_any(std::vector<task<T>> tasks)
+    -> task<std::conditional_t<std::is_void_v<T>, std::size_t, std::pair<std::size_t, T>>> {
+    auto state = std::make_shared<detail::when_any_state<T>>();
+    state->tasks = std::move(tasks);
+
+    for (std::size_t i = 0; i < state->tasks.size(); i++) {
+        detail::run_any<T>(state, i).start();
+    }
+    co_await state->latch;
+
+    if (state->error) std::rethrow_exception(state->error);
+    if constexpr (std::is_void_v<T>) {
+        co_return state->index;
+    } else {
+        co_return std::pair<std::size_t, T>(state->index, std::move(*state->value));
+    }
+}
+
+/* Blocks the calling thread until the task finishes and returns its result. */
+template <typename T>
+T sync_wait(task<T> work) {
+    semaphore done;
+    std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> value;
+    std::exception_ptr error;
+
+    [](task<T> &child, auto &out, std::exception_ptr &err, semaphore &signal) -> detail::detached {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(child);
+                out.emplace();
+            } else {
+                out.emplace(co_await std::move(child));
+            }
+        } catch (...) {
+            err = std::current_exception();
+        }
+        signal.release();
+    }(work, value, error, done).start();
+
+    done.acquire();
+    if (error) std::rethrow_exception(error);
+    if constexpr (!std::is_void_v<T>) return std::move(*value);
+}
+
+/* Waiters queued on an async primitive, resumed in FIFO order. */
+namespace detail {
+
+struct async_waiter {
+    std::coroutine_handle<> handle;
+    async_waiter *next = nullptr;
+};
+
+} // namespace detail
+
+/**
+ * Counting semaphore that suspends instead of blocking. release() hands the
+ * permit directly to the oldest waiter and resumes it on the releasing thread.
+ */
+class async_semaphore {
+public:
+    explicit async_semaphore(std::size_t initial = 0) : count_(initial) {}
+
+    async_semaphore(const async_semaphore &) = delete;
+    async_semaphore &operator=(const async_semaphore &) = delete;
+
+    auto acquire() noexcept {
+        struct awaiter : detail::async_waiter {
+            async_semaphore &sem;
+
+            explicit awaiter(async_semaphore &s) noexcept : sem(s) {}
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) {
+                lock_guard guard(sem.guard_);
+                if (sem.count_ > 0) {
+                    sem.count_--;
+                    return false;
+                }
+                handle = awaiting;
+                sem.enqueue(this);
+                return true;
+            }
+
+            void await_resume() const noexcept {}
+        };
+        return awaiter(*this);
+    }
+
+    void release() {
+        detail::async_waiter *waiter;
+        {
+            lock_guard guard(guard_);
+            waiter = dequeue();
+            if (!waiter) {
+                count_++;
+                return;
+            }
+        }
+        waiter->handle.resume();
+    }
+
+private:
+    friend class async_mutex;
+
+    void enqueue(detail::async_waiter *waiter) noexcept {
+        if (tail_) {
+            tail_->next = waiter;
+        } else {
+            head_ = waiter;
+        }
+        tail_ = waiter;
+    }
+
+    detail::async_waiter *dequeue() noexcept {
+        detail::async_waiter *waiter = head_;
+        if (waiter) {
+            head_ = waiter->next;
+            if (!head_) tail_ = nullptr;
+        }
+        return waiter;
+    }
+
+    mutex guard_;
+    std::size_t count_;
+    detail::async_waiter *head_ = nullptr;
+    detail::async_waiter *tail_ = nullptr;
+};
+
+/**
+ * Mutex for coroutines: co_await lock() suspends while another coroutine
+ * holds it. unlock() hands ownership straight to the oldest waiter.
+ */
+class async_mutex {
+public:
+    class scoped_lock {
+    public:
+        explicit scoped_lock(async_mutex &owner) noexcept : owner_(&owner) {}
+        scoped_lock(scoped_lock &&other) noexcept : owner_(std::exchange(other.owner_, nullptr)) {}
+        scoped_lock(const scoped_lock &) = delete;
+        scoped_lock &operator=(const scoped_lock &) = delete;
+        scoped_lock &operator=(scoped_lock &&) = delete;
+
+        ~scoped_lock() {
+            if (owner_) owner_->unlock();
+        }
+
+    private:
+        async_mutex *owner_;
+    };
+
+    async_mutex() : sem_(1) {}
+
+    auto lock() noexcept { return sem_.acquire(); }
+
+    /* co_await m.lock_scoped() yields a guard that unlocks on destruction. */
+    task<scoped_lock> lock_scoped() {
+        co_await sem_.acquire();
+        co_return scoped_lock(*this);
+    }
+
+    void unlock() { sem_.release(); }
+
+private:
+    async_semaphore sem_;
+};
+
+} // namespace fossil
+
+#endif /* FOSSIL_THREADS_CORO_HPP */
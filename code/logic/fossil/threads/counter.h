@@ -0,0 +1,99 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_COUNTER_H
+#define FOSSIL_THREADS_COUNTER_H
+
+#include <stdint.h>
+
+/* One cache line of a sharded counter, private to counter.c. */
+typedef struct fossil_counter_shard_t fossil_counter_shard_t;
+
+/* Counter split across cache-line-sized shards. Each CPU (or, where the
+ * CPU cannot be read cheaply, each thread) adds to its own shard, so
+ * concurrent increments do not bounce a shared line. Reading sums the
+ * shards; fossil_sharded_counter_read_approx serves a cached sum instead. */
+typedef struct {
+    fossil_counter_shard_t *shards;
+    uint32_t mask;
+    uint64_t cached_ns;
+    int64_t cached;
+} fossil_sharded_counter_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes a counter at zero.
+ *
+ * @param counter Pointer to the counter.
+ * @param shards Number of shards, rounded up to a power of two; 0 picks one
+ *        per CPU.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_sharded_counter_create(fossil_sharded_counter_t *counter, uint32_t shards);
+
+/**
+ * @brief Adds to the caller's shard.
+ *
+ * @param counter Pointer to the counter.
+ * @param delta Amount to add; may be negative.
+ */
+void fossil_sharded_counter_add(fossil_sharded_counter_t *counter, int64_t delta);
+
+/**
+ * @brief Sums all shards.
+ *
+ * Exact when no thread is adding; otherwise it includes any subset of the
+ * concurrent additions.
+ *
+ * @param counter Pointer to the counter.
+ * @return int64_t Current total.
+ */
+int64_t fossil_sharded_counter_read(fossil_sharded_counter_t *counter);
+
+/**
+ * @brief Returns a total no older than max_age_ns, summing the shards only
+ *        when the cached one has expired.
+ *
+ * @param counter Pointer to the counter.
+ * @param max_age_ns Maximum age of the cached total in nanoseconds.
+ * @return int64_t Total at some point in the last max_age_ns.
+ */
+int64_t fossil_sharded_counter_read_approx(fossil_sharded_counter_t *counter, uint64_t max_age_ns);
+
+/**
+ * @brief Drains every shard to zero and returns what they held.
+ *
+ * Each addition is counted by exactly one call, so repeated drains add up
+ * to the exact total even while other threads keep adding.
+ *
+ * @param counter Pointer to the counter.
+ * @return int64_t Sum of the drained shards.
+ */
+int64_t fossil_sharded_counter_drain(fossil_sharded_counter_t *counter);
+
+/**
+ * @brief Frees the counter's shards.
+ *
+ * @param counter Pointer to the counter.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_sharded_counter_destroy(fossil_sharded_counter_t *counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_COUNTER_H */
@@ -0,0 +1,132 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_EPOCH_H
+#define FOSSIL_THREADS_EPOCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Hazard pointer slots available to each thread. */
+#define FOSSIL_HAZARD_SLOTS 4
+
+/* Retired objects a thread accumulates before it tries to reclaim. */
+#define FOSSIL_EPOCH_BATCH 64
+
+/* Called once an object retired with fossil_epoch_retire or
+ * fossil_hazard_retire can no longer be reached by any reader. */
+typedef void (*fossil_reclaim_t)(void *ptr);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Registers the calling thread with the reclamation subsystem.
+ *
+ * Registration happens automatically on first use, and pool workers and
+ * fibers register themselves; calling this up front only moves the cost
+ * out of the first critical section. Calling it again is a no-op.
+ *
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_epoch_register(void);
+
+/**
+ * @brief Releases the calling thread's registration.
+ *
+ * Objects the thread retired but could not yet reclaim are handed to the
+ * next thread that registers. Threads unregister automatically on exit.
+ *
+ * @return int32_t 0 if successful, -1 inside a critical section.
+ */
+int32_t fossil_epoch_unregister(void);
+
+/**
+ * @brief Enters a read-side critical section.
+ *
+ * Objects reachable when the section starts stay valid until it ends.
+ * Sections nest and are tracked per thread, so a fiber that switches away
+ * inside one keeps its thread pinned until it exits.
+ *
+ * @return int32_t 0 if successful, -1 if the thread could not register.
+ */
+int32_t fossil_epoch_enter(void);
+
+/**
+ * @brief Leaves the innermost read-side critical section.
+ */
+void fossil_epoch_exit(void);
+
+/**
+ * @brief Defers freeing an object until no critical section can see it.
+ *
+ * The object must already be unlinked from every shared structure. The
+ * calling thread reclaims in batches of FOSSIL_EPOCH_BATCH.
+ *
+ * @param ptr Object to free.
+ * @param reclaim Function that frees it.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_epoch_retire(void *ptr, fossil_reclaim_t reclaim);
+
+/**
+ * @brief Reclaims whatever the calling thread has retired that is now safe.
+ *
+ * @return size_t Number of objects reclaimed.
+ */
+size_t fossil_epoch_reclaim(void);
+
+/**
+ * @brief Waits until everything the calling thread retired is reclaimed.
+ *
+ * Blocks until every thread has left the critical sections that were
+ * running when the call started.
+ *
+ * @return int32_t 0 if successful, -1 inside a critical section.
+ */
+int32_t fossil_epoch_barrier(void);
+
+/**
+ * @brief Publishes a hazard pointer to the object stored at *src.
+ *
+ * Hazard pointers protect single objects without a critical section, which
+ * bounds the memory a stalled reader can pin.
+ *
+ * @param slot Hazard slot, less than FOSSIL_HAZARD_SLOTS.
+ * @param src Shared location to read the pointer from.
+ * @return void* The protected pointer, valid until the slot is cleared.
+ */
+void *fossil_hazard_protect(uint32_t slot, void **src);
+
+/**
+ * @brief Clears a hazard slot.
+ *
+ * @param slot Hazard slot, less than FOSSIL_HAZARD_SLOTS.
+ */
+void fossil_hazard_clear(uint32_t slot);
+
+/**
+ * @brief Defers freeing an object until no hazard pointer refers to it.
+ *
+ * @param ptr Object to free, already unlinked.
+ * @param reclaim Function that frees it.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_hazard_retire(void *ptr, fossil_reclaim_t reclaim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_EPOCH_H */
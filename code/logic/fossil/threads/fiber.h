@@ -20,15 +20,10 @@
 #include <windows.h>
 typedef LPVOID fossil_fiber_t;
 #else
-#include <pthread.h>
-#include <stdlib.h>
+#include <stddef.h>
 
-// Define a custom fiber structure
-typedef struct {
-    pthread_t thread;
-    void *(*task)(void *);
-    void *arg;
-} fossil_fiber_t;
+/* Fiber control block, private to fiber.c. */
+typedef struct fossil_fiber_context_t *fossil_fiber_t;
 #endif
 
 #ifdef __cplusplus
@@ -38,6 +33,9 @@ extern "C" {
 /**
  * @brief Creates a new fiber and returns its identifier.
  *
+ * When the task returns, control goes back to the fiber that last switched
+ * into it; a finished fiber is never resumed again.
+ *
  * @param stack_size Size of the fiber's stack in bytes.
  * @param task Pointer to the task function for the fiber.
  * @param arg Argument to pass to the task function.
@@ -14,9 +14,18 @@
 #ifndef FOSSIL_THREADS_FRAMEWORK_H
 #define FOSSIL_THREADS_FRAMEWORK_H
 
+#include "completion.h"
+#include "counter.h"
+#include "epoch.h"
 #include "fiber.h"
+#include "graph.h"
+#include "map.h"
+#include "pipeline.h"
 #include "pool.h"
+#include "rcu.h"
+#include "slab.h"
 #include "sync.h"
 #include "threads.h"
+#include "trace.h"
 
 #endif /* FOSSIL_THREADS_FRAMEWORK_H */
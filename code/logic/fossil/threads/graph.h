@@ -0,0 +1,110 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_GRAPH_H
+#define FOSSIL_THREADS_GRAPH_H
+
+#include "pool.h"
+
+/* Graph node, private to graph.c. */
+typedef struct fossil_task_graph_node_t fossil_task_graph_node_t;
+
+/* Dependency graph of tasks run on a thread pool. Each node starts once
+ * all of its dependencies have finished; the worker that completes the last
+ * dependency continues with the node itself or queues it locally, so chains
+ * of work stay on one core unless another worker steals them. A graph is
+ * built once and may be run any number of times without allocating. */
+typedef struct fossil_task_graph_t {
+    fossil_thread_pool_t *pool;
+    fossil_task_graph_node_t *nodes;
+    uint32_t num_nodes;
+    uint32_t capacity;
+    uint32_t remaining;
+    uint32_t running;
+    uint32_t finished;
+    uint32_t validated;
+    fossil_eventcount_t done;
+} fossil_task_graph_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes an empty task graph.
+ *
+ * @param graph Pointer to the task graph.
+ * @param pool Pool the nodes run on; must outlive every run of the graph.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_task_graph_create(fossil_task_graph_t *graph, fossil_thread_pool_t *pool);
+
+/**
+ * @brief Adds a node to the graph. Not allowed while the graph runs.
+ *
+ * @param graph Pointer to the task graph.
+ * @param task Function the node runs.
+ * @param arg Argument passed to the task, on every run.
+ * @return int32_t Index of the new node, or -1 on failure.
+ */
+int32_t fossil_task_graph_add(fossil_task_graph_t *graph, fossil_task_t task, fossil_argumet_t arg);
+
+/**
+ * @brief Makes a node wait for another node to finish.
+ *
+ * @param graph Pointer to the task graph.
+ * @param node Index of the dependent node.
+ * @param dependency Index of the node that must finish first.
+ * @return int32_t 0 if successful, -1 on an invalid index, a self
+ *         dependency, while the graph runs, or when out of memory.
+ */
+int32_t fossil_task_graph_depend(fossil_task_graph_t *graph, int32_t node, int32_t dependency);
+
+/**
+ * @brief Starts a run of the graph without waiting for it.
+ *
+ * @param graph Pointer to the task graph.
+ * @return int32_t 0 if started, -1 if the graph is already running or its
+ *         dependencies form a cycle.
+ */
+int32_t fossil_task_graph_start(fossil_task_graph_t *graph);
+
+/**
+ * @brief Waits for the current run to finish. Returns at once if none.
+ *
+ * @param graph Pointer to the task graph.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_task_graph_wait(fossil_task_graph_t *graph);
+
+/**
+ * @brief Runs the graph and waits for every node to finish.
+ *
+ * @param graph Pointer to the task graph.
+ * @return int32_t 0 if successful, -1 if the graph could not be started.
+ */
+int32_t fossil_task_graph_run(fossil_task_graph_t *graph);
+
+/**
+ * @brief Frees the graph. It must not be running.
+ *
+ * @param graph Pointer to the task graph.
+ * @return int32_t 0 if successful, -1 if the graph is running.
+ */
+int32_t fossil_task_graph_destroy(fossil_task_graph_t *graph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_GRAPH_H */
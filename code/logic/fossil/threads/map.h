@@ -0,0 +1,109 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_MAP_H
+#define FOSSIL_THREADS_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bucket table, private to map.c. */
+typedef struct fossil_map_table_t fossil_map_table_t;
+
+/* Hash map from 64-bit keys to pointers. Lookups take no locks; writers
+ * lock only the buckets they touch, and growing the table is spread across
+ * the writers that run while it is in progress. Removed entries are freed
+ * through epoch reclamation, so callers may hold a critical section
+ * (fossil_epoch_enter) across a batch of lookups to amortize its cost. */
+typedef struct fossil_concurrent_map_t {
+    fossil_map_table_t *table;
+    char padding[64 - sizeof(fossil_map_table_t *)]; // Keep count off the readers' line.
+    int64_t count;
+} fossil_concurrent_map_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes an empty map.
+ *
+ * @param map Pointer to the map.
+ * @param capacity Expected number of entries; 0 picks a small default.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_concurrent_map_create(fossil_concurrent_map_t *map, size_t capacity);
+
+/**
+ * @brief Looks up a key without taking any lock.
+ *
+ * @param map Pointer to the map.
+ * @param key Key to look up.
+ * @param value Pointer to receive the value; may be NULL.
+ * @return int32_t 0 if the key is present, -1 otherwise.
+ */
+int32_t fossil_concurrent_map_get(fossil_concurrent_map_t *map, uint64_t key, void **value);
+
+/**
+ * @brief Inserts a key that is not yet present.
+ *
+ * @param map Pointer to the map.
+ * @param key Key to insert.
+ * @param value Value to associate with the key.
+ * @return int32_t 0 if inserted, -1 if the key exists or out of memory.
+ */
+int32_t fossil_concurrent_map_insert(fossil_concurrent_map_t *map, uint64_t key, void *value);
+
+/**
+ * @brief Inserts a key or replaces its value.
+ *
+ * @param map Pointer to the map.
+ * @param key Key to insert or update.
+ * @param value New value.
+ * @param old_value Pointer to receive the replaced value (NULL if the key
+ *        was new); may be NULL.
+ * @return int32_t 0 if successful, -1 when out of memory.
+ */
+int32_t fossil_concurrent_map_put(fossil_concurrent_map_t *map, uint64_t key, void *value, void **old_value);
+
+/**
+ * @brief Removes a key.
+ *
+ * @param map Pointer to the map.
+ * @param key Key to remove.
+ * @param old_value Pointer to receive the removed value; may be NULL.
+ * @return int32_t 0 if the key was removed, -1 if it was not present.
+ */
+int32_t fossil_concurrent_map_erase(fossil_concurrent_map_t *map, uint64_t key, void **old_value);
+
+/**
+ * @brief Returns the number of entries. Approximate while writers run.
+ *
+ * @param map Pointer to the map.
+ * @return size_t Number of entries.
+ */
+size_t fossil_concurrent_map_size(fossil_concurrent_map_t *map);
+
+/**
+ * @brief Frees the map. No other thread may use it concurrently.
+ *
+ * @param map Pointer to the map.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_concurrent_map_destroy(fossil_concurrent_map_t *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_MAP_H */
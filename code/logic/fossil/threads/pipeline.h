@@ -0,0 +1,112 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_PIPELINE_H
+#define FOSSIL_THREADS_PIPELINE_H
+
+#include "pool.h"
+
+/* How a stage may run relative to itself. */
+typedef enum {
+    FOSSIL_PIPELINE_SERIAL_IN_ORDER,     // One item at a time, in input order.
+    FOSSIL_PIPELINE_SERIAL_OUT_OF_ORDER, // One item at a time, in any order.
+    FOSSIL_PIPELINE_PARALLEL             // Any number of items at once.
+} fossil_pipeline_mode_t;
+
+/* A stage receives the item produced by the previous stage and returns the
+ * item for the next one, usually the same buffer. The first stage receives
+ * NULL and returns NULL at the end of the stream; a later stage returns NULL
+ * to drop the item. */
+typedef void *(*fossil_pipeline_stage_t)(void *item, void *context);
+
+/* Stage and token state, private to pipeline.c. */
+typedef struct fossil_pipeline_filter_t fossil_pipeline_filter_t;
+typedef struct fossil_pipeline_token_t fossil_pipeline_token_t;
+
+/* Streams items through a sequence of stages on a thread pool. At most
+ * max_tokens items are between the first and the last stage at any time,
+ * which bounds both memory and the working set; stages overlap so that
+ * throughput follows the slowest serial stage. Items are passed between
+ * stages by pointer and never copied. */
+typedef struct fossil_pipeline_t {
+    fossil_thread_pool_t *pool;
+    fossil_pipeline_filter_t **stages;
+    fossil_pipeline_token_t *tokens;
+    fossil_pipeline_token_t *free_tokens;
+    uint32_t num_stages;
+    uint32_t stage_capacity;
+    uint32_t max_tokens;
+    uint32_t in_flight;
+    uint64_t next_seq;
+    int32_t input_busy;
+    int32_t input_done;
+    int32_t running;
+    int32_t completed;
+    int32_t finished;
+    fossil_mutex_t mutex;
+    fossil_eventcount_t done;
+} fossil_pipeline_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes an empty pipeline.
+ *
+ * @param pipeline Pointer to the pipeline.
+ * @param pool Pool the stages run on.
+ * @param max_tokens Maximum number of items in flight; 0 picks twice the
+ *        number of pool threads.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_pipeline_create(fossil_pipeline_t *pipeline, fossil_thread_pool_t *pool, uint32_t max_tokens);
+
+/**
+ * @brief Appends a stage. The first stage is the input and always runs
+ *        serially, whatever its mode.
+ *
+ * @param pipeline Pointer to the pipeline.
+ * @param mode How the stage may run relative to itself.
+ * @param stage Function applied to each item.
+ * @param context Passed unchanged to every call of the stage.
+ * @return int32_t 0 if successful, -1 while running or when out of memory.
+ */
+int32_t fossil_pipeline_add_stage(fossil_pipeline_t *pipeline, fossil_pipeline_mode_t mode,
+                                  fossil_pipeline_stage_t stage, void *context);
+
+/**
+ * @brief Runs the pipeline until the input stage ends the stream and every
+ *        item has left the last stage. May be called again afterwards.
+ *
+ * Must not be called from a task of the same pool: the caller blocks.
+ *
+ * @param pipeline Pointer to the pipeline.
+ * @return int32_t 0 if successful, -1 if there are no stages or the
+ *         pipeline is already running.
+ */
+int32_t fossil_pipeline_run(fossil_pipeline_t *pipeline);
+
+/**
+ * @brief Frees the pipeline. It must not be running.
+ *
+ * @param pipeline Pointer to the pipeline.
+ * @return int32_t 0 if successful, -1 if the pipeline is running.
+ */
+int32_t fossil_pipeline_destroy(fossil_pipeline_t *pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_PIPELINE_H */
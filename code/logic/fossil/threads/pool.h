@@ -16,25 +16,138 @@
 
 #include "threads.h"
 #include "sync.h"
+#include "slab.h"
+
+/* Bytes of callable state a task node can hold inline. */
+#define FOSSIL_THREAD_POOL_INLINE_SIZE 48
+
+/* Runs (run != 0) and then destroys, or only destroys (run == 0), a task
+ * whose state is stored inline in its queue node. */
+typedef void (*fossil_inline_task_t)(void *storage, int32_t run);
+
+/* Cooperative cancellation flag shared by any number of tasks. Tasks poll
+ * it; queued tasks carrying a cancelled token are discarded unrun. */
+typedef struct fossil_cancel_token_t {
+    uint32_t cancelled;
+} fossil_cancel_token_t;
+
+/* What a submitter from outside the pool does when the queue is full. */
+typedef enum {
+    FOSSIL_THREAD_POOL_BLOCK,       // Wait until a worker takes a task.
+    FOSSIL_THREAD_POOL_FAIL,        // Return -1 at once.
+    FOSSIL_THREAD_POOL_CALLER_RUNS, // Run the task on the submitting thread.
+    FOSSIL_THREAD_POOL_DROP_OLDEST  // Discard the oldest queued task unrun.
+} fossil_thread_pool_policy_t;
 
 typedef struct task_queue_t {
     void *(*task_func)(void *);
     void *arg;
+    fossil_inline_task_t invoke;
+    fossil_cancel_token_t *cancel;
+    uint32_t pinned; // Keyed task that must stay on its worker.
+    uint32_t owned;  // Library task that DROP_OLDEST must not discard.
+    uint64_t submit_ns;
     struct task_queue_t *next;
+    union {
+        max_align_t align;
+        unsigned char bytes[FOSSIL_THREAD_POOL_INLINE_SIZE];
+    } storage;
 } task_queue_t;
 
+/* Default idle strategy: poll this many times, then yield, then park.
+ * Spinning is skipped by default on single-CPU machines. */
+#define FOSSIL_THREAD_POOL_SPIN_COUNT  128
+#define FOSSIL_THREAD_POOL_YIELD_COUNT 4
+
+/* Log2 histogram buckets: bucket i counts samples in [2^(i-1), 2^i) ns, the
+ * last bucket also absorbs everything above. */
+#define FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS 32
+
+/* Counters kept by each worker on its own cache line. */
+typedef struct {
+    uint64_t submitted;
+    uint64_t executed;
+    uint64_t stolen;
+    uint64_t idle_ns;
+    uint64_t busy_ns;
+} fossil_thread_pool_worker_stats_t;
+
+/* Point-in-time snapshot aggregated over all workers. */
+typedef struct {
+    uint32_t num_workers;
+    uint32_t idle_workers;
+    uint32_t queue_depth;
+    uint64_t external_submitted;
+    uint64_t rejected;  // Found the queue full and were not queued.
+    uint64_t dropped;   // Discarded by FOSSIL_THREAD_POOL_DROP_OLDEST.
+    uint64_t cancelled; // Discarded because their token was cancelled.
+    uint32_t spare_workers;   // Spare workers started so far.
+    uint32_t blocked_workers; // Workers currently inside a blocking region.
+    uint64_t long_running;    // Tasks flagged by the watchdog.
+    fossil_thread_pool_worker_stats_t total;
+    uint64_t wait_histogram[FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS];
+    uint64_t exec_histogram[FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS];
+} fossil_thread_pool_stats_t;
+
+/* Per-worker state, private to pool.c. */
+typedef struct fossil_thread_pool_worker_t fossil_thread_pool_worker_t;
+
+struct fossil_thread_pool_t;
+
+/* Called from the watchdog thread once per task that has been running on
+ * worker for running_ns, at least the configured threshold. */
+typedef void (*fossil_thread_pool_watchdog_t)(struct fossil_thread_pool_t *pool, uint32_t worker,
+                                              uint64_t running_ns, void *context);
+
 /* Task-based Concurrency (Thread Pool) */
 typedef struct fossil_thread_pool_t {
     fossil_thread_t *threads;
+    fossil_thread_pool_worker_t *workers;
     uint32_t num_threads;
     fossil_mutex_t mutex;
-    fossil_cond_t cond;
+    fossil_cond_t not_full;
     fossil_semaphore_t semaphore;
     task_queue_t *head;
     task_queue_t *tail;
+    fossil_slab_t task_slab;
+    uint32_t pending;
+    uint32_t queued;
+    uint32_t capacity;
+    fossil_thread_pool_policy_t policy;
+    uint32_t blocked;
+    uint32_t num_idle;
+    uint32_t spin_count;
+    uint32_t yield_count;
+    uint32_t stats_enabled;
+    uint32_t affinity_steal;
+    uint32_t spare_capacity;  // Spare worker slots, allocated after the workers.
+    uint32_t max_spares;
+    uint32_t num_spares;      // Spare workers started so far.
+    uint32_t blocked_workers; // Workers inside a blocking region.
+    uint32_t spawning;
+    int32_t spare_exit;
+    uint64_t watchdog_ns;
+    fossil_thread_pool_watchdog_t watchdog;
+    void *watchdog_context;
+    fossil_thread_t watchdog_thread;
+    uint32_t watchdog_running;
+    uint32_t watchdog_stop;
+    uint64_t long_running;
+    uint64_t external_submitted;
+    uint64_t rejected;
+    uint64_t dropped;
+    uint64_t cancelled;
     int32_t shutdown;
 } fossil_thread_pool_t;
 
+/* One cache-line-aligned slot per worker, for shard-per-worker data. */
+typedef struct {
+    fossil_thread_pool_t *pool;
+    unsigned char *slots;
+    size_t stride;
+    uint32_t count;
+} fossil_thread_pool_local_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,6 +161,21 @@ extern "C" {
  */
 int32_t fossil_thread_pool_create(fossil_thread_pool_t *pool, uint32_t num_threads);
 
+/**
+ * @brief Returns the process-wide shared thread pool.
+ *
+ * The pool is set up on first call with one worker per available CPU, but
+ * starts no thread until work is submitted, and then only starts another
+ * worker when none is idle. Components that submit here share one set of
+ * workers instead of each creating a pool. It is destroyed at exit, after
+ * the tasks already submitted have run; callers must not destroy it. A
+ * submit fails if the pool has no worker yet and cannot start one.
+ *
+ * @return fossil_thread_pool_t* The shared pool, or NULL if it could not be
+ *         set up or has already been destroyed at exit.
+ */
+fossil_thread_pool_t *fossil_thread_pool_default(void);
+
 /**
  * @brief Submits a task to the thread pool.
  *
@@ -58,9 +186,329 @@ int32_t fossil_thread_pool_create(fossil_thread_pool_t *pool, uint32_t num_threa
  */
 int32_t fossil_thread_pool_submit(fossil_thread_pool_t *pool, fossil_task_t task, fossil_argumet_t arg);
 
+/**
+ * @brief Submits a task that is skipped if token is cancelled before it runs.
+ *
+ * While the task runs, fossil_thread_pool_cancel_requested reports the
+ * state of token, so long tasks can also stop early.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param task Pointer to the task function to be executed.
+ * @param arg Argument to pass to the task function.
+ * @param token Cancellation token; may be shared by many tasks.
+ * @return int32_t 0 if the task is successfully submitted, -1 otherwise.
+ */
+int32_t fossil_thread_pool_submit_cancellable(fossil_thread_pool_t *pool, fossil_task_t task,
+                                              fossil_argumet_t arg, fossil_cancel_token_t *token);
+
+/**
+ * @brief Submits a task to the worker that owns key.
+ *
+ * Tasks with the same key go to the same worker's FIFO, so they reuse its
+ * caches. They may be stolen by another worker only when that FIFO holds
+ * more than the threshold set with fossil_thread_pool_set_affinity_steal.
+ * Keyed tasks do not count against the pool's capacity.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param key Affinity key, e.g. a connection or shard id.
+ * @param task Pointer to the task function to be executed.
+ * @param arg Argument to pass to the task function.
+ * @return int32_t 0 if the task is successfully submitted, -1 otherwise.
+ */
+int32_t fossil_thread_pool_submit_keyed(fossil_thread_pool_t *pool, uint64_t key, fossil_task_t task, fossil_argumet_t arg);
+
+/**
+ * @brief Submits a keyed task that runs after every earlier task for key.
+ *
+ * Like fossil_thread_pool_submit_keyed, but the task is never stolen: tasks
+ * submitted this way for one key run one at a time in submission order,
+ * without any lock in the tasks themselves.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param key Affinity key, e.g. a connection or shard id.
+ * @param task Pointer to the task function to be executed.
+ * @param arg Argument to pass to the task function.
+ * @return int32_t 0 if the task is successfully submitted, -1 otherwise.
+ */
+int32_t fossil_thread_pool_submit_serial(fossil_thread_pool_t *pool, uint64_t key, fossil_task_t task, fossil_argumet_t arg);
+
+/**
+ * @brief Lets idle workers steal keyed tasks from an overloaded worker.
+ *
+ * A worker's keyed FIFO is stolen from only while it holds more than
+ * threshold tasks. Serial tasks are never stolen. 0, the default, keeps
+ * keyed tasks on their worker.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param threshold FIFO length above which stealing is allowed.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_set_affinity_steal(fossil_thread_pool_t *pool, uint32_t threshold);
+
+/**
+ * @brief Submits a task whose state is copied into the queue node.
+ *
+ * Avoids a separate allocation for the task's argument. The state is copied
+ * with memcpy, so it must be trivially copyable; invoke receives the copy.
+ * If the task is rejected, data still belongs to the caller.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param invoke Function that runs and/or destroys the stored state.
+ * @param data State to copy.
+ * @param size Size of the state, at most FOSSIL_THREAD_POOL_INLINE_SIZE.
+ * @return int32_t 0 if the task is successfully submitted, -1 otherwise.
+ */
+int32_t fossil_thread_pool_submit_inline(fossil_thread_pool_t *pool, fossil_inline_task_t invoke, const void *data, size_t size);
+
+/**
+ * @brief Submits a task whose state is constructed in place in the queue node.
+ *
+ * construct is called once, before this function returns, to build the
+ * state in storage; use it for state that cannot simply be copied. If the
+ * task is rejected after construction, invoke destroys the state.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param invoke Function that runs and/or destroys the stored state.
+ * @param construct Function that builds the state in storage from context.
+ * @param context Passed to construct.
+ * @param size Size of the state, at most FOSSIL_THREAD_POOL_INLINE_SIZE.
+ * @return int32_t 0 if the task is successfully submitted, -1 otherwise.
+ */
+int32_t fossil_thread_pool_emplace(fossil_thread_pool_t *pool, fossil_inline_task_t invoke,
+                                   void (*construct)(void *storage, void *context), void *context, size_t size);
+
+/**
+ * @brief Limits the number of tasks waiting in the shared queue.
+ *
+ * Applies to submissions from threads outside the pool. Tasks submitted by
+ * the pool's own tasks go to the submitting worker and are never limited,
+ * since blocking a worker on its own queue could deadlock. Tasks dropped by
+ * FOSSIL_THREAD_POOL_DROP_OLDEST are destroyed without running. Task graph
+ * and pipeline steps are never dropped; if nothing else is queued, the new
+ * submission is rejected instead.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param capacity Maximum queued tasks, or 0 for no limit (the default).
+ * @param policy What a submitter does when the queue is full.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_set_capacity(fossil_thread_pool_t *pool, uint32_t capacity, fossil_thread_pool_policy_t policy);
+
+/**
+ * @brief Cancels a token and removes the queued tasks that carry it.
+ *
+ * Tasks already running are not interrupted; they can poll
+ * fossil_thread_pool_cancel_requested. Tasks queued on a worker are
+ * discarded when they reach the front instead of being removed here.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param token Token to cancel.
+ * @return size_t Number of tasks removed from the shared queue.
+ */
+size_t fossil_thread_pool_cancel(fossil_thread_pool_t *pool, fossil_cancel_token_t *token);
+
+/**
+ * @brief Tells a running task whether its cancellation token was cancelled.
+ *
+ * @return int32_t 1 if the current task's token is cancelled, 0 otherwise,
+ *         including when not called from a pool task.
+ */
+int32_t fossil_thread_pool_cancel_requested(void);
+
+/**
+ * @brief Initializes a cancellation token in the not-cancelled state.
+ *
+ * @param token Pointer to the token.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_cancel_token_create(fossil_cancel_token_t *token);
+
+/**
+ * @brief Cancels a token without touching any queue.
+ *
+ * Tasks carrying it are skipped when a worker reaches them.
+ *
+ * @param token Pointer to the token.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_cancel_token_cancel(fossil_cancel_token_t *token);
+
+/**
+ * @brief Reads a cancellation token.
+ *
+ * @param token Pointer to the token.
+ * @return int32_t 1 if cancelled, 0 otherwise.
+ */
+int32_t fossil_cancel_token_is_cancelled(const fossil_cancel_token_t *token);
+
+/**
+ * @brief Configures how idle workers wait for new tasks.
+ *
+ * An idle worker polls the queue spin_count times, then yields its time slice
+ * up to yield_count times, and finally parks on its own eventcount. Submitters
+ * only issue a kernel wake when a worker is parked, and then wake exactly one.
+ * Setting both counts to zero parks immediately. May be called at any time.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param spin_count Number of polls before yielding.
+ * @param yield_count Number of yields before parking.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_set_idle(fossil_thread_pool_t *pool, uint32_t spin_count, uint32_t yield_count);
+
+/**
+ * @brief Turns statistics collection on or off at runtime.
+ *
+ * Statistics are off by default. While off, workers skip every clock read and
+ * counter update. Requires the library to be built with the with_stats option.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param enabled Non-zero to collect statistics, zero to stop.
+ * @return int32_t 0 if successful, -1 if statistics are compiled out.
+ */
+int32_t fossil_thread_pool_stats_enable(fossil_thread_pool_t *pool, int32_t enabled);
+
+/**
+ * @brief Takes a snapshot of the pool counters and latency histograms.
+ *
+ * Reads each worker's counters without stopping it, so the snapshot is
+ * consistent per counter but not across counters.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param stats Pointer to receive the snapshot.
+ * @return int32_t 0 if successful, -1 if statistics are compiled out.
+ */
+int32_t fossil_thread_pool_stats(fossil_thread_pool_t *pool, fossil_thread_pool_stats_t *stats);
+
+/**
+ * @brief Reads the counters of a single worker.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param index Worker index, as returned by fossil_thread_pool_worker_index.
+ * @param stats Pointer to receive the counters.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_worker_stats(fossil_thread_pool_t *pool, uint32_t index, fossil_thread_pool_worker_stats_t *stats);
+
+/**
+ * @brief Allocates scratch memory that lives until the current task returns.
+ *
+ * Each worker owns a bump arena that is reset after every task, so scratch
+ * allocations are never freed individually.
+ *
+ * @param size Requested size in bytes.
+ * @return void* 16-byte aligned memory, or NULL when not called from a pool
+ *         task or out of memory.
+ */
+void *fossil_thread_pool_scratch_alloc(size_t size);
+
+/**
+ * @brief Returns the index of the pool worker running the caller.
+ *
+ * Spare workers started for blocking regions follow the regular workers,
+ * from the pool's thread count up.
+ *
+ * @return int32_t Index of the current worker, or -1 when not called from a
+ *         pool task.
+ */
+int32_t fossil_thread_pool_worker_index(void);
+
+/**
+ * @brief Allocates one zeroed slot of size bytes per worker of a pool.
+ *
+ * Slots start on their own cache lines, so workers updating their own slot
+ * never share a line. Spare workers have slots too, after the regular ones.
+ * The pool must outlive the slots.
+ *
+ * @param local Pointer to the worker-local storage.
+ * @param pool Pool whose workers get a slot.
+ * @param size Size of each slot in bytes.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_local_create(fossil_thread_pool_local_t *local, fossil_thread_pool_t *pool, size_t size);
+
+/**
+ * @brief Returns the calling worker's slot.
+ *
+ * @param local Pointer to the worker-local storage.
+ * @return void* The slot, or NULL when not called from a task of its pool.
+ */
+void *fossil_thread_pool_local_get(fossil_thread_pool_local_t *local);
+
+/**
+ * @brief Returns the slot of a given worker, for example to combine them.
+ *
+ * @param local Pointer to the worker-local storage.
+ * @param index Worker index.
+ * @return void* The slot, or NULL if index is out of range.
+ */
+void *fossil_thread_pool_local_at(fossil_thread_pool_local_t *local, uint32_t index);
+
+/**
+ * @brief Frees the slots.
+ *
+ * @param local Pointer to the worker-local storage.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_local_destroy(fossil_thread_pool_local_t *local);
+
+/**
+ * @brief Marks the start of a region where the current task may block.
+ *
+ * While a task is blocked its worker runs nothing else, so the pool lets one
+ * spare worker run in its place, waking a parked spare or starting a new
+ * one when there is queued work. The library's own blocking primitives
+ * (mutexes once contended, conditions, semaphores, eventcounts, barriers,
+ * latches and completion queues) call this on their own; call it around
+ * other blocking calls such as file or socket I/O. The worker is also RCU
+ * offline for the region, so it does not hold up grace periods. Regions
+ * nest. Does nothing outside a pool task.
+ */
+void fossil_thread_pool_enter_blocking(void);
+
+/**
+ * @brief Marks the end of a region started by fossil_thread_pool_enter_blocking.
+ *
+ * A spare worker that is no longer needed finishes its current task and
+ * parks again. A worker the region took RCU offline comes back online.
+ */
+void fossil_thread_pool_leave_blocking(void);
+
+/**
+ * @brief Limits the number of spare workers the pool may start.
+ *
+ * Spare workers are started on demand and stay around, parked, until the
+ * pool is destroyed.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param max_spares Maximum spare workers, at most the pool's thread count
+ *        (the default); 0 turns compensation off.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_set_max_spares(fossil_thread_pool_t *pool, uint32_t max_spares);
+
+/**
+ * @brief Reports tasks that run for longer than a threshold.
+ *
+ * A watchdog thread, started on first use, checks the running tasks every
+ * quarter of the threshold and calls callback once for each task found
+ * running past it. Workers only read the clock around tasks while a
+ * threshold is set.
+ *
+ * @param pool Pointer to the thread pool.
+ * @param threshold_ns Running time that flags a task, or 0 to stop checking.
+ * @param callback Function to call, or NULL to only count flagged tasks.
+ * @param context Passed to callback.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_pool_set_watchdog(fossil_thread_pool_t *pool, uint64_t threshold_ns,
+                                        fossil_thread_pool_watchdog_t callback, void *context);
+
 /**
  * @brief Destroys the thread pool and reclaims its resources.
  *
+ * Tasks already submitted are run to completion before the workers exit.
+ *
  * @param pool Pointer to the thread pool.
  * @return int32_t 0 if successful, -1 otherwise.
  */
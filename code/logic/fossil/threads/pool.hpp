@@ -0,0 +1,222 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_POOL_HPP
+#define FOSSIL_THREADS_POOL_HPP
+
+/*
+ * C++20 wrappers over the pool and synchronization primitives. Header only:
+ * everything here compiles down to the C API.
+ *
+ * thread_pool::submit stores the callable in the task node itself when it
+ * fits in FOSSIL_THREAD_POOL_INLINE_SIZE bytes, so lambdas capturing a few
+ * pointers cost no allocation beyond the node. Trivially copyable callables
+ * are memcpy'd; anything else is move-constructed in place. Larger callables
+ * fall back to one heap allocation.
+ */
+
+#include "pool.h"
+#include "sync.h"
+
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace fossil {
+
+namespace detail {
+
+inline void check(int32_t result) {
+    if (result != 0) {
+        throw std::system_error(std::make_error_code(std::errc::resource_unavailable_try_again));
+    }
+}
+
+template <typename F>
+inline constexpr bool fits_inline =
+    sizeof(F) <= FOSSIL_THREAD_POOL_INLINE_SIZE &&
+    alignof(F) <= alignof(std::max_align_t) &&
+    std::is_nothrow_move_constructible_v<F>;
+
+template <typename F>
+inline constexpr bool memcpy_inline =
+    fits_inline<F> && std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>;
+
+// Exceptions cannot cross the worker's C frames: an escaping one terminates.
+template <typename F>
+void invoke_inline(void *storage, int32_t run) noexcept {
+    F *fn = std::launder(static_cast<F *>(storage));
+    if (run) std::invoke(*fn);
+    if constexpr (!std::is_trivially_destructible_v<F>) fn->~F();
+}
+
+template <typename F>
+void construct_inline(void *storage, void *context) {
+    ::new (storage) F(std::move(*static_cast<F *>(context)));
+}
+
+template <typename F>
+void invoke_boxed(void *storage, int32_t run) noexcept {
+    F *fn = *static_cast<F **>(storage);
+    if (run) std::invoke(*fn);
+    delete fn;
+}
+
+} // namespace detail
+
+/* Owns a fossil_thread_pool_t. Not movable: workers keep its address. */
+class thread_pool {
+public:
+    explicit thread_pool(uint32_t num_threads) {
+        detail::check(fossil_thread_pool_create(&pool_, num_threads));
+    }
+
+    ~thread_pool() { fossil_thread_pool_destroy(&pool_); }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /* Queue fn() to run on a worker. Throws std::system_error when the pool
+     * rejects it: out of memory, or a full queue under FOSSIL_THREAD_POOL_FAIL. */
+    template <typename F>
+    void submit(F &&fn) {
+        using Fn = std::decay_t<F>;
+        static_assert(std::is_invocable_v<Fn &>, "submit expects a callable taking no arguments");
+
+        int32_t result;
+        if constexpr (detail::memcpy_inline<Fn>) {
+            Fn copy(std::forward<F>(fn));
+            result = fossil_thread_pool_submit_inline(&pool_, &detail::invoke_inline<Fn>, &copy, sizeof(Fn));
+        } else if constexpr (detail::fits_inline<Fn>) {
+            Fn local(std::forward<F>(fn));
+            result = fossil_thread_pool_emplace(&pool_, &detail::invoke_inline<Fn>,
+                                                &detail::construct_inline<Fn>, &local, sizeof(Fn));
+        } else {
+            Fn *boxed = new Fn(std::forward<F>(fn));
+            result = fossil_thread_pool_submit_inline(&pool_, &detail::invoke_boxed<Fn>, &boxed, sizeof(boxed));
+            if (result != 0) delete boxed;
+        }
+        detail::check(result);
+    }
+
+    /* Awaitable that resumes the awaiting coroutine on a worker. Costs one
+     * task node and nothing else; see fossil/threads/coro.hpp. */
+    class schedule_awaitable {
+    public:
+        explicit schedule_awaitable(fossil_thread_pool_t *pool) noexcept : pool_(pool) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        // If the pool cannot take the task, keep running on this thread.
+        bool await_suspend(std::coroutine_handle<> handle) const noexcept {
+            void *address = handle.address();
+            return fossil_thread_pool_submit_inline(pool_, &resume, &address, sizeof(address)) == 0;
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        // A coroutine cannot be dropped without leaking its frame and
+        // stranding whoever awaits it, so one whose task is discarded unrun
+        // (DROP_OLDEST, cancel, destroy) resumes on the discarding thread.
+        static void resume(void *storage, int32_t) noexcept {
+            std::coroutine_handle<>::from_address(*static_cast<void **>(storage)).resume();
+        }
+
+        fossil_thread_pool_t *pool_;
+    };
+
+    schedule_awaitable schedule() noexcept { return schedule_awaitable(&pool_); }
+
+    void set_idle(uint32_t spin_count, uint32_t yield_count) {
+        fossil_thread_pool_set_idle(&pool_, spin_count, yield_count);
+    }
+
+    uint32_t size() const noexcept { return __atomic_load_n(&pool_.num_threads, __ATOMIC_ACQUIRE); }
+    fossil_thread_pool_t *native_handle() noexcept { return &pool_; }
+
+private:
+    fossil_thread_pool_t pool_;
+};
+
+/* Meets the standard Lockable requirements minus try_lock, so it works with
+ * std::lock_guard and std::unique_lock. */
+class mutex {
+public:
+    mutex() { detail::check(fossil_mutex_create(&mutex_)); }
+    ~mutex() { fossil_mutex_destroy(&mutex_); }
+
+    mutex(const mutex &) = delete;
+    mutex &operator=(const mutex &) = delete;
+
+    void lock() { fossil_mutex_lock(&mutex_); }
+    void unlock() { fossil_mutex_unlock(&mutex_); }
+
+    fossil_mutex_t *native_handle() noexcept { return &mutex_; }
+
+private:
+    fossil_mutex_t mutex_;
+};
+
+using lock_guard = std::lock_guard<mutex>;
+using unique_lock = std::unique_lock<mutex>;
+
+class condition_variable {
+public:
+    condition_variable() { detail::check(fossil_cond_create(&cond_)); }
+    ~condition_variable() { fossil_cond_destroy(&cond_); }
+
+    condition_variable(const condition_variable &) = delete;
+    condition_variable &operator=(const condition_variable &) = delete;
+
+    void wait(unique_lock &lock) { fossil_cond_wait(&cond_, lock.mutex()->native_handle()); }
+
+    template <typename Predicate>
+    void wait(unique_lock &lock, Predicate pred) {
+        while (!pred()) wait(lock);
+    }
+
+    void notify_one() noexcept { fossil_cond_signal(&cond_); }
+    void notify_all() noexcept { fossil_cond_broadcast(&cond_); }
+
+    fossil_cond_t *native_handle() noexcept { return &cond_; }
+
+private:
+    fossil_cond_t cond_;
+};
+
+class semaphore {
+public:
+    explicit semaphore(unsigned int initial = 0) { detail::check(fossil_semaphore_create(&sem_, initial)); }
+    ~semaphore() { fossil_semaphore_destroy(&sem_); }
+
+    semaphore(const semaphore &) = delete;
+    semaphore &operator=(const semaphore &) = delete;
+
+    void acquire() { fossil_semaphore_wait(&sem_); }
+    void release() { fossil_semaphore_post(&sem_); }
+
+    fossil_semaphore_t *native_handle() noexcept { return &sem_; }
+
+private:
+    fossil_semaphore_t sem_;
+};
+
+} // namespace fossil
+
+#endif /* FOSSIL_THREADS_POOL_HPP */
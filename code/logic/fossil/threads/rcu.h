@@ -0,0 +1,146 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_RCU_H
+#define FOSSIL_THREADS_RCU_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "epoch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Read-copy-update for read-mostly data. Readers bracket their accesses
+ * with fossil_rcu_read_lock/unlock, which cost a couple of plain loads and
+ * stores and never an atomic read-modify-write. Writers publish a new
+ * version with fossil_rcu_assign_pointer and free the old one after a grace
+ * period, either by blocking in fossil_rcu_synchronize or by handing it to
+ * the background reclaimer with fossil_rcu_call.
+ *
+ * Pool workers are "online" threads: they report a quiescent state between
+ * tasks, so read-side sections inside a task cost nothing beyond a counter.
+ * Workers go offline inside blocking regions (see
+ * fossil_thread_pool_enter_blocking), which the library's own waits mark.
+ * A task that blocks some other way for a long time should mark the wait
+ * too, or every grace period stalls until it finishes.
+ */
+
+/**
+ * @brief Registers the calling thread with RCU.
+ *
+ * Registration happens on first use; calling this up front only moves the
+ * cost out of the first read-side section. Calling it again is a no-op.
+ *
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_rcu_register(void);
+
+/**
+ * @brief Releases the calling thread's registration.
+ *
+ * @return int32_t 0 if successful, -1 inside a read-side section.
+ */
+int32_t fossil_rcu_unregister(void);
+
+/**
+ * @brief Enters a read-side critical section.
+ *
+ * Data obtained with fossil_rcu_dereference stays valid until the matching
+ * unlock. Sections nest.
+ */
+void fossil_rcu_read_lock(void);
+
+/**
+ * @brief Leaves the innermost read-side critical section.
+ */
+void fossil_rcu_read_unlock(void);
+
+/**
+ * @brief Marks the calling thread online.
+ *
+ * An online thread is treated as a permanent reader between quiescent
+ * states, so its read-side sections need no bookkeeping. Pool workers are
+ * online while they run tasks.
+ */
+void fossil_rcu_thread_online(void);
+
+/**
+ * @brief Marks the calling thread offline.
+ *
+ * Offline threads hold no references and never delay a grace period.
+ * Ignored inside a read-side section.
+ */
+void fossil_rcu_thread_offline(void);
+
+/**
+ * @brief Reports that an online thread holds no RCU-protected references.
+ *
+ * Ignored inside a read-side section and on offline threads.
+ */
+void fossil_rcu_quiescent_state(void);
+
+/**
+ * @brief Waits until every read-side section running at the call has ended.
+ *
+ * An online caller is taken offline for the duration of the wait.
+ *
+ * @return int32_t 0 if successful, -1 inside a read-side section.
+ */
+int32_t fossil_rcu_synchronize(void);
+
+/**
+ * @brief Frees an object once every current reader is done with it.
+ *
+ * Returns immediately; a background reclaimer waits for the grace period
+ * and calls reclaim, batching everything queued in the meantime.
+ *
+ * @param ptr Object to free, already unlinked from shared data.
+ * @param reclaim Function that frees it.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_rcu_call(void *ptr, fossil_reclaim_t reclaim);
+
+/**
+ * @brief Waits until every object queued with fossil_rcu_call has been freed.
+ *
+ * @return int32_t 0 if successful, -1 inside a read-side section.
+ */
+int32_t fossil_rcu_barrier(void);
+
+/**
+ * @brief Publishes a pointer for readers.
+ *
+ * Everything written to the object before the call is visible to a reader
+ * that loads the pointer with fossil_rcu_dereference.
+ *
+ * @param slot Shared location.
+ * @param value New object.
+ */
+void fossil_rcu_assign_pointer(void **slot, void *value);
+
+/**
+ * @brief Loads a pointer published with fossil_rcu_assign_pointer.
+ *
+ * @param slot Shared location.
+ * @return void* The object, valid until the read-side section ends.
+ */
+void *fossil_rcu_dereference(void **slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_RCU_H */
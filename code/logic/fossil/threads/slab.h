@@ -0,0 +1,157 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_SLAB_H
+#define FOSSIL_THREADS_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sync.h"
+
+/* Objects are carved out of pages of this size; the page header lives at the
+ * start of each page so any object finds its page by masking its address. */
+#define FOSSIL_SLAB_PAGE_SIZE (64 * 1024)
+#define FOSSIL_SLAB_MAX_OBJECT (FOSSIL_SLAB_PAGE_SIZE / 8)
+
+/* Built-in size classes used by fossil_slab_alloc_size. */
+#define FOSSIL_SLAB_SIZE_CLASSES 8
+
+/* Per-thread cache and page, private to slab.c. */
+typedef struct fossil_slab_heap_t fossil_slab_heap_t;
+
+/* Fixed-size object allocator with a per-thread cache. Objects freed on a
+ * thread other than the one that allocated them are batched and handed
+ * back to the owning thread's pages without taking a lock. */
+typedef struct fossil_slab_t {
+    size_t object_size;
+    uint32_t objects_per_page;
+    uint64_t uid;
+    fossil_mutex_t mutex;
+    fossil_slab_heap_t *heaps;
+} fossil_slab_t;
+
+/* Chunk of a bump arena, private to slab.c. */
+typedef struct fossil_arena_chunk_t fossil_arena_chunk_t;
+
+/* Bump allocator for scratch memory that is released all at once. */
+typedef struct fossil_arena_t {
+    fossil_arena_chunk_t *first;
+    fossil_arena_chunk_t *current;
+    size_t chunk_size;
+} fossil_arena_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes a slab allocator for objects of one size.
+ *
+ * @param slab Pointer to the slab allocator.
+ * @param object_size Size of each object, at most FOSSIL_SLAB_MAX_OBJECT.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_slab_create(fossil_slab_t *slab, size_t object_size);
+
+/**
+ * @brief Allocates one object from the calling thread's cache.
+ *
+ * @param slab Pointer to the slab allocator.
+ * @return void* The object, 16-byte aligned, or NULL when out of memory.
+ */
+void *fossil_slab_alloc(fossil_slab_t *slab);
+
+/**
+ * @brief Returns an object to the allocator. Any thread may free any object.
+ *
+ * @param slab Pointer to the slab allocator the object came from.
+ * @param ptr Object to free, or NULL.
+ */
+void fossil_slab_free(fossil_slab_t *slab, void *ptr);
+
+/**
+ * @brief Pushes the calling thread's pending remote frees to their owners.
+ *
+ * Threads flush automatically when their batch fills up and when they exit;
+ * call this before a thread goes quiet for a long time.
+ *
+ * @param slab Pointer to the slab allocator.
+ */
+void fossil_slab_flush(fossil_slab_t *slab);
+
+/**
+ * @brief Releases every page of the allocator.
+ *
+ * No thread may use the allocator, or objects from it, afterwards.
+ *
+ * @param slab Pointer to the slab allocator.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_slab_destroy(fossil_slab_t *slab);
+
+/**
+ * @brief Allocates from the built-in size classes (16 to 2048 bytes).
+ *
+ * Larger requests fall through to malloc.
+ *
+ * @param size Requested size in bytes.
+ * @return void* The allocation, or NULL when out of memory.
+ */
+void *fossil_slab_alloc_size(size_t size);
+
+/**
+ * @brief Frees memory from fossil_slab_alloc_size.
+ *
+ * @param ptr Allocation to free, or NULL.
+ * @param size The size passed to fossil_slab_alloc_size.
+ */
+void fossil_slab_free_size(void *ptr, size_t size);
+
+/**
+ * @brief Initializes an empty bump arena.
+ *
+ * @param arena Pointer to the arena.
+ * @param chunk_size Size of each backing chunk; 0 selects 64 KiB.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_arena_create(fossil_arena_t *arena, size_t chunk_size);
+
+/**
+ * @brief Allocates from the arena. Not thread safe.
+ *
+ * @param arena Pointer to the arena.
+ * @param size Requested size in bytes.
+ * @return void* 16-byte aligned memory, or NULL when out of memory.
+ */
+void *fossil_arena_alloc(fossil_arena_t *arena, size_t size);
+
+/**
+ * @brief Releases every allocation at once, keeping the chunks for reuse.
+ *
+ * @param arena Pointer to the arena.
+ */
+void fossil_arena_reset(fossil_arena_t *arena);
+
+/**
+ * @brief Frees all chunks of the arena.
+ *
+ * @param arena Pointer to the arena.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_arena_destroy(fossil_arena_t *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_SLAB_H */
@@ -15,6 +15,7 @@
 #define FOSSIL_THREADS_SYNC_H
 
 #include <stdint.h>
+#include <stdio.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -32,6 +33,49 @@ typedef struct {
 } fossil_semaphore_t;
 #endif
 
+/* Eventcount: a waiter announces itself before re-checking its condition so
+ * that notifiers only issue a kernel wake when somebody is actually asleep. */
+typedef struct {
+    uint32_t epoch;
+    uint32_t waiters;
+} fossil_eventcount_t;
+
+/* Combining tree node of a tree barrier, private to sync.c. */
+typedef struct fossil_barrier_node_t fossil_barrier_node_t;
+
+/* Reusable barrier. Waiters spin for a while, then park on the phase word.
+ * The flat form counts arrivals on one word; the tree form combines them
+ * in small groups so that no cache line sees more than fanin writers. */
+typedef struct {
+    uint32_t count;
+    uint32_t remaining;
+    uint32_t phase;
+    uint32_t waiters;
+    uint32_t spin_count;
+    uint32_t fanin;
+    uint32_t num_nodes;
+    fossil_barrier_node_t *nodes;
+} fossil_barrier_t;
+
+/* One-shot latch: threads count it down and wait for it to reach zero. */
+typedef struct {
+    uint32_t count;
+} fossil_latch_t;
+
+/* One row of the lock contention profile: a lock instance acquired from a
+ * particular call site. Counts and times are scaled by the sample period in
+ * force when each sample was taken. */
+typedef struct {
+    const void *lock;
+    const void *call_site;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+    uint64_t max_wait_ns;
+    uint64_t hold_ns;
+    uint64_t max_hold_ns;
+} fossil_lock_profile_entry_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -116,6 +160,156 @@ int32_t fossil_semaphore_post(fossil_semaphore_t *sem);
  */
 int32_t fossil_semaphore_destroy(fossil_semaphore_t *sem);
 
+/** Initialize an eventcount.
+ *  @param ec Pointer to the eventcount object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_eventcount_create(fossil_eventcount_t *ec);
+
+/** Register the caller as a waiter and return the key to wait on.
+ *  The caller must re-check its wait condition after this call and then
+ *  either wait with the returned key or cancel.
+ *  @param ec Pointer to the eventcount object.
+ *  @return The current epoch, to be passed to fossil_eventcount_wait.
+ */
+uint32_t fossil_eventcount_prepare_wait(fossil_eventcount_t *ec);
+
+/** Withdraw a registration made by fossil_eventcount_prepare_wait.
+ *  @param ec Pointer to the eventcount object.
+ */
+void fossil_eventcount_cancel_wait(fossil_eventcount_t *ec);
+
+/** Sleep until the eventcount is notified after key was obtained.
+ *  @param ec Pointer to the eventcount object.
+ *  @param key Value returned by fossil_eventcount_prepare_wait.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_eventcount_wait(fossil_eventcount_t *ec, uint32_t key);
+
+/** Wake the threads waiting on an eventcount. Costs a single load when
+ *  nobody is registered as a waiter.
+ *  @param ec Pointer to the eventcount object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_eventcount_notify(fossil_eventcount_t *ec);
+
+/** Destroy an eventcount.
+ *  @param ec Pointer to the eventcount object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_eventcount_destroy(fossil_eventcount_t *ec);
+
+/** Initialize a barrier for count threads.
+ *  @param barrier Pointer to the barrier object.
+ *  @param count Number of threads that must arrive in each phase.
+ *  @return 0 on success, or -1 if count is zero.
+ */
+int32_t fossil_barrier_create(fossil_barrier_t *barrier, uint32_t count);
+
+/** Initialize a combining tree barrier for count threads. Threads must
+ *  arrive through fossil_barrier_wait_id, each with its own id.
+ *  @param barrier Pointer to the barrier object.
+ *  @param count Number of threads that must arrive in each phase.
+ *  @param fanin Threads or subtrees combined per node, at least 2.
+ *  @return 0 on success, or -1 on invalid arguments or out of memory.
+ */
+int32_t fossil_barrier_create_tree(fossil_barrier_t *barrier, uint32_t count, uint32_t fanin);
+
+/** Set how many times a waiter polls before parking. The default spins
+ *  only on machines with more than one CPU.
+ *  @param barrier Pointer to the barrier object.
+ *  @param spin_count Number of polls before parking.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_barrier_set_spin(fossil_barrier_t *barrier, uint32_t spin_count);
+
+/** Wait at a flat barrier until all threads of the phase have arrived.
+ *  @param barrier Pointer to the barrier object.
+ *  @return 1 in exactly one thread per phase, 0 in the others, or -1 if
+ *          the barrier is a tree barrier.
+ */
+int32_t fossil_barrier_wait(fossil_barrier_t *barrier);
+
+/** Wait at a barrier, arriving as thread id. Works with both forms.
+ *  @param barrier Pointer to the barrier object.
+ *  @param id Caller's index, less than count and unique in the phase.
+ *  @return 1 in exactly one thread per phase, 0 in the others, or -1 if
+ *          id is out of range.
+ */
+int32_t fossil_barrier_wait_id(fossil_barrier_t *barrier, uint32_t id);
+
+/** Destroy a barrier. No thread may be waiting on it.
+ *  @param barrier Pointer to the barrier object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_barrier_destroy(fossil_barrier_t *barrier);
+
+/** Initialize a latch.
+ *  @param latch Pointer to the latch object.
+ *  @param count Number of count downs before waiters are released.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_latch_create(fossil_latch_t *latch, uint32_t count);
+
+/** Decrease the latch by n, releasing the waiters when it reaches zero.
+ *  @param latch Pointer to the latch object.
+ *  @param n Amount to count down; must not exceed the remaining count.
+ *  @return 0 on success, or -1 if n exceeds the remaining count.
+ */
+int32_t fossil_latch_count_down(fossil_latch_t *latch, uint32_t n);
+
+/** Check the latch without blocking.
+ *  @param latch Pointer to the latch object.
+ *  @return 1 if the count has reached zero, 0 otherwise.
+ */
+int32_t fossil_latch_try_wait(fossil_latch_t *latch);
+
+/** Block until the latch reaches zero.
+ *  @param latch Pointer to the latch object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_latch_wait(fossil_latch_t *latch);
+
+/** Count down by one and wait for the latch to reach zero.
+ *  @param latch Pointer to the latch object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_latch_arrive_and_wait(fossil_latch_t *latch);
+
+/** Destroy a latch.
+ *  @param latch Pointer to the latch object.
+ *  @return 0 on success, or an error code on failure.
+ */
+int32_t fossil_latch_destroy(fossil_latch_t *latch);
+
+/** Start or stop the lock contention profiler.
+ *  Every sample_period-th mutex lock or semaphore wait on each thread is
+ *  timed and attributed to its lock instance and call site; the rest take
+ *  the normal path. Requires the with_lock_profiler build option.
+ *  @param sample_period Sample one acquisition in this many, or 0 to stop.
+ *  @return 0 on success, or -1 if the profiler is compiled out.
+ */
+int32_t fossil_lock_profile_enable(uint32_t sample_period);
+
+/** Clear all counters gathered by the lock profiler.
+ *  @return 0 on success, or -1 if the profiler is compiled out.
+ */
+int32_t fossil_lock_profile_reset(void);
+
+/** Copy the profile, sorted by total wait time, worst first.
+ *  @param entries Array to receive the rows.
+ *  @param max_entries Capacity of entries.
+ *  @return Number of rows written, or -1 if the profiler is compiled out.
+ */
+int32_t fossil_lock_profile_snapshot(fossil_lock_profile_entry_t *entries, uint32_t max_entries);
+
+/** Print the worst rows of the profile as a table.
+ *  @param out Stream to write to.
+ *  @param max_entries Maximum number of rows to print.
+ *  @return 0 on success, or -1 if the profiler is compiled out.
+ */
+int32_t fossil_lock_profile_report(FILE *out, uint32_t max_entries);
+
 #ifdef __cplusplus
 }
 #endif
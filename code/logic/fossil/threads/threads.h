@@ -65,6 +65,31 @@ int32_t fossil_thread_join(fossil_thread_t thread, void **retval);
  */
 int32_t fossil_thread_detach(fossil_thread_t thread);
 
+/**
+ * @brief Keeps finished threads parked so fossil_thread_create can reuse them.
+ *
+ * While enabled, a thread that has been joined or has finished detached
+ * waits in a cache of up to max_idle threads, and the next create with the
+ * same stack and guard size hands it the new task instead of starting a
+ * kernel thread. Join, detach and return values behave as before, but
+ * thread-local storage survives between reuses and its destructors run only
+ * when the cached thread finally exits. Lowering the limit releases parked
+ * threads beyond it.
+ *
+ * @param max_idle Maximum number of parked threads; 0 disables the cache.
+ * @return int32_t 0 if successful, -1 if this platform has no thread cache.
+ */
+int32_t fossil_thread_cache_enable(uint32_t max_idle);
+
+/**
+ * @brief Disables the thread cache and releases every parked thread.
+ *
+ * Threads created while the cache was enabled can still be joined.
+ *
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_thread_cache_disable(void);
+
 /**
  * @brief Creates thread attributes with default values.
  *
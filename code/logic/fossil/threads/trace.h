@@ -0,0 +1,96 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_TRACE_H
+#define FOSSIL_THREADS_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Default number of events kept per thread; older events are overwritten. */
+#define FOSSIL_TRACE_DEFAULT_EVENTS 65536
+
+/* Task and fiber lifecycle events. id identifies the task node or fiber,
+ * aux carries event-specific detail such as the task function. */
+typedef enum {
+    FOSSIL_TRACE_SUBMIT,
+    FOSSIL_TRACE_DEQUEUE,
+    FOSSIL_TRACE_START,
+    FOSSIL_TRACE_END,
+    FOSSIL_TRACE_STEAL,
+    FOSSIL_TRACE_PARK,
+    FOSSIL_TRACE_WAKE,
+    FOSSIL_TRACE_FIBER_SWITCH,
+    FOSSIL_TRACE_USER
+} fossil_trace_event_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts recording events into per-thread ring buffers.
+ *
+ * Each thread gets its own lock-free buffer the first time it records an
+ * event. Requires the library to be built with the with_trace option;
+ * otherwise every hook compiles to nothing.
+ *
+ * @param events_per_thread Ring capacity, rounded up to a power of two, or 0
+ *        for FOSSIL_TRACE_DEFAULT_EVENTS.
+ * @return int32_t 0 if successful, -1 if tracing is compiled out.
+ */
+int32_t fossil_trace_start(uint32_t events_per_thread);
+
+/**
+ * @brief Stops recording. Buffers are kept until the next start.
+ *
+ * @return int32_t 0 if successful, -1 if tracing is compiled out.
+ */
+int32_t fossil_trace_stop(void);
+
+/**
+ * @brief Names the calling thread in the exported trace.
+ *
+ * @param name Thread name; copied.
+ * @return int32_t 0 if successful, -1 if tracing is compiled out.
+ */
+int32_t fossil_trace_thread_name(const char *name);
+
+/**
+ * @brief Records an event on the calling thread.
+ *
+ * The library records its own events; applications may add FOSSIL_TRACE_USER
+ * markers. Does nothing while tracing is stopped.
+ *
+ * @param kind Event kind.
+ * @param id Task, fiber or user identifier.
+ * @param aux Event-specific detail.
+ */
+void fossil_trace_record(fossil_trace_event_t kind, const void *id, uint64_t aux);
+
+/**
+ * @brief Writes all buffered events as Chrome trace-event JSON.
+ *
+ * The output opens in Perfetto and chrome://tracing. Stop tracing first for a
+ * consistent snapshot; events recorded during the dump may be torn.
+ *
+ * @param out Stream to write to.
+ * @return int32_t 0 if successful, -1 otherwise.
+ */
+int32_t fossil_trace_dump(FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FOSSIL_THREADS_TRACE_H */
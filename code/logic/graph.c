@@ -0,0 +1,242 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/graph.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* -------- Task Graph -------- */
+
+/*
+ * Every node keeps the number of its predecessors and, per run, a counter of
+ * those still outstanding. A finishing node decrements the counters of its
+ * successors; whoever brings one to zero owns it. The first node it readies
+ * runs next on the same thread, the rest are submitted from the worker and
+ * land on its local deque, where idle workers can steal them.
+ *
+ * Runs only reset the counters, so a graph allocates while it is built and
+ * never afterwards.
+ */
+
+#define GRAPH_MIN_CAPACITY 16
+#define GRAPH_NONE UINT32_MAX
+
+struct fossil_task_graph_node_t {
+    FOSSIL_CACHE_ALIGNED uint32_t pending; // Written by finishing predecessors.
+    uint32_t num_predecessors;
+    uint32_t num_successors;
+    uint32_t successor_capacity;
+    uint32_t *successors;
+    fossil_task_t task;
+    fossil_argumet_t arg;
+};
+
+typedef struct {
+    fossil_task_graph_t *graph;
+    uint32_t index;
+} graph_dispatch_t;
+
+static void graph_dispatch(fossil_task_graph_t *graph, uint32_t index);
+
+// Runs a node, then every successor it readies that nobody else will.
+static void graph_node_run(fossil_task_graph_t *graph, uint32_t index) {
+    while (index != GRAPH_NONE) {
+        fossil_task_graph_node_t *node = &graph->nodes[index];
+        node->task(node->arg);
+
+        uint32_t next = GRAPH_NONE;
+        for (uint32_t i = 0; i < node->num_successors; i++) {
+            uint32_t succ = node->successors[i];
+            if (__atomic_sub_fetch(&graph->nodes[succ].pending, 1, __ATOMIC_ACQ_REL) != 0) continue;
+            if (next == GRAPH_NONE) {
+                next = succ;
+            } else {
+                graph_dispatch(graph, succ);
+            }
+        }
+
+        // The last node to finish hands the graph back to the waiter and
+        // must not touch it after raising finished.
+        if (__atomic_sub_fetch(&graph->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+            fossil_eventcount_notify(&graph->done);
+            __atomic_store_n(&graph->finished, 1, __ATOMIC_RELEASE);
+            return;
+        }
+        index = next;
+    }
+}
+
+static void graph_invoke(void *storage, int32_t run) {
+    if (!run) return;
+    graph_dispatch_t *dispatch = (graph_dispatch_t *)storage;
+    graph_node_run(dispatch->graph, dispatch->index);
+}
+
+static void graph_dispatch(fossil_task_graph_t *graph, uint32_t index) {
+    graph_dispatch_t dispatch = { graph, index };
+    if (fossil_thread_pool_submit_owned(graph->pool, graph_invoke, &dispatch, sizeof(dispatch)) != 0) {
+        graph_node_run(graph, index);
+    }
+}
+
+// Kahn's algorithm: the graph is acyclic iff every node can be ordered.
+static int32_t graph_validate(fossil_task_graph_t *graph) {
+    uint32_t count = graph->num_nodes;
+    if (count == 0) return 0;
+
+    uint32_t *indegree = (uint32_t *)malloc(2 * (size_t)count * sizeof(uint32_t));
+    if (!indegree) return -1;
+    uint32_t *order = indegree + count;
+
+    uint32_t tail = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        indegree[i] = graph->nodes[i].num_predecessors;
+        if (indegree[i] == 0) order[tail++] = i;
+    }
+    for (uint32_t head = 0; head < tail; head++) {
+        fossil_task_graph_node_t *node = &graph->nodes[order[head]];
+        for (uint32_t i = 0; i < node->num_successors; i++) {
+            if (--indegree[node->successors[i]] == 0) order[tail++] = node->successors[i];
+        }
+    }
+
+    free(indegree);
+    return tail == count ? 0 : -1;
+}
+
+int32_t fossil_task_graph_create(fossil_task_graph_t *graph, fossil_thread_pool_t *pool) {
+    if (!graph || !pool) return -1;
+    memset(graph, 0, sizeof(*graph));
+    graph->pool = pool;
+    graph->validated = 1;
+    return fossil_eventcount_create(&graph->done);
+}
+
+int32_t fossil_task_graph_add(fossil_task_graph_t *graph, fossil_task_t task, fossil_argumet_t arg) {
+    if (!graph || !task || __atomic_load_n(&graph->running, __ATOMIC_ACQUIRE)) return -1;
+    if (graph->num_nodes >= (uint32_t)INT32_MAX) return -1;
+
+    if (graph->num_nodes == graph->capacity) {
+        uint32_t capacity = graph->capacity ? graph->capacity * 2 : GRAPH_MIN_CAPACITY;
+        fossil_task_graph_node_t *nodes = (fossil_task_graph_node_t *)fossil_platform_aligned_alloc(
+            FOSSIL_CACHE_LINE, capacity * sizeof(fossil_task_graph_node_t));
+        if (!nodes) return -1;
+        if (graph->nodes) {
+            memcpy(nodes, graph->nodes, graph->num_nodes * sizeof(fossil_task_graph_node_t));
+            fossil_platform_aligned_free(graph->nodes);
+        }
+        graph->nodes = nodes;
+        graph->capacity = capacity;
+    }
+
+    fossil_task_graph_node_t *node = &graph->nodes[graph->num_nodes];
+    memset(node, 0, sizeof(*node));
+    node->task = task;
+    node->arg = arg;
+    return (int32_t)graph->num_nodes++;
+}
+
+int32_t fossil_task_graph_depend(fossil_task_graph_t *graph, int32_t node, int32_t dependency) {
+    if (!graph || __atomic_load_n(&graph->running, __ATOMIC_ACQUIRE)) return -1;
+    if (node < 0 || dependency < 0 || node == dependency) return -1;
+    if ((uint32_t)node >= graph->num_nodes || (uint32_t)dependency >= graph->num_nodes) return -1;
+
+    fossil_task_graph_node_t *before = &graph->nodes[dependency];
+    if (before->num_successors == before->successor_capacity) {
+        uint32_t capacity = before->successor_capacity ? before->successor_capacity * 2 : 4;
+        uint32_t *successors = (uint32_t *)realloc(before->successors, capacity * sizeof(uint32_t));
+        if (!successors) return -1;
+        before->successors = successors;
+        before->successor_capacity = capacity;
+    }
+
+    before->successors[before->num_successors++] = (uint32_t)node;
+    graph->nodes[node].num_predecessors++;
+    graph->validated = 0;
+    return 0;
+}
+
+int32_t fossil_task_graph_start(fossil_task_graph_t *graph) {
+    if (!graph) return -1;
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&graph->running, &expected, 1, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return -1;
+    }
+
+    if (!graph->validated) {
+        if (graph_validate(graph) != 0) {
+            __atomic_store_n(&graph->running, 0, __ATOMIC_RELEASE);
+            return -1;
+        }
+        graph->validated = 1;
+    }
+
+    if (graph->num_nodes == 0) {
+        __atomic_store_n(&graph->finished, 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < graph->num_nodes; i++) {
+        graph->nodes[i].pending = graph->nodes[i].num_predecessors;
+    }
+    graph->finished = 0;
+    __atomic_store_n(&graph->remaining, graph->num_nodes, __ATOMIC_RELEASE);
+
+    // Pick roots by their static predecessor count: the pending counters
+    // start changing as soon as the first root is dispatched.
+    for (uint32_t i = 0; i < graph->num_nodes; i++) {
+        if (graph->nodes[i].num_predecessors == 0) graph_dispatch(graph, i);
+    }
+    return 0;
+}
+
+int32_t fossil_task_graph_wait(fossil_task_graph_t *graph) {
+    if (!graph) return -1;
+    if (!__atomic_load_n(&graph->running, __ATOMIC_ACQUIRE)) return 0;
+
+    while (__atomic_load_n(&graph->remaining, __ATOMIC_ACQUIRE) != 0) {
+        uint32_t key = fossil_eventcount_prepare_wait(&graph->done);
+        if (__atomic_load_n(&graph->remaining, __ATOMIC_ACQUIRE) == 0) {
+            fossil_eventcount_cancel_wait(&graph->done);
+            break;
+        }
+        fossil_eventcount_wait(&graph->done, key);
+    }
+    // The last node may still be inside notify; wait until it lets go.
+    while (!__atomic_load_n(&graph->finished, __ATOMIC_ACQUIRE)) {
+        fossil_platform_yield();
+    }
+
+    __atomic_store_n(&graph->running, 0, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int32_t fossil_task_graph_run(fossil_task_graph_t *graph) {
+    if (fossil_task_graph_start(graph) != 0) return -1;
+    return fossil_task_graph_wait(graph);
+}
+
+int32_t fossil_task_graph_destroy(fossil_task_graph_t *graph) {
+    if (!graph || __atomic_load_n(&graph->running, __ATOMIC_ACQUIRE)) return -1;
+
+    for (uint32_t i = 0; i < graph->num_nodes; i++) {
+        free(graph->nodes[i].successors);
+    }
+    fossil_platform_aligned_free(graph->nodes);
+    graph->nodes = NULL;
+    graph->num_nodes = 0;
+    graph->capacity = 0;
+    return fossil_eventcount_destroy(&graph->done);
+}
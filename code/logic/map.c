@@ -0,0 +1,456 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/map.h"
+#include "fossil/threads/epoch.h"
+#include "fossil/threads/slab.h"
+#include "platform.h"
+#include <string.h>
+
+/* -------- Concurrent Hash Map -------- */
+
+/*
+ * Each bucket is one cache line: a metadata word followed by seven entry
+ * pointers. Bytes 0-6 of the metadata hold a 7-bit tag per slot (high bit
+ * set, 0 means empty) and byte 7 holds the control bits, so a lookup
+ * filters a whole bucket with a handful of integer operations before it
+ * touches any entry.
+ *
+ * A key lives within MAP_PROBE buckets of its home bucket. The table has
+ * MAP_PROBE - 1 spare buckets past the end instead of wrapping, so writers
+ * always lock buckets in ascending order. A bucket marked OVERFLOW once
+ * spilled into its successor and lookups must keep probing.
+ *
+ * Growing allocates a table twice the size and links it from the old one.
+ * Buckets are migrated one at a time under their lock and marked MOVED.
+ * Writers that meet a MOVED bucket migrate the rest of the chain and
+ * continue in the next table; readers finish the chain, then search there.
+ * Entries are shared between the two tables, so values stay coherent.
+ */
+
+#define MAP_SLOTS 7
+#define MAP_PROBE 8
+#define MAP_CHUNK 16
+#define MAP_MIN_BUCKETS 8
+
+#define META_LOCK (1ull << 56)
+#define META_MOVED (1ull << 57)
+#define META_OVERFLOW (1ull << 58)
+#define META_TAGS 0x00FFFFFFFFFFFFFFull
+#define SWAR_ONES 0x0001010101010101ull
+#define SWAR_HIGHS 0x0080808080808080ull
+
+typedef struct {
+    uint64_t key;
+    void *value;
+} map_entry_t;
+
+typedef struct {
+    FOSSIL_CACHE_ALIGNED uint64_t meta;
+    map_entry_t *entries[MAP_SLOTS];
+} map_bucket_t;
+
+struct fossil_map_table_t {
+    FOSSIL_CACHE_ALIGNED uint64_t mask;
+    size_t num_buckets;
+    size_t threshold;
+    fossil_map_table_t *next;
+
+    // Migration progress, written by every helper.
+    FOSSIL_CACHE_ALIGNED size_t cursor;
+    size_t migrated;
+
+    map_bucket_t buckets[];
+};
+
+typedef enum {
+    OP_INSERT,
+    OP_PUT,
+    OP_ERASE,
+    OP_MIGRATE
+} map_op_t;
+
+typedef enum {
+    MAP_ADDED,
+    MAP_FOUND,
+    MAP_ABSENT,
+    MAP_MOVED,
+    MAP_FULL,
+    MAP_NOMEM
+} map_result_t;
+
+static inline uint64_t map_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+static inline uint64_t map_tag(uint64_t hash) {
+    return (hash >> 57) | 0x80;
+}
+
+// Bit 7 of byte i is set when slot i may hold tag. False positives are
+// possible and are weeded out by comparing keys.
+static inline uint64_t map_match(uint64_t meta, uint64_t tag) {
+    uint64_t x = (meta & META_TAGS) ^ (SWAR_ONES * tag);
+    return (x - SWAR_ONES) & ~x & SWAR_HIGHS;
+}
+
+static inline uint32_t map_slot(uint64_t bits) {
+    return (uint32_t)__builtin_ctzll(bits) >> 3;
+}
+
+static void entry_free(void *ptr) {
+    fossil_slab_free_size(ptr, sizeof(map_entry_t));
+}
+
+static void table_free(void *ptr) {
+    fossil_platform_aligned_free(ptr);
+}
+
+static fossil_map_table_t *table_create(size_t buckets) {
+    size_t num_buckets = buckets + MAP_PROBE - 1;
+    size_t size = sizeof(fossil_map_table_t) + num_buckets * sizeof(map_bucket_t);
+    fossil_map_table_t *table = (fossil_map_table_t *)fossil_platform_aligned_alloc(FOSSIL_CACHE_LINE, size);
+    if (!table) return NULL;
+
+    memset(table, 0, size);
+    table->mask = buckets - 1;
+    table->num_buckets = num_buckets;
+    table->threshold = buckets * MAP_SLOTS / 4 * 3;
+    return table;
+}
+
+static uint64_t bucket_lock(map_bucket_t *bucket) {
+    uint64_t meta = __atomic_load_n(&bucket->meta, __ATOMIC_RELAXED);
+    uint32_t spins = 0;
+    while (1) {
+        if (!(meta & META_LOCK)) {
+            if (__atomic_compare_exchange_n(&bucket->meta, &meta, meta | META_LOCK, 1,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return meta | META_LOCK;
+            }
+            continue;
+        }
+        if (++spins < 64) {
+            fossil_platform_relax();
+        } else {
+            fossil_platform_yield();
+        }
+        meta = __atomic_load_n(&bucket->meta, __ATOMIC_RELAXED);
+    }
+}
+
+static inline void bucket_unlock(map_bucket_t *bucket, uint64_t meta) {
+    __atomic_store_n(&bucket->meta, meta & ~META_LOCK, __ATOMIC_RELEASE);
+}
+
+static void map_migrate_bucket(fossil_concurrent_map_t *map, fossil_map_table_t *table, size_t index);
+
+// Apply one operation to the probe chain of hash in a single table, with
+// every bucket it visits locked. Migration passes the entry to move in and
+// skips the key search, since a key is never in both tables at once.
+static map_result_t table_apply(fossil_map_table_t *table, uint64_t hash, uint64_t key,
+                                map_op_t op, void **value, map_entry_t *moving) {
+    size_t home = (size_t)(hash & table->mask);
+    uint64_t tag = map_tag(hash);
+    map_bucket_t *held[MAP_PROBE];
+    uint64_t metas[MAP_PROBE];
+    uint32_t count = 0;
+    int32_t free_bucket = -1;
+    uint32_t free_slot = 0;
+    int32_t searching = op != OP_MIGRATE;
+    map_result_t result = MAP_ABSENT;
+
+    for (uint32_t i = 0; i < MAP_PROBE; i++) {
+        map_bucket_t *bucket = &table->buckets[home + i];
+        uint64_t meta = bucket_lock(bucket);
+        held[count] = bucket;
+        metas[count] = meta;
+        count++;
+
+        if (meta & META_MOVED) {
+            result = MAP_MOVED;
+            goto unlock;
+        }
+
+        if (searching) {
+            for (uint64_t bits = map_match(meta, tag); bits; bits &= bits - 1) {
+                uint32_t slot = map_slot(bits);
+                map_entry_t *entry = bucket->entries[slot];
+                if (!entry || entry->key != key) continue;
+
+                result = MAP_FOUND;
+                if (op == OP_INSERT) {
+                    goto unlock;
+                } else if (op == OP_PUT) {
+                    *value = __atomic_exchange_n(&entry->value, *value, __ATOMIC_ACQ_REL);
+                } else {
+                    *value = __atomic_load_n(&entry->value, __ATOMIC_RELAXED);
+                    metas[count - 1] &= ~(0xFFull << (slot * 8));
+                    __atomic_store_n(&bucket->meta, metas[count - 1], __ATOMIC_RELEASE);
+                    __atomic_store_n(&bucket->entries[slot], NULL, __ATOMIC_RELEASE);
+                    fossil_epoch_retire(entry, entry_free);
+                }
+                goto unlock;
+            }
+            if (!(meta & META_OVERFLOW)) searching = 0;
+        }
+
+        if (free_bucket < 0) {
+            uint64_t empty = map_match(meta, 0);
+            if (empty) {
+                free_bucket = (int32_t)(count - 1);
+                free_slot = map_slot(empty);
+            }
+        }
+        if (!searching && (op == OP_ERASE || free_bucket >= 0)) break;
+    }
+
+    if (op == OP_ERASE) goto unlock;
+    if (free_bucket < 0) {
+        result = MAP_FULL;
+        goto unlock;
+    }
+
+    map_entry_t *entry = moving;
+    if (!entry) {
+        entry = (map_entry_t *)fossil_slab_alloc_size(sizeof(map_entry_t));
+        if (!entry) {
+            result = MAP_NOMEM;
+            goto unlock;
+        }
+        entry->key = key;
+        entry->value = *value;
+        *value = NULL;
+    }
+
+    // Publish the entry before its tag, and the overflow marks that lead to
+    // it before either.
+    for (int32_t i = 0; i < free_bucket; i++) {
+        if (!(metas[i] & META_OVERFLOW)) {
+            metas[i] |= META_OVERFLOW;
+            __atomic_store_n(&held[i]->meta, metas[i], __ATOMIC_RELEASE);
+        }
+    }
+    __atomic_store_n(&held[free_bucket]->entries[free_slot], entry, __ATOMIC_RELEASE);
+    metas[free_bucket] |= tag << (free_slot * 8);
+    __atomic_store_n(&held[free_bucket]->meta, metas[free_bucket], __ATOMIC_RELEASE);
+    result = MAP_ADDED;
+
+unlock:
+    for (uint32_t i = 0; i < count; i++) {
+        bucket_unlock(held[i], metas[i]);
+    }
+    return result;
+}
+
+static void map_start_resize(fossil_map_table_t *table) {
+    if (__atomic_load_n(&table->next, __ATOMIC_ACQUIRE)) return;
+
+    fossil_map_table_t *next = table_create((size_t)(table->mask + 1) * 2);
+    if (!next) return;
+
+    fossil_map_table_t *expected = NULL;
+    if (!__atomic_compare_exchange_n(&table->next, &expected, next, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        table_free(next);
+    }
+}
+
+// Retire every table at the front of the chain that has been fully drained.
+static void map_advance(fossil_concurrent_map_t *map) {
+    fossil_map_table_t *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+    fossil_map_table_t *next;
+    while ((next = __atomic_load_n(&table->next, __ATOMIC_ACQUIRE)) != NULL &&
+           __atomic_load_n(&table->migrated, __ATOMIC_ACQUIRE) == table->num_buckets) {
+        if (__atomic_compare_exchange_n(&map->table, &table, next, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            fossil_epoch_retire(table, table_free);
+            table = next;
+        }
+    }
+}
+
+// Run op against the newest table that owns hash, following and driving
+// any resize met on the way.
+static map_result_t map_apply(fossil_concurrent_map_t *map, fossil_map_table_t *table, uint64_t hash,
+                              uint64_t key, map_op_t op, void **value, map_entry_t *moving) {
+    while (1) {
+        map_result_t result = table_apply(table, hash, key, op, value, moving);
+        if (result != MAP_MOVED && result != MAP_FULL) return result;
+
+        if (result == MAP_FULL) map_start_resize(table);
+        fossil_map_table_t *next = __atomic_load_n(&table->next, __ATOMIC_ACQUIRE);
+        if (!next) return MAP_NOMEM;
+
+        // The whole probe chain must be in the next table before we use it,
+        // or the key could end up in both.
+        size_t home = (size_t)(hash & table->mask);
+        for (uint32_t i = 0; i < MAP_PROBE; i++) {
+            map_migrate_bucket(map, table, home + i);
+        }
+        table = next;
+    }
+}
+
+static void map_migrate_bucket(fossil_concurrent_map_t *map, fossil_map_table_t *table, size_t index) {
+    map_bucket_t *bucket = &table->buckets[index];
+    uint64_t meta = bucket_lock(bucket);
+    if (meta & META_MOVED) {
+        bucket_unlock(bucket, meta);
+        return;
+    }
+
+    fossil_map_table_t *next = __atomic_load_n(&table->next, __ATOMIC_ACQUIRE);
+    for (uint64_t bits = meta & SWAR_HIGHS; bits; bits &= bits - 1) {
+        map_entry_t *entry = bucket->entries[map_slot(bits)];
+        void *unused = NULL;
+        map_apply(map, next, map_hash(entry->key), entry->key, OP_MIGRATE, &unused, entry);
+    }
+
+    bucket_unlock(bucket, meta | META_MOVED);
+    if (__atomic_add_fetch(&table->migrated, 1, __ATOMIC_ACQ_REL) == table->num_buckets) {
+        map_advance(map);
+    }
+}
+
+// Writers move one chunk of an in-progress resize before doing their own work.
+static fossil_map_table_t *map_writer_table(fossil_concurrent_map_t *map) {
+    fossil_map_table_t *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&table->next, __ATOMIC_ACQUIRE) &&
+        __atomic_load_n(&table->cursor, __ATOMIC_RELAXED) < table->num_buckets) {
+        size_t start = __atomic_fetch_add(&table->cursor, MAP_CHUNK, __ATOMIC_RELAXED);
+        for (size_t i = start; i < start + MAP_CHUNK && i < table->num_buckets; i++) {
+            map_migrate_bucket(map, table, i);
+        }
+    }
+    return table;
+}
+
+int32_t fossil_concurrent_map_create(fossil_concurrent_map_t *map, size_t capacity) {
+    size_t buckets = MAP_MIN_BUCKETS;
+    while (buckets * MAP_SLOTS / 4 * 3 < capacity) buckets *= 2;
+
+    map->table = table_create(buckets);
+    map->count = 0;
+    return map->table ? 0 : -1;
+}
+
+int32_t fossil_concurrent_map_get(fossil_concurrent_map_t *map, uint64_t key, void **value) {
+    uint64_t hash = map_hash(key);
+    uint64_t tag = map_tag(hash);
+    int32_t found = -1;
+
+    fossil_epoch_enter();
+    fossil_map_table_t *table = __atomic_load_n(&map->table, __ATOMIC_ACQUIRE);
+
+    // Buckets of a chain migrate one at a time, so a MOVED bucket says
+    // nothing about its successors: scan the rest of the chain here and
+    // only then look in the next table for what has already moved.
+    while (table) {
+        size_t home = (size_t)(hash & table->mask);
+        int32_t moved = 0;
+
+        for (uint32_t i = 0; i < MAP_PROBE; i++) {
+            map_bucket_t *bucket = &table->buckets[home + i];
+            uint64_t meta = __atomic_load_n(&bucket->meta, __ATOMIC_ACQUIRE);
+
+            if (meta & META_MOVED) {
+                moved = 1;
+            } else {
+                for (uint64_t bits = map_match(meta, tag); bits; bits &= bits - 1) {
+                    map_entry_t *entry = __atomic_load_n(&bucket->entries[map_slot(bits)], __ATOMIC_ACQUIRE);
+                    if (entry && entry->key == key) {
+                        if (value) *value = __atomic_load_n(&entry->value, __ATOMIC_ACQUIRE);
+                        found = 0;
+                        goto done;
+                    }
+                }
+            }
+            if (!(meta & META_OVERFLOW)) break;
+        }
+
+        table = moved ? __atomic_load_n(&table->next, __ATOMIC_ACQUIRE) : NULL;
+    }
+
+done:
+    fossil_epoch_exit();
+    return found;
+}
+
+int32_t fossil_concurrent_map_insert(fossil_concurrent_map_t *map, uint64_t key, void *value) {
+    fossil_epoch_enter();
+    fossil_map_table_t *table = map_writer_table(map);
+    map_result_t result = map_apply(map, table, map_hash(key), key, OP_INSERT, &value, NULL);
+    if (result == MAP_ADDED &&
+        (size_t)__atomic_add_fetch(&map->count, 1, __ATOMIC_RELAXED) > table->threshold) {
+        map_start_resize(table);
+    }
+    fossil_epoch_exit();
+    return result == MAP_ADDED ? 0 : -1;
+}
+
+int32_t fossil_concurrent_map_put(fossil_concurrent_map_t *map, uint64_t key, void *value, void **old_value) {
+    fossil_epoch_enter();
+    fossil_map_table_t *table = map_writer_table(map);
+    map_result_t result = map_apply(map, table, map_hash(key), key, OP_PUT, &value, NULL);
+    if (result == MAP_ADDED &&
+        (size_t)__atomic_add_fetch(&map->count, 1, __ATOMIC_RELAXED) > table->threshold) {
+        map_start_resize(table);
+    }
+    fossil_epoch_exit();
+
+    if (old_value) *old_value = result == MAP_FOUND ? value : NULL;
+    return result == MAP_ADDED || result == MAP_FOUND ? 0 : -1;
+}
+
+int32_t fossil_concurrent_map_erase(fossil_concurrent_map_t *map, uint64_t key, void **old_value) {
+    void *value = NULL;
+    fossil_epoch_enter();
+    fossil_map_table_t *table = map_writer_table(map);
+    map_result_t result = map_apply(map, table, map_hash(key), key, OP_ERASE, &value, NULL);
+    if (result == MAP_FOUND) __atomic_sub_fetch(&map->count, 1, __ATOMIC_RELAXED);
+    fossil_epoch_exit();
+
+    if (old_value) *old_value = value;
+    return result == MAP_FOUND ? 0 : -1;
+}
+
+size_t fossil_concurrent_map_size(fossil_concurrent_map_t *map) {
+    int64_t count = __atomic_load_n(&map->count, __ATOMIC_RELAXED);
+    return count > 0 ? (size_t)count : 0;
+}
+
+int32_t fossil_concurrent_map_destroy(fossil_concurrent_map_t *map) {
+    fossil_map_table_t *table = map->table;
+    while (table) {
+        // Entries of moved buckets also live in a newer table.
+        for (size_t i = 0; i < table->num_buckets; i++) {
+            map_bucket_t *bucket = &table->buckets[i];
+            if (bucket->meta & META_MOVED) continue;
+            for (uint32_t slot = 0; slot < MAP_SLOTS; slot++) {
+                if (bucket->entries[slot]) entry_free(bucket->entries[slot]);
+            }
+        }
+        fossil_map_table_t *next = table->next;
+        table_free(table);
+        table = next;
+    }
+    map->table = NULL;
+    map->count = 0;
+    return 0;
+}
@@ -0,0 +1,338 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/pipeline.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* -------- Pipeline -------- */
+
+/*
+ * Each item travels through the stages inside a token, and one pool task
+ * carries a token as far as it can. A serial stage that is busy, or an
+ * in-order stage still waiting for an earlier item, parks the token; the
+ * task that leaves the stage hands it straight to the next parked token,
+ * which is resubmitted already owning the stage.
+ *
+ * The first stage is guarded by input_busy. As soon as it has produced an
+ * item, the next input task is started if a token is free, so reading
+ * overlaps with the rest of the pipeline. Dropped items keep their token
+ * through the in-order stages so that later items are not held back.
+ *
+ * In-order stages park tokens in a ring indexed by sequence number. The
+ * tokens between a stage's next expected item and any parked one are all
+ * still in flight, so they always fit in max_tokens slots.
+ */
+
+#define PIPELINE_MIN_STAGES 4
+
+struct fossil_pipeline_filter_t {
+    FOSSIL_CACHE_ALIGNED fossil_mutex_t mutex;
+    fossil_pipeline_mode_t mode;
+    fossil_pipeline_stage_t stage;
+    void *context;
+    int32_t busy;
+    uint64_t next_seq;
+    fossil_pipeline_token_t **parked;
+    fossil_pipeline_token_t *head;
+    fossil_pipeline_token_t *tail;
+};
+
+struct fossil_pipeline_token_t {
+    void *item;
+    uint64_t seq;
+    uint32_t stage;
+    int32_t acquired; // The stage was handed over by its previous owner.
+    fossil_pipeline_token_t *next;
+};
+
+typedef struct {
+    fossil_pipeline_t *pipeline;
+    fossil_pipeline_token_t *token;
+} pipeline_dispatch_t;
+
+static void pipeline_dispatch(fossil_pipeline_t *pipeline, fossil_pipeline_token_t *token);
+
+// Caller holds pipeline->mutex.
+static fossil_pipeline_token_t *pipeline_take_input(fossil_pipeline_t *pipeline) {
+    if (pipeline->input_done || pipeline->input_busy || pipeline->in_flight >= pipeline->max_tokens) {
+        return NULL;
+    }
+    fossil_pipeline_token_t *token = pipeline->free_tokens;
+    pipeline->free_tokens = token->next;
+    pipeline->input_busy = 1;
+    pipeline->in_flight++;
+
+    token->item = NULL;
+    token->stage = 0;
+    token->acquired = 0;
+    token->next = NULL;
+    return token;
+}
+
+// Runs once per run, on whichever thread retires the last token. The
+// runner may return as soon as finished is set.
+static void pipeline_complete(fossil_pipeline_t *pipeline) {
+    __atomic_store_n(&pipeline->completed, 1, __ATOMIC_RELEASE);
+    fossil_eventcount_notify(&pipeline->done);
+    __atomic_store_n(&pipeline->finished, 1, __ATOMIC_RELEASE);
+}
+
+static void pipeline_retire(fossil_pipeline_t *pipeline, fossil_pipeline_token_t *token, int32_t end_of_input) {
+    fossil_mutex_lock(&pipeline->mutex);
+    if (end_of_input) {
+        pipeline->input_done = 1;
+        pipeline->input_busy = 0;
+    }
+    token->next = pipeline->free_tokens;
+    pipeline->free_tokens = token;
+    pipeline->in_flight--;
+    fossil_pipeline_token_t *input = pipeline_take_input(pipeline);
+    int32_t complete = pipeline->input_done && pipeline->in_flight == 0;
+    fossil_mutex_unlock(&pipeline->mutex);
+
+    if (input) pipeline_dispatch(pipeline, input);
+    if (complete) pipeline_complete(pipeline);
+}
+
+// Returns 1 when the token owns a serial stage, 0 when it was parked.
+static int32_t filter_enter(fossil_pipeline_t *pipeline, fossil_pipeline_filter_t *filter,
+                            fossil_pipeline_token_t *token) {
+    if (token->acquired) {
+        token->acquired = 0;
+        return 1;
+    }
+
+    int32_t owned = 0;
+    fossil_mutex_lock(&filter->mutex);
+    if (filter->mode == FOSSIL_PIPELINE_SERIAL_IN_ORDER) {
+        if (!filter->busy && token->seq == filter->next_seq) {
+            filter->busy = 1;
+            owned = 1;
+        } else {
+            filter->parked[token->seq % pipeline->max_tokens] = token;
+        }
+    } else if (!filter->busy) {
+        filter->busy = 1;
+        owned = 1;
+    } else {
+        token->next = NULL;
+        if (filter->tail) {
+            filter->tail->next = token;
+        } else {
+            filter->head = token;
+        }
+        filter->tail = token;
+    }
+    fossil_mutex_unlock(&filter->mutex);
+    return owned;
+}
+
+// Releases a serial stage, or passes it to the token that is due next.
+static void filter_leave(fossil_pipeline_t *pipeline, fossil_pipeline_filter_t *filter) {
+    fossil_pipeline_token_t *next = NULL;
+
+    fossil_mutex_lock(&filter->mutex);
+    if (filter->mode == FOSSIL_PIPELINE_SERIAL_IN_ORDER) {
+        uint64_t seq = ++filter->next_seq;
+        fossil_pipeline_token_t **slot = &filter->parked[seq % pipeline->max_tokens];
+        if (*slot && (*slot)->seq == seq) {
+            next = *slot;
+            *slot = NULL;
+        }
+    } else if (filter->head) {
+        next = filter->head;
+        filter->head = next->next;
+        if (!filter->head) filter->tail = NULL;
+    }
+    if (!next) filter->busy = 0;
+    fossil_mutex_unlock(&filter->mutex);
+
+    if (next) {
+        next->acquired = 1;
+        pipeline_dispatch(pipeline, next);
+    }
+}
+
+static void pipeline_token_run(fossil_pipeline_t *pipeline, fossil_pipeline_token_t *token) {
+    if (token->stage == 0) {
+        fossil_pipeline_filter_t *input = pipeline->stages[0];
+        void *item = input->stage(NULL, input->context);
+        if (!item) {
+            pipeline_retire(pipeline, token, 1);
+            return;
+        }
+
+        fossil_mutex_lock(&pipeline->mutex);
+        token->item = item;
+        token->seq = pipeline->next_seq++;
+        pipeline->input_busy = 0;
+        fossil_pipeline_token_t *next = pipeline_take_input(pipeline);
+        fossil_mutex_unlock(&pipeline->mutex);
+
+        if (next) pipeline_dispatch(pipeline, next);
+        token->stage = 1;
+    }
+
+    for (; token->stage < pipeline->num_stages; token->stage++) {
+        fossil_pipeline_filter_t *filter = pipeline->stages[token->stage];
+        if (filter->mode == FOSSIL_PIPELINE_PARALLEL) {
+            if (token->item) token->item = filter->stage(token->item, filter->context);
+            continue;
+        }
+        if (filter->mode == FOSSIL_PIPELINE_SERIAL_OUT_OF_ORDER && !token->item) continue;
+
+        if (!filter_enter(pipeline, filter, token)) return;
+        if (token->item) token->item = filter->stage(token->item, filter->context);
+        filter_leave(pipeline, filter);
+    }
+
+    pipeline_retire(pipeline, token, 0);
+}
+
+static void pipeline_invoke(void *storage, int32_t run) {
+    if (!run) return;
+    pipeline_dispatch_t *dispatch = (pipeline_dispatch_t *)storage;
+    pipeline_token_run(dispatch->pipeline, dispatch->token);
+}
+
+static void pipeline_dispatch(fossil_pipeline_t *pipeline, fossil_pipeline_token_t *token) {
+    pipeline_dispatch_t dispatch = { pipeline, token };
+    if (fossil_thread_pool_submit_owned(pipeline->pool, pipeline_invoke, &dispatch, sizeof(dispatch)) != 0) {
+        pipeline_token_run(pipeline, token);
+    }
+}
+
+int32_t fossil_pipeline_create(fossil_pipeline_t *pipeline, fossil_thread_pool_t *pool, uint32_t max_tokens) {
+    if (!pipeline || !pool) return -1;
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->pool = pool;
+    // The pool's size, not its started workers: a lazy pool may have none yet.
+    uint32_t workers = __atomic_load_n(&pool->spare_capacity, __ATOMIC_ACQUIRE);
+    pipeline->max_tokens = max_tokens ? max_tokens : 2 * (workers ? workers : 1);
+
+    pipeline->tokens = (fossil_pipeline_token_t *)calloc(pipeline->max_tokens, sizeof(fossil_pipeline_token_t));
+    if (!pipeline->tokens) return -1;
+
+    if (fossil_mutex_create(&pipeline->mutex) != 0) {
+        free(pipeline->tokens);
+        return -1;
+    }
+    fossil_eventcount_create(&pipeline->done);
+    return 0;
+}
+
+int32_t fossil_pipeline_add_stage(fossil_pipeline_t *pipeline, fossil_pipeline_mode_t mode,
+                                  fossil_pipeline_stage_t stage, void *context) {
+    if (!pipeline || !stage || __atomic_load_n(&pipeline->running, __ATOMIC_ACQUIRE)) return -1;
+
+    if (pipeline->num_stages == pipeline->stage_capacity) {
+        uint32_t capacity = pipeline->stage_capacity ? pipeline->stage_capacity * 2 : PIPELINE_MIN_STAGES;
+        fossil_pipeline_filter_t **stages = (fossil_pipeline_filter_t **)realloc(
+            pipeline->stages, capacity * sizeof(fossil_pipeline_filter_t *));
+        if (!stages) return -1;
+        pipeline->stages = stages;
+        pipeline->stage_capacity = capacity;
+    }
+
+    fossil_pipeline_filter_t *filter = (fossil_pipeline_filter_t *)fossil_platform_aligned_alloc(
+        FOSSIL_CACHE_LINE, sizeof(fossil_pipeline_filter_t));
+    if (!filter) return -1;
+    memset(filter, 0, sizeof(*filter));
+
+    // The input stage is serialized by the pipeline itself.
+    filter->mode = pipeline->num_stages == 0 ? FOSSIL_PIPELINE_SERIAL_OUT_OF_ORDER : mode;
+    filter->stage = stage;
+    filter->context = context;
+
+    if (filter->mode == FOSSIL_PIPELINE_SERIAL_IN_ORDER) {
+        filter->parked = (fossil_pipeline_token_t **)calloc(pipeline->max_tokens, sizeof(fossil_pipeline_token_t *));
+        if (!filter->parked) {
+            fossil_platform_aligned_free(filter);
+            return -1;
+        }
+    }
+    if (filter->mode != FOSSIL_PIPELINE_PARALLEL && fossil_mutex_create(&filter->mutex) != 0) {
+        free(filter->parked);
+        fossil_platform_aligned_free(filter);
+        return -1;
+    }
+
+    pipeline->stages[pipeline->num_stages++] = filter;
+    return 0;
+}
+
+int32_t fossil_pipeline_run(fossil_pipeline_t *pipeline) {
+    if (!pipeline || pipeline->num_stages == 0) return -1;
+    int32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&pipeline->running, &expected, 1, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < pipeline->num_stages; i++) {
+        pipeline->stages[i]->busy = 0;
+        pipeline->stages[i]->next_seq = 0;
+    }
+    pipeline->free_tokens = NULL;
+    for (uint32_t i = 0; i < pipeline->max_tokens; i++) {
+        pipeline->tokens[i].next = pipeline->free_tokens;
+        pipeline->free_tokens = &pipeline->tokens[i];
+    }
+    pipeline->in_flight = 0;
+    pipeline->next_seq = 0;
+    pipeline->input_busy = 0;
+    pipeline->input_done = 0;
+    pipeline->completed = 0;
+    pipeline->finished = 0;
+
+    fossil_mutex_lock(&pipeline->mutex);
+    fossil_pipeline_token_t *token = pipeline_take_input(pipeline);
+    fossil_mutex_unlock(&pipeline->mutex);
+    pipeline_dispatch(pipeline, token);
+
+    while (!__atomic_load_n(&pipeline->completed, __ATOMIC_ACQUIRE)) {
+        uint32_t key = fossil_eventcount_prepare_wait(&pipeline->done);
+        if (__atomic_load_n(&pipeline->completed, __ATOMIC_ACQUIRE)) {
+            fossil_eventcount_cancel_wait(&pipeline->done);
+            break;
+        }
+        fossil_eventcount_wait(&pipeline->done, key);
+    }
+    // The last task may still be inside notify; wait until it lets go.
+    while (!__atomic_load_n(&pipeline->finished, __ATOMIC_ACQUIRE)) {
+        fossil_platform_yield();
+    }
+
+    __atomic_store_n(&pipeline->running, 0, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int32_t fossil_pipeline_destroy(fossil_pipeline_t *pipeline) {
+    if (!pipeline || __atomic_load_n(&pipeline->running, __ATOMIC_ACQUIRE)) return -1;
+
+    for (uint32_t i = 0; i < pipeline->num_stages; i++) {
+        fossil_pipeline_filter_t *filter = pipeline->stages[i];
+        if (filter->mode != FOSSIL_PIPELINE_PARALLEL) fossil_mutex_destroy(&filter->mutex);
+        free(filter->parked);
+        fossil_platform_aligned_free(filter);
+    }
+    free(pipeline->stages);
+    free(pipeline->tokens);
+    fossil_mutex_destroy(&pipeline->mutex);
+    pipeline->stages = NULL;
+    pipeline->tokens = NULL;
+    pipeline->num_stages = 0;
+    return fossil_eventcount_destroy(&pipeline->done);
+}
@@ -0,0 +1,167 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "platform.h"
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#elif !defined(_WIN32)
+#include <pthread.h>
+#include <errno.h>
+#endif
+
+/* -------- Address Wait/Wake Implementation -------- */
+
+#if defined(__linux__)
+int32_t fossil_platform_futex_wait(uint32_t *addr, uint32_t expected, uint64_t timeout_ns) {
+    struct timespec ts, *tsp = NULL;
+    if (timeout_ns != FOSSIL_PLATFORM_INFINITE) {
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+        tsp = &ts;
+    }
+    long rc = syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, tsp, NULL, 0);
+    return (rc == -1 && errno == ETIMEDOUT) ? -1 : 0;
+}
+
+void fossil_platform_futex_wake(uint32_t *addr, uint32_t count) {
+    if (count > INT32_MAX) count = INT32_MAX;
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, (int)count, NULL, NULL, 0);
+}
+#elif defined(_WIN32)
+int32_t fossil_platform_futex_wait(uint32_t *addr, uint32_t expected, uint64_t timeout_ns) {
+    DWORD ms = timeout_ns == FOSSIL_PLATFORM_INFINITE ? INFINITE : (DWORD)(timeout_ns / 1000000ull);
+    if (WaitOnAddress(addr, &expected, sizeof(expected), ms)) return 0;
+    return GetLastError() == ERROR_TIMEOUT ? -1 : 0;
+}
+
+void fossil_platform_futex_wake(uint32_t *addr, uint32_t count) {
+    if (count == 1) {
+        WakeByAddressSingle(addr);
+    } else {
+        WakeByAddressAll(addr);
+    }
+}
+#else
+/*
+ * No native address wait on this platform: hash the address onto a small
+ * table of mutex/condition pairs. Wakers broadcast the whole bucket, which is
+ * correct because waiters always re-check their condition.
+ */
+#define PARKING_BUCKETS 64
+
+static struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} parking_lot[PARKING_BUCKETS];
+static pthread_once_t parking_once = PTHREAD_ONCE_INIT;
+
+static void parking_init(void) {
+    for (int i = 0; i < PARKING_BUCKETS; i++) {
+        pthread_mutex_init(&parking_lot[i].mutex, NULL);
+        pthread_cond_init(&parking_lot[i].cond, NULL);
+    }
+}
+
+static size_t parking_index(const void *addr) {
+    uintptr_t key = (uintptr_t)addr;
+    return (size_t)((key >> 4) ^ (key >> 12)) % PARKING_BUCKETS;
+}
+
+int32_t fossil_platform_futex_wait(uint32_t *addr, uint32_t expected, uint64_t timeout_ns) {
+    pthread_once(&parking_once, parking_init);
+    size_t i = parking_index(addr);
+    int32_t result = 0;
+
+    pthread_mutex_lock(&parking_lot[i].mutex);
+    if (__atomic_load_n(addr, __ATOMIC_ACQUIRE) == expected) {
+        if (timeout_ns == FOSSIL_PLATFORM_INFINITE) {
+            pthread_cond_wait(&parking_lot[i].cond, &parking_lot[i].mutex);
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            uint64_t deadline = (uint64_t)ts.tv_nsec + timeout_ns;
+            ts.tv_sec += (time_t)(deadline / 1000000000ull);
+            ts.tv_nsec = (long)(deadline % 1000000000ull);
+            if (pthread_cond_timedwait(&parking_lot[i].cond, &parking_lot[i].mutex, &ts) == ETIMEDOUT) {
+                result = -1;
+            }
+        }
+    }
+    pthread_mutex_unlock(&parking_lot[i].mutex);
+    return result;
+}
+
+void fossil_platform_futex_wake(uint32_t *addr, uint32_t count) {
+    (void)count;
+    pthread_once(&parking_once, parking_init);
+    size_t i = parking_index(addr);
+    pthread_mutex_lock(&parking_lot[i].mutex);
+    pthread_cond_broadcast(&parking_lot[i].cond);
+    pthread_mutex_unlock(&parking_lot[i].mutex);
+}
+#endif
+
+/* -------- Process-Wide Barrier -------- */
+
+#if defined(__linux__) && defined(SYS_membarrier)
+int32_t fossil_platform_membarrier_init(void) {
+    long mask = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    if (mask < 0 || !(mask & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) return -1;
+    return syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0 ? 0 : -1;
+}
+
+void fossil_platform_membarrier(void) {
+    syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+}
+#elif defined(_WIN32)
+int32_t fossil_platform_membarrier_init(void) {
+    return 0;
+}
+
+void fossil_platform_membarrier(void) {
+    FlushProcessWriteBuffers();
+}
+#else
+int32_t fossil_platform_membarrier_init(void) {
+    return -1;
+}
+
+void fossil_platform_membarrier(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+#endif
+
+/* -------- Aligned Allocation -------- */
+
+void *fossil_platform_aligned_alloc(size_t alignment, size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void *ptr = NULL;
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+#endif
+}
+
+void fossil_platform_aligned_free(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
@@ -0,0 +1,180 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_PLATFORM_H
+#define FOSSIL_THREADS_PLATFORM_H
+
+/*
+ * Private helpers shared by the library sources. Nothing in here is part of
+ * the public API and this header is not installed.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 35))
+#include <sys/rseq.h>
+#define FOSSIL_PLATFORM_RSEQ 1
+#endif
+
+#define FOSSIL_CACHE_LINE 64
+#define FOSSIL_CACHE_ALIGNED _Alignas(FOSSIL_CACHE_LINE)
+#define FOSSIL_PLATFORM_INFINITE UINT64_MAX
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FOSSIL_THREAD_LOCAL __declspec(thread)
+#define FOSSIL_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define FOSSIL_THREAD_LOCAL _Thread_local
+#define FOSSIL_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+/* Tracing hooks compile to nothing unless built with the with_trace option,
+ * and cost a single relaxed load while tracing is stopped. */
+#ifdef FOSSIL_THREADS_TRACE
+#include "fossil/threads/trace.h"
+extern uint32_t fossil_trace_active;
+#define FOSSIL_TRACE_EVENT(kind, id, aux) \
+    do { \
+        if (__atomic_load_n(&fossil_trace_active, __ATOMIC_RELAXED)) \
+            fossil_trace_record((kind), (id), (uint64_t)(aux)); \
+    } while (0)
+#else
+#define FOSSIL_TRACE_EVENT(kind, id, aux) ((void)0)
+#endif
+
+/* Hint to the core that we are busy-waiting. */
+static inline void fossil_platform_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(_WIN32)
+    YieldProcessor();
+#endif
+}
+
+/* Give up the rest of the time slice. */
+static inline void fossil_platform_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/* Monotonic clock in nanoseconds. */
+static inline uint64_t fossil_platform_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Number of online CPUs, at least 1. */
+static inline uint32_t fossil_platform_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1;
+#endif
+}
+
+/* CPU the caller is running on, or -1 if unknown. Only a hint: the thread
+ * may migrate right after. With glibc's rseq registration this is a plain
+ * load from the thread's rseq area. */
+static inline int32_t fossil_platform_current_cpu(void) {
+#if defined(FOSSIL_PLATFORM_RSEQ)
+    if (__rseq_size > 0) {
+        const struct rseq *rs = (const struct rseq *)((char *)__builtin_thread_pointer() + __rseq_offset);
+        int32_t cpu = (int32_t)__atomic_load_n(&rs->cpu_id, __ATOMIC_RELAXED);
+        if (cpu >= 0) return cpu;
+    }
+    return -1;
+#elif defined(_WIN32)
+    return (int32_t)GetCurrentProcessorNumber();
+#else
+    return -1;
+#endif
+}
+
+/* Run init exactly once per state word; concurrent callers wait for it. */
+static inline void fossil_platform_once(uint32_t *state, void (*init)(void)) {
+    if (__atomic_load_n(state, __ATOMIC_ACQUIRE) == 2) return;
+
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(state, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        init();
+        __atomic_store_n(state, 2, __ATOMIC_RELEASE);
+        return;
+    }
+    while (__atomic_load_n(state, __ATOMIC_ACQUIRE) != 2) {
+        fossil_platform_yield();
+    }
+}
+
+/** Block while *addr == expected, for at most timeout_ns nanoseconds.
+ *  Spurious wakeups are allowed; callers must re-check their condition.
+ *  @return 0 when woken (or the value already differed), -1 on timeout.
+ */
+int32_t fossil_platform_futex_wait(uint32_t *addr, uint32_t expected, uint64_t timeout_ns);
+
+/** Wake up to count threads blocked on addr. */
+void fossil_platform_futex_wake(uint32_t *addr, uint32_t count);
+
+/** Prepare fossil_platform_membarrier for use by this process.
+ *  @return 0 if it is available, -1 if callers must fence on their own.
+ */
+int32_t fossil_platform_membarrier_init(void);
+
+/** Execute a full memory barrier on every running thread of the process,
+ *  so that their plain loads and stores are ordered against the caller's. */
+void fossil_platform_membarrier(void);
+
+/** Allocate size bytes aligned to alignment (a power of two). */
+void *fossil_platform_aligned_alloc(size_t alignment, size_t size);
+
+/** Release memory obtained from fossil_platform_aligned_alloc. */
+void fossil_platform_aligned_free(void *ptr);
+
+/* Library-internal submit for graph and pipeline dispatches: like
+ * fossil_thread_pool_submit_inline, but DROP_OLDEST never discards the task,
+ * since its owner waits for it. */
+struct fossil_thread_pool_t;
+int32_t fossil_thread_pool_submit_owned(struct fossil_thread_pool_t *pool, void (*invoke)(void *storage, int32_t run),
+                                        const void *data, size_t size);
+
+/* Whether the calling thread is RCU online, so that a blocking region only
+ * brings back online a worker it took offline. */
+uint32_t fossil_rcu_thread_is_online(void);
+
+#endif /* FOSSIL_THREADS_PLATFORM_H */
@@ -12,108 +12,1279 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/threads/pool.h"
+#include "fossil/threads/epoch.h"
+#include "fossil/threads/rcu.h"
+#include "platform.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Task-based Concurrency (Thread Pool) */
 
-static void *worker_thread(void *arg) {
-    fossil_thread_pool_t *pool = (fossil_thread_pool_t *)arg;
+#define DEQUE_INITIAL_SIZE 256
 
-    while (1) {
-        fossil_mutex_lock(&pool->mutex);
+// Ring buffer of a worker's deque. Rings replaced by a larger one stay on
+// the prev chain until the pool is destroyed, since a thief may still read.
+typedef struct deque_ring_t {
+    int64_t size;
+    struct deque_ring_t *prev;
+    task_queue_t *slots[];
+} deque_ring_t;
+
+struct fossil_thread_pool_worker_t {
+    FOSSIL_CACHE_ALIGNED fossil_eventcount_t idle;
+    uint32_t parked;
+    uint32_t index;
+    uint32_t steal_seed;
+    fossil_thread_pool_t *pool;
+    fossil_arena_t scratch;
+    fossil_cancel_token_t *cancel; // Token of the running task.
+    uint32_t in_task;
+    uint32_t blocking;      // Nesting depth of blocking regions.
+    uint32_t rcu_online;    // Online when the outermost blocking region began.
+    uint64_t task_start;    // Start of the running task while the watchdog is on.
+    uint64_t flagged_start; // Watchdog only: last task start reported.
+
+    // Chase-Lev deque of tasks submitted by this worker: the owner pushes and
+    // pops at the bottom, other workers steal from the top.
+    FOSSIL_CACHE_ALIGNED int64_t top;
+    FOSSIL_CACHE_ALIGNED int64_t bottom;
+    deque_ring_t *ring;
+
+    // FIFO of keyed tasks routed to this worker. Thieves take from it only
+    // past the pool's affinity_steal threshold.
+    FOSSIL_CACHE_ALIGNED fossil_mutex_t inbox_mutex;
+    uint32_t inbox_count;
+    task_queue_t *inbox_head;
+    task_queue_t *inbox_tail;
+#ifdef FOSSIL_THREADS_STATS
+    // Written only by the owning worker, read relaxed by snapshots.
+    FOSSIL_CACHE_ALIGNED fossil_thread_pool_worker_stats_t stats;
+    uint64_t wait_histogram[FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS];
+    uint64_t exec_histogram[FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS];
+#endif
+};
+
+static FOSSIL_THREAD_LOCAL fossil_thread_pool_worker_t *current_worker = NULL;
+
+static void *worker_thread(void *arg);
+
+// Function identifying a task in trace events.
+#define TASK_ENTRY(task) ((task)->invoke ? (uintptr_t)(task)->invoke : (uintptr_t)(task)->task_func)
+
+#ifdef FOSSIL_THREADS_STATS
+static inline int32_t stats_on(fossil_thread_pool_t *pool) {
+    return __atomic_load_n(&pool->stats_enabled, __ATOMIC_RELAXED) != 0;
+}
 
-        while (pool->head == NULL && !pool->shutdown) {
-            fossil_cond_wait(&pool->cond, &pool->mutex);
+// Single writer: a relaxed load/store pair is enough and avoids a locked op.
+static inline void stats_add(uint64_t *counter, uint64_t value) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t stats_bucket(uint64_t ns) {
+    uint32_t bucket = ns ? 64 - (uint32_t)__builtin_clzll(ns) : 0;
+    return bucket < FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS ? bucket : FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS - 1;
+}
+#endif
+
+static deque_ring_t *deque_ring_create(int64_t size, deque_ring_t *prev) {
+    deque_ring_t *ring = (deque_ring_t *)malloc(sizeof(deque_ring_t) + (size_t)size * sizeof(task_queue_t *));
+    if (ring) {
+        ring->size = size;
+        ring->prev = prev;
+    }
+    return ring;
+}
+
+static int32_t deque_push(fossil_thread_pool_worker_t *worker, task_queue_t *task) {
+    int64_t bottom = __atomic_load_n(&worker->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&worker->top, __ATOMIC_ACQUIRE);
+    deque_ring_t *ring = __atomic_load_n(&worker->ring, __ATOMIC_RELAXED);
+
+    if (bottom - top >= ring->size) {
+        deque_ring_t *grown = deque_ring_create(ring->size * 2, ring);
+        if (!grown) return -1;
+        for (int64_t i = top; i < bottom; i++) {
+            grown->slots[i & (grown->size - 1)] = __atomic_load_n(&ring->slots[i & (ring->size - 1)], __ATOMIC_RELAXED);
         }
+        __atomic_store_n(&worker->ring, grown, __ATOMIC_RELEASE);
+        ring = grown;
+    }
 
-        if (pool->shutdown) {
-            fossil_mutex_unlock(&pool->mutex);
-            break;
+    __atomic_store_n(&ring->slots[bottom & (ring->size - 1)], task, __ATOMIC_RELAXED);
+    __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static task_queue_t *deque_pop(fossil_thread_pool_worker_t *worker) {
+    int64_t bottom = __atomic_load_n(&worker->bottom, __ATOMIC_RELAXED) - 1;
+    deque_ring_t *ring = __atomic_load_n(&worker->ring, __ATOMIC_RELAXED);
+    __atomic_store_n(&worker->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t top = __atomic_load_n(&worker->top, __ATOMIC_RELAXED);
+
+    task_queue_t *task = NULL;
+    if (top <= bottom) {
+        task = __atomic_load_n(&ring->slots[bottom & (ring->size - 1)], __ATOMIC_RELAXED);
+        if (top == bottom) {
+            // Last task: race the thieves for it.
+            if (!__atomic_compare_exchange_n(&worker->top, &top, top + 1, 0,
+                                             __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                task = NULL;
+            }
+            __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELAXED);
         }
+    } else {
+        __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return task;
+}
+
+static task_queue_t *deque_steal(fossil_thread_pool_worker_t *victim) {
+    int64_t top = __atomic_load_n(&victim->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t bottom = __atomic_load_n(&victim->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom) return NULL;
+
+    deque_ring_t *ring = __atomic_load_n(&victim->ring, __ATOMIC_ACQUIRE);
+    task_queue_t *task = __atomic_load_n(&ring->slots[top & (ring->size - 1)], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&victim->top, &top, top + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    return task;
+}
+
+static task_queue_t *pool_take(fossil_thread_pool_t *pool) {
+    if (__atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE) == 0) return NULL;
 
-        task_queue_t *task = pool->head;
+    fossil_mutex_lock(&pool->mutex);
+    task_queue_t *task = pool->head;
+    if (task) {
         pool->head = task->next;
         if (pool->head == NULL) {
             pool->tail = NULL;
         }
+        __atomic_fetch_sub(&pool->queued, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&pool->pending, 1, __ATOMIC_RELAXED);
+        if (pool->blocked) fossil_cond_signal(&pool->not_full);
+    }
+    fossil_mutex_unlock(&pool->mutex);
 
-        fossil_mutex_unlock(&pool->mutex);
+    if (task) FOSSIL_TRACE_EVENT(FOSSIL_TRACE_DEQUEUE, task, 0);
+
+    return task;
+}
+
+// Take the oldest keyed task; a thief never takes a pinned one.
+static task_queue_t *inbox_take(fossil_thread_pool_worker_t *worker, int32_t thief) {
+    if (__atomic_load_n(&worker->inbox_count, __ATOMIC_ACQUIRE) == 0) return NULL;
+
+    fossil_mutex_lock(&worker->inbox_mutex);
+    task_queue_t *task = worker->inbox_head;
+    if (task && thief && task->pinned) task = NULL;
+    if (task) {
+        worker->inbox_head = task->next;
+        if (worker->inbox_head == NULL) {
+            worker->inbox_tail = NULL;
+        }
+        __atomic_fetch_sub(&worker->inbox_count, 1, __ATOMIC_RELAXED);
+    }
+    fossil_mutex_unlock(&worker->inbox_mutex);
 
+    if (task) FOSSIL_TRACE_EVENT(FOSSIL_TRACE_DEQUEUE, task, 0);
+
+    return task;
+}
+
+// Try every other worker's deque once, starting at a random victim, and the
+// keyed FIFOs of those that are overloaded.
+static task_queue_t *pool_steal(fossil_thread_pool_worker_t *worker) {
+    fossil_thread_pool_t *pool = worker->pool;
+    uint32_t count = __atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE);
+    if (count < 2) return NULL;
+    uint32_t threshold = __atomic_load_n(&pool->affinity_steal, __ATOMIC_RELAXED);
+
+    worker->steal_seed ^= worker->steal_seed << 13;
+    worker->steal_seed ^= worker->steal_seed >> 17;
+    worker->steal_seed ^= worker->steal_seed << 5;
+    uint32_t start = worker->steal_seed % count;
+
+    for (uint32_t i = 0; i < count; i++) {
+        fossil_thread_pool_worker_t *victim = &pool->workers[(start + i) % count];
+        if (victim == worker) continue;
+
+        task_queue_t *task = deque_steal(victim);
+        if (task) {
+            __atomic_fetch_sub(&pool->pending, 1, __ATOMIC_RELAXED);
+        } else if (threshold && __atomic_load_n(&victim->inbox_count, __ATOMIC_RELAXED) > threshold) {
+            task = inbox_take(victim, 1);
+        }
+        if (task) {
+#ifdef FOSSIL_THREADS_STATS
+            if (stats_on(pool)) stats_add(&worker->stats.stolen, 1);
+#endif
+            FOSSIL_TRACE_EVENT(FOSSIL_TRACE_STEAL, task, victim->index);
+            return task;
+        }
+    }
+    return NULL;
+}
+
+// Own deque first (newest first, while its data is still in cache), then
+// the tasks keyed to this worker, then the shared queue, then other workers.
+static task_queue_t *pool_next(fossil_thread_pool_worker_t *worker) {
+    task_queue_t *task = deque_pop(worker);
+    if (task) {
+        __atomic_fetch_sub(&worker->pool->pending, 1, __ATOMIC_RELAXED);
+        FOSSIL_TRACE_EVENT(FOSSIL_TRACE_DEQUEUE, task, 0);
+        return task;
+    }
+    task = inbox_take(worker, 0);
+    if (task) return task;
+    task = pool_take(worker->pool);
+    if (task) return task;
+    return pool_steal(worker);
+}
+
+static inline int32_t pool_is_core(const fossil_thread_pool_worker_t *worker) {
+    return worker->index < worker->pool->spare_capacity;
+}
+
+// Spares outlive the regular workers, which may still block while draining.
+static inline int32_t pool_exiting(fossil_thread_pool_worker_t *worker) {
+    fossil_thread_pool_t *pool = worker->pool;
+    return __atomic_load_n(pool_is_core(worker) ? &pool->shutdown : &pool->spare_exit, __ATOMIC_SEQ_CST) != 0;
+}
+
+static int32_t pool_has_work(fossil_thread_pool_worker_t *worker) {
+    fossil_thread_pool_t *pool = worker->pool;
+    return __atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST) != 0 ||
+           __atomic_load_n(&worker->inbox_count, __ATOMIC_SEQ_CST) != 0 ||
+           pool_exiting(worker);
+}
+
+// Claim a parked worker so that no other submitter wakes it a second time.
+static int32_t pool_unpark(fossil_thread_pool_worker_t *worker) {
+    uint32_t expected = 1;
+    if (!__atomic_compare_exchange_n(&worker->parked, &expected, 0, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+    if (pool_is_core(worker)) __atomic_fetch_sub(&worker->pool->num_idle, 1, __ATOMIC_SEQ_CST);
+    return 1;
+}
+
+// Spare k may run while more than k workers are blocked.
+static inline int32_t pool_spare_allowed(fossil_thread_pool_worker_t *worker) {
+    fossil_thread_pool_t *pool = worker->pool;
+    if (pool_is_core(worker)) return 1;
+    uint32_t k = worker->index - pool->spare_capacity;
+    return k < __atomic_load_n(&pool->blocked_workers, __ATOMIC_SEQ_CST) &&
+           k < __atomic_load_n(&pool->max_spares, __ATOMIC_RELAXED);
+}
+
+// Start the next regular worker of a pool created with fewer running. One
+// thread spawns at a time, and no regular worker starts once the pool is
+// shutting down, so that destroy joins every one of them.
+// @return 0 if a worker was started or another thread is starting one.
+static int32_t pool_grow(fossil_thread_pool_t *pool) {
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&pool->spawning, &expected, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return expected == 1 ? 0 : -1;
+    }
+    int32_t result = -1;
+    uint32_t i = __atomic_load_n(&pool->num_threads, __ATOMIC_RELAXED);
+    if (i < pool->spare_capacity && !__atomic_load_n(&pool->shutdown, __ATOMIC_SEQ_CST) &&
+        fossil_thread_create(&pool->threads[i], NULL, worker_thread, &pool->workers[i]) == 0) {
+        __atomic_store_n(&pool->num_threads, i + 1, __ATOMIC_RELEASE);
+        result = 0;
+    }
+    __atomic_store_n(&pool->spawning, 0, __ATOMIC_RELEASE);
+    return result;
+}
+
+// Make sure a pool that starts workers on demand has one to run a task
+// queued from outside; otherwise the task would wait forever.
+// @return -1 if there is no worker and none can be started.
+static int32_t pool_ensure_worker(fossil_thread_pool_t *pool) {
+    while (__atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE) == 0) {
+        if (pool_grow(pool) != 0) return -1;
+        fossil_platform_yield();
+    }
+    return 0;
+}
+
+// Start the next spare. Spares may still be needed while the regular workers
+// drain the queue, so destroy closes spawning for good (spawning == 2) only
+// before it joins the spares.
+static void pool_spawn_spare(fossil_thread_pool_t *pool) {
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&pool->spawning, &expected, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return;
+    }
+    uint32_t k = __atomic_load_n(&pool->num_spares, __ATOMIC_RELAXED);
+    if (k < pool->spare_capacity && k < __atomic_load_n(&pool->blocked_workers, __ATOMIC_SEQ_CST)) {
+        uint32_t index = pool->spare_capacity + k;
+        if (fossil_thread_create(&pool->threads[index], NULL, worker_thread, &pool->workers[index]) == 0) {
+            __atomic_store_n(&pool->num_spares, k + 1, __ATOMIC_RELEASE);
+        }
+    }
+    __atomic_store_n(&pool->spawning, 0, __ATOMIC_RELEASE);
+}
+
+// Let a spare stand in for a blocked worker: wake a parked one, or start one.
+// Must follow the store that raised blocked_workers or made work visible.
+static void pool_compensate(fossil_thread_pool_t *pool) {
+    uint32_t blocked = __atomic_load_n(&pool->blocked_workers, __ATOMIC_SEQ_CST);
+    uint32_t limit = __atomic_load_n(&pool->max_spares, __ATOMIC_RELAXED);
+    if (limit > blocked) limit = blocked;
+
+    uint32_t spares = __atomic_load_n(&pool->num_spares, __ATOMIC_ACQUIRE);
+    for (uint32_t k = 0; k < spares && k < limit; k++) {
+        fossil_thread_pool_worker_t *spare = &pool->workers[pool->spare_capacity + k];
+        if (__atomic_load_n(&spare->parked, __ATOMIC_SEQ_CST) && pool_unpark(spare)) {
+            fossil_eventcount_notify(&spare->idle);
+            return;
+        }
+    }
+    if (spares < limit) pool_spawn_spare(pool);
+}
+
+// Wake exactly one parked worker, if any. Must follow the store that made
+// the new work visible.
+static void pool_wake_one(fossil_thread_pool_t *pool) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->num_idle, __ATOMIC_RELAXED) == 0) {
+        // Every worker is busy: start another one if the pool has not
+        // started them all, or bring in a spare if some are only blocked.
+        if (__atomic_load_n(&pool->num_threads, __ATOMIC_RELAXED) < pool->spare_capacity) {
+            pool_grow(pool);
+        } else if (__atomic_load_n(&pool->blocked_workers, __ATOMIC_RELAXED)) {
+            pool_compensate(pool);
+        }
+        return;
+    }
+
+    uint32_t count = __atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < count; i++) {
+        fossil_thread_pool_worker_t *worker = &pool->workers[i];
+        if (__atomic_load_n(&worker->parked, __ATOMIC_RELAXED) && pool_unpark(worker)) {
+            fossil_eventcount_notify(&worker->idle);
+            return;
+        }
+    }
+}
+
+// Wake a particular worker if it is parked. Must follow the store that made
+// its new work visible.
+static void pool_wake_worker(fossil_thread_pool_worker_t *worker) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&worker->parked, __ATOMIC_RELAXED) && pool_unpark(worker)) {
+        fossil_eventcount_notify(&worker->idle);
+    }
+}
+
+// Spin, then yield, then park until a submitter hands us work.
+static void pool_idle(fossil_thread_pool_worker_t *worker) {
+    fossil_thread_pool_t *pool = worker->pool;
+    uint32_t spins = __atomic_load_n(&pool->spin_count, __ATOMIC_RELAXED);
+    uint32_t yields = __atomic_load_n(&pool->yield_count, __ATOMIC_RELAXED);
+
+    for (uint32_t i = 0; i < spins; i++) {
+        if (pool_has_work(worker)) return;
+        fossil_platform_relax();
+    }
+    for (uint32_t i = 0; i < yields; i++) {
+        if (pool_has_work(worker)) return;
+        fossil_platform_yield();
+    }
+
+    // Nothing to do: settle our reclamation backlog before going to sleep.
+    fossil_epoch_reclaim();
+
+    uint32_t key = fossil_eventcount_prepare_wait(&worker->idle);
+    __atomic_store_n(&worker->parked, 1, __ATOMIC_SEQ_CST);
+    if (pool_is_core(worker)) __atomic_fetch_add(&pool->num_idle, 1, __ATOMIC_SEQ_CST);
+
+    if (pool_has_work(worker)) {
+        pool_unpark(worker);
+        fossil_eventcount_cancel_wait(&worker->idle);
+        return;
+    }
+
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_PARK, worker, worker->index);
+    fossil_eventcount_wait(&worker->idle, key);
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_WAKE, worker, worker->index);
+    pool_unpark(worker);
+}
+
+// Park a spare that is not needed until a blocked worker calls for it.
+static void pool_spare_wait(fossil_thread_pool_worker_t *worker) {
+    uint32_t key = fossil_eventcount_prepare_wait(&worker->idle);
+    __atomic_store_n(&worker->parked, 1, __ATOMIC_SEQ_CST);
+
+    if (pool_spare_allowed(worker) || pool_exiting(worker)) {
+        pool_unpark(worker);
+        fossil_eventcount_cancel_wait(&worker->idle);
+        return;
+    }
+
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_PARK, worker, worker->index);
+    fossil_eventcount_wait(&worker->idle, key);
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_WAKE, worker, worker->index);
+    pool_unpark(worker);
+}
+
+static inline int32_t pool_cancelled(const task_queue_t *task) {
+    return task->cancel && __atomic_load_n(&task->cancel->cancelled, __ATOMIC_ACQUIRE);
+}
+
+// Destroy a task that will never run and free its node.
+static void pool_discard(fossil_thread_pool_t *pool, task_queue_t *task) {
+    if (task->invoke) task->invoke(task->storage.bytes, 0);
+    fossil_slab_free(&pool->task_slab, task);
+}
+
+static inline void pool_call(task_queue_t *task) {
+    if (task->invoke) {
+        task->invoke(task->storage.bytes, 1);
+    } else {
         task->task_func(task->arg);
-        free(task);
+    }
+}
+
+static void pool_run(fossil_thread_pool_worker_t *worker, task_queue_t *task) {
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_START, task, TASK_ENTRY(task));
+#ifdef FOSSIL_THREADS_STATS
+    if (stats_on(worker->pool)) {
+        uint64_t start = fossil_platform_now_ns();
+        if (task->submit_ns && start >= task->submit_ns) {
+            stats_add(&worker->wait_histogram[stats_bucket(start - task->submit_ns)], 1);
+        }
+
+        pool_call(task);
+
+        uint64_t elapsed = fossil_platform_now_ns() - start;
+        stats_add(&worker->exec_histogram[stats_bucket(elapsed)], 1);
+        stats_add(&worker->stats.busy_ns, elapsed);
+        stats_add(&worker->stats.executed, 1);
+        FOSSIL_TRACE_EVENT(FOSSIL_TRACE_END, task, 0);
+        return;
+    }
+#endif
+    (void)worker;
+    pool_call(task);
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_END, task, 0);
+}
+
+static void *worker_thread(void *arg) {
+    fossil_thread_pool_worker_t *worker = (fossil_thread_pool_worker_t *)arg;
+    fossil_thread_pool_t *pool = worker->pool;
+    current_worker = worker;
+    fossil_epoch_register();
+    fossil_rcu_register();
+
+#ifdef FOSSIL_THREADS_TRACE
+    char name[32];
+    snprintf(name, sizeof(name), "pool worker %u", worker->index);
+    fossil_trace_thread_name(name);
+#endif
+
+    while (1) {
+        if (!pool_spare_allowed(worker)) {
+            if (pool_exiting(worker)) break;
+            // A parked spare may not be needed again for a long time.
+            fossil_rcu_thread_offline();
+            pool_spare_wait(worker);
+            continue;
+        }
+
+        // Read before looking for work: whatever was queued before shutdown
+        // is then visible to pool_next, so no task is left behind.
+        int32_t exiting = pool_exiting(worker);
+        task_queue_t *task = pool_next(worker);
+        if (task && pool_cancelled(task)) {
+            __atomic_fetch_add(&pool->cancelled, 1, __ATOMIC_RELAXED);
+            pool_discard(pool, task);
+            continue;
+        }
+        if (task) {
+            // Workers stay online while busy and report a quiescent state
+            // after every task, so read-side sections in tasks are free.
+            fossil_rcu_thread_online();
+            worker->cancel = task->cancel;
+            worker->in_task = 1;
+            int32_t watched = __atomic_load_n(&pool->watchdog_ns, __ATOMIC_RELAXED) != 0;
+            if (watched) __atomic_store_n(&worker->task_start, fossil_platform_now_ns(), __ATOMIC_RELAXED);
+            pool_run(worker, task);
+            if (watched) __atomic_store_n(&worker->task_start, 0, __ATOMIC_RELAXED);
+            worker->in_task = 0;
+            worker->cancel = NULL;
+            fossil_rcu_quiescent_state();
+            fossil_slab_free(&pool->task_slab, task);
+            if (worker->scratch.first) fossil_arena_reset(&worker->scratch);
+            continue;
+        }
+
+        if (exiting) {
+            break;
+        }
+
+        // An idle worker must never hold up a grace period.
+        fossil_rcu_thread_offline();
+
+#ifdef FOSSIL_THREADS_STATS
+        if (stats_on(pool)) {
+            uint64_t start = fossil_platform_now_ns();
+            pool_idle(worker);
+            stats_add(&worker->stats.idle_ns, fossil_platform_now_ns() - start);
+            continue;
+        }
+#endif
+        pool_idle(worker);
     }
 
+    fossil_rcu_unregister();
+    fossil_epoch_unregister();
+    current_worker = NULL;
     return NULL;
 }
 
-int32_t fossil_thread_pool_create(fossil_thread_pool_t *pool, uint32_t num_threads) {
-    pool->threads = (fossil_thread_t *)malloc(num_threads * sizeof(fossil_thread_t));
+// Set up num_threads workers and start the first `started` of them; the
+// rest are started by pool_grow as work arrives.
+static int32_t pool_init(fossil_thread_pool_t *pool, uint32_t num_threads, uint32_t started) {
+    // Each worker gets a spare slot behind the regular ones, started only
+    // when a blocking region calls for it.
+    uint32_t slots = num_threads * 2;
+    pool->threads = (fossil_thread_t *)malloc(slots * sizeof(fossil_thread_t));
     if (!pool->threads) return -1;
 
+    pool->workers = (fossil_thread_pool_worker_t *)fossil_platform_aligned_alloc(
+        FOSSIL_CACHE_LINE, slots * sizeof(fossil_thread_pool_worker_t));
+    if (!pool->workers) {
+        free(pool->threads);
+        return -1;
+    }
+
+    pool->num_threads = 0;
     pool->head = NULL;
     pool->tail = NULL;
+    pool->pending = 0;
+    pool->queued = 0;
+    pool->capacity = 0;
+    pool->policy = FOSSIL_THREAD_POOL_BLOCK;
+    pool->blocked = 0;
+    pool->num_idle = 0;
+    // Spinning only pays off when the submitter runs on another core.
+    pool->spin_count = fossil_platform_cpu_count() > 1 ? FOSSIL_THREAD_POOL_SPIN_COUNT : 0;
+    pool->yield_count = FOSSIL_THREAD_POOL_YIELD_COUNT;
+    pool->stats_enabled = 0;
+    pool->affinity_steal = 0;
+    pool->spare_capacity = num_threads;
+    pool->max_spares = num_threads;
+    pool->num_spares = 0;
+    pool->blocked_workers = 0;
+    pool->spawning = 0;
+    pool->spare_exit = 0;
+    pool->watchdog_ns = 0;
+    pool->watchdog = NULL;
+    pool->watchdog_context = NULL;
+    pool->watchdog_running = 0;
+    pool->watchdog_stop = 0;
+    pool->long_running = 0;
+    pool->external_submitted = 0;
+    pool->rejected = 0;
+    pool->dropped = 0;
+    pool->cancelled = 0;
     pool->shutdown = 0;
 
-    if (fossil_mutex_create(&pool->mutex) != 0 ||
-        fossil_cond_create(&pool->cond) != 0 ||
+    if (fossil_slab_create(&pool->task_slab, sizeof(task_queue_t)) != 0 ||
+        fossil_mutex_create(&pool->mutex) != 0 ||
+        fossil_cond_create(&pool->not_full) != 0 ||
         fossil_semaphore_create(&pool->semaphore, 0) != 0) {
+        fossil_platform_aligned_free(pool->workers);
         free(pool->threads);
         return -1;
     }
 
-    for (uint32_t i = 0; i < num_threads; i++) {
-        if (fossil_thread_create(&pool->threads[i], NULL, worker_thread, pool) != 0) {
+    for (uint32_t i = 0; i < slots; i++) {
+        fossil_thread_pool_worker_t *worker = &pool->workers[i];
+        memset(worker, 0, sizeof(*worker));
+        fossil_eventcount_create(&worker->idle);
+        worker->parked = 0;
+        worker->index = i;
+        worker->steal_seed = 2463534242u + i * 0x9E3779B9u;
+        worker->pool = pool;
+        fossil_arena_create(&worker->scratch, 0);
+        worker->ring = deque_ring_create(DEQUE_INITIAL_SIZE, NULL);
+        fossil_mutex_create(&worker->inbox_mutex);
+
+        if (!worker->ring) {
+            // Nothing runs yet: undo the slots set up so far.
+            for (uint32_t j = 0; j <= i; j++) {
+                free(pool->workers[j].ring);
+                fossil_mutex_destroy(&pool->workers[j].inbox_mutex);
+                fossil_arena_destroy(&pool->workers[j].scratch);
+            }
+            fossil_mutex_destroy(&pool->mutex);
+            fossil_cond_destroy(&pool->not_full);
+            fossil_semaphore_destroy(&pool->semaphore);
+            fossil_slab_destroy(&pool->task_slab);
+            fossil_platform_aligned_free(pool->workers);
+            free(pool->threads);
+            return -1;
+        }
+    }
+
+    for (uint32_t i = 0; i < started; i++) {
+        if (fossil_thread_create(&pool->threads[i], NULL, worker_thread, &pool->workers[i]) != 0) {
             fossil_thread_pool_destroy(pool);
             return -1;
         }
+        __atomic_store_n(&pool->num_threads, i + 1, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+int32_t fossil_thread_pool_create(fossil_thread_pool_t *pool, uint32_t num_threads) {
+    return pool_init(pool, num_threads, num_threads);
+}
+
+static fossil_thread_pool_t default_pool;
+static uint32_t default_once = 0;
+static int32_t default_ready = 0;
+
+static void default_shutdown(void) {
+    // exit() called from one of its own tasks cannot wait for that task.
+    if (current_worker && current_worker->pool == &default_pool) return;
+    // Later callers (other atexit handlers) must not get the destroyed pool.
+    __atomic_store_n(&default_ready, 0, __ATOMIC_SEQ_CST);
+    fossil_thread_pool_destroy(&default_pool);
+}
+
+static void default_init(void) {
+    if (pool_init(&default_pool, fossil_platform_cpu_count(), 0) == 0) {
+        default_ready = 1;
+        atexit(default_shutdown);
+    }
+}
+
+fossil_thread_pool_t *fossil_thread_pool_default(void) {
+    fossil_platform_once(&default_once, default_init);
+    return __atomic_load_n(&default_ready, __ATOMIC_ACQUIRE) ? &default_pool : NULL;
+}
+
+static task_queue_t *pool_task_alloc(fossil_thread_pool_t *pool) {
+    task_queue_t *task = (task_queue_t *)fossil_slab_alloc(&pool->task_slab);
+    if (!task) return NULL;
+
+    task->task_func = NULL;
+    task->arg = NULL;
+    task->invoke = NULL;
+    task->cancel = NULL;
+    task->pinned = 0;
+    task->owned = 0;
+    task->submit_ns = 0;
+    task->next = NULL;
+    return task;
+}
+
+static inline void pool_count_submit(fossil_thread_pool_t *pool, fossil_thread_pool_worker_t *worker, task_queue_t *task) {
+#ifdef FOSSIL_THREADS_STATS
+    if (stats_on(pool)) {
+        task->submit_ns = fossil_platform_now_ns();
+        if (worker) {
+            stats_add(&worker->stats.submitted, 1);
+        } else {
+            __atomic_fetch_add(&pool->external_submitted, 1, __ATOMIC_RELAXED);
+        }
+    }
+#else
+    (void)pool;
+    (void)worker;
+    (void)task;
+#endif
+}
+
+// Queue a task. Returns 0 when queued, 1 when the caller must run it
+// itself (CALLER_RUNS) and -1 when it was rejected.
+static int32_t pool_push(fossil_thread_pool_t *pool, task_queue_t *task) {
+    fossil_thread_pool_worker_t *worker = current_worker && current_worker->pool == pool ? current_worker : NULL;
+    pool_count_submit(pool, worker, task);
+    // A spare may park for good once it is no longer needed, so its tasks go
+    // to the shared queue (still exempt from the capacity limit).
+    int32_t local = worker && pool_is_core(worker);
+    if (!worker && pool_ensure_worker(pool) != 0) return -1;
+
+    // Tasks spawned by a task stay on the spawning worker unless stolen.
+    // Count them first so pending never dips below zero when a thief wins.
+    if (local) {
+        __atomic_fetch_add(&pool->pending, 1, __ATOMIC_SEQ_CST);
+        if (deque_push(worker, task) == 0) {
+            FOSSIL_TRACE_EVENT(FOSSIL_TRACE_SUBMIT, task, TASK_ENTRY(task));
+            pool_wake_one(pool);
+            return 0;
+        }
+        __atomic_fetch_sub(&pool->pending, 1, __ATOMIC_RELAXED);
+    }
+
+    fossil_mutex_lock(&pool->mutex);
+
+    task_queue_t *dropped = NULL;
+    while (!worker && pool->capacity && pool->queued >= pool->capacity) {
+        if (pool->policy == FOSSIL_THREAD_POOL_BLOCK && !pool->shutdown) {
+            pool->blocked++;
+            fossil_cond_wait(&pool->not_full, &pool->mutex);
+            pool->blocked--;
+            continue;
+        }
+        if (pool->policy == FOSSIL_THREAD_POOL_DROP_OLDEST && !pool->shutdown) {
+            // Graph and pipeline dispatches are skipped: their owners wait
+            // for every one of them. With nothing else queued, reject.
+            task_queue_t **link = &pool->head;
+            task_queue_t *prev = NULL;
+            while (*link && (*link)->owned) {
+                prev = *link;
+                link = &prev->next;
+            }
+            if (*link) {
+                task_queue_t *oldest = *link;
+                *link = oldest->next;
+                if (pool->tail == oldest) pool->tail = prev;
+                oldest->next = dropped;
+                dropped = oldest;
+                __atomic_fetch_sub(&pool->queued, 1, __ATOMIC_RELAXED);
+                __atomic_fetch_sub(&pool->pending, 1, __ATOMIC_RELAXED);
+                continue;
+            }
+        }
+
+        int32_t caller_runs = pool->policy == FOSSIL_THREAD_POOL_CALLER_RUNS && !pool->shutdown;
+        fossil_mutex_unlock(&pool->mutex);
+        __atomic_fetch_add(&pool->rejected, 1, __ATOMIC_RELAXED);
+        return caller_runs ? 1 : -1;
+    }
+
+    if (pool->tail) {
+        pool->tail->next = task;
+    } else {
+        pool->head = task;
+    }
+    pool->tail = task;
+    __atomic_fetch_add(&pool->queued, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&pool->pending, 1, __ATOMIC_SEQ_CST);
+
+    fossil_mutex_unlock(&pool->mutex);
+
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_SUBMIT, task, TASK_ENTRY(task));
+    pool_wake_one(pool);
+
+    while (dropped) {
+        task_queue_t *next = dropped->next;
+        __atomic_fetch_add(&pool->dropped, 1, __ATOMIC_RELAXED);
+        pool_discard(pool, dropped);
+        dropped = next;
     }
     return 0;
 }
 
+// Push a task and carry out the backpressure outcome. destroy says whether
+// the node owns its state, so that a rejected task must be destroyed.
+static int32_t pool_submit(fossil_thread_pool_t *pool, task_queue_t *task, int32_t destroy) {
+    int32_t result = pool_push(pool, task);
+    if (result == 0) return 0;
+
+    if (result > 0) {
+        if (pool_cancelled(task)) {
+            __atomic_fetch_add(&pool->cancelled, 1, __ATOMIC_RELAXED);
+            pool_discard(pool, task);
+        } else {
+            pool_call(task);
+            fossil_slab_free(&pool->task_slab, task);
+        }
+        return 0;
+    }
+
+    if (!destroy) task->invoke = NULL;
+    pool_discard(pool, task);
+    return -1;
+}
+
 int32_t fossil_thread_pool_submit(fossil_thread_pool_t *pool, fossil_task_t task, fossil_argumet_t arg) {
-    task_queue_t *new_task = (task_queue_t *)malloc(sizeof(task_queue_t));
+    task_queue_t *new_task = pool_task_alloc(pool);
     if (!new_task) return -1;
 
     new_task->task_func = task;
     new_task->arg = arg;
-    new_task->next = NULL;
+    return pool_submit(pool, new_task, 0);
+}
 
-    fossil_mutex_lock(&pool->mutex);
+int32_t fossil_thread_pool_submit_cancellable(fossil_thread_pool_t *pool, fossil_task_t task,
+                                              fossil_argumet_t arg, fossil_cancel_token_t *token) {
+    task_queue_t *new_task = pool_task_alloc(pool);
+    if (!new_task) return -1;
 
-    if (pool->tail) {
-        pool->tail->next = new_task;
+    new_task->task_func = task;
+    new_task->arg = arg;
+    new_task->cancel = token;
+    return pool_submit(pool, new_task, 0);
+}
+
+// Spread keys evenly over the workers, whatever their low bits look like.
+static inline uint32_t pool_key_index(uint64_t key, uint32_t count) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return (uint32_t)(((key >> 32) * count) >> 32);
+}
+
+static int32_t pool_submit_keyed(fossil_thread_pool_t *pool, uint64_t key, fossil_task_t task,
+                                 fossil_argumet_t arg, uint32_t pinned) {
+    // Route over every worker the pool will have, so that a key keeps its
+    // worker while a pool that starts workers on demand grows.
+    uint32_t count = pool->spare_capacity;
+    if (count == 0) return -1;
+    uint32_t index = pool_key_index(key, count);
+    while (__atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE) <= index) {
+        if (pool_grow(pool) != 0) return -1;
+        fossil_platform_yield();
+    }
+
+    task_queue_t *new_task = pool_task_alloc(pool);
+    if (!new_task) return -1;
+    new_task->task_func = task;
+    new_task->arg = arg;
+    new_task->pinned = pinned;
+
+    fossil_thread_pool_worker_t *target = &pool->workers[index];
+    pool_count_submit(pool, current_worker && current_worker->pool == pool ? current_worker : NULL, new_task);
+
+    fossil_mutex_lock(&target->inbox_mutex);
+    if (target->inbox_tail) {
+        target->inbox_tail->next = new_task;
     } else {
-        pool->head = new_task;
+        target->inbox_head = new_task;
     }
-    pool->tail = new_task;
+    target->inbox_tail = new_task;
+    uint32_t depth = __atomic_add_fetch(&target->inbox_count, 1, __ATOMIC_SEQ_CST);
+    fossil_mutex_unlock(&target->inbox_mutex);
+
+    FOSSIL_TRACE_EVENT(FOSSIL_TRACE_SUBMIT, new_task, TASK_ENTRY(new_task));
+    pool_wake_worker(target);
 
-    fossil_cond_signal(&pool->cond);
+    // Past the threshold, recruit an idle worker to steal.
+    uint32_t threshold = __atomic_load_n(&pool->affinity_steal, __ATOMIC_RELAXED);
+    if (!pinned && threshold && depth > threshold) pool_wake_one(pool);
+    return 0;
+}
+
+int32_t fossil_thread_pool_submit_keyed(fossil_thread_pool_t *pool, uint64_t key, fossil_task_t task, fossil_argumet_t arg) {
+    return pool_submit_keyed(pool, key, task, arg, 0);
+}
+
+int32_t fossil_thread_pool_submit_serial(fossil_thread_pool_t *pool, uint64_t key, fossil_task_t task, fossil_argumet_t arg) {
+    return pool_submit_keyed(pool, key, task, arg, 1);
+}
+
+int32_t fossil_thread_pool_set_affinity_steal(fossil_thread_pool_t *pool, uint32_t threshold) {
+    __atomic_store_n(&pool->affinity_steal, threshold, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static int32_t pool_submit_inline(fossil_thread_pool_t *pool, fossil_inline_task_t invoke, const void *data,
+                                  size_t size, uint32_t owned) {
+    if (!invoke || size > FOSSIL_THREAD_POOL_INLINE_SIZE) return -1;
+
+    task_queue_t *new_task = pool_task_alloc(pool);
+    if (!new_task) return -1;
+
+    new_task->invoke = invoke;
+    new_task->owned = owned;
+    if (size) memcpy(new_task->storage.bytes, data, size);
+    return pool_submit(pool, new_task, 0);
+}
+
+int32_t fossil_thread_pool_submit_inline(fossil_thread_pool_t *pool, fossil_inline_task_t invoke, const void *data, size_t size) {
+    return pool_submit_inline(pool, invoke, data, size, 0);
+}
+
+int32_t fossil_thread_pool_submit_owned(fossil_thread_pool_t *pool, fossil_inline_task_t invoke, const void *data, size_t size) {
+    return pool_submit_inline(pool, invoke, data, size, 1);
+}
+
+int32_t fossil_thread_pool_emplace(fossil_thread_pool_t *pool, fossil_inline_task_t invoke,
+                                   void (*construct)(void *storage, void *context), void *context, size_t size) {
+    if (!invoke || !construct || size > FOSSIL_THREAD_POOL_INLINE_SIZE) return -1;
+
+    task_queue_t *new_task = pool_task_alloc(pool);
+    if (!new_task) return -1;
+
+    new_task->invoke = invoke;
+    construct(new_task->storage.bytes, context);
+    return pool_submit(pool, new_task, 1);
+}
+
+int32_t fossil_thread_pool_set_capacity(fossil_thread_pool_t *pool, uint32_t capacity, fossil_thread_pool_policy_t policy) {
+    if (policy > FOSSIL_THREAD_POOL_DROP_OLDEST) return -1;
+
+    fossil_mutex_lock(&pool->mutex);
+    pool->capacity = capacity;
+    pool->policy = policy;
+    // Blocked submitters re-check against the new limit and policy.
+    if (pool->blocked) fossil_cond_broadcast(&pool->not_full);
     fossil_mutex_unlock(&pool->mutex);
+    return 0;
+}
 
+size_t fossil_thread_pool_cancel(fossil_thread_pool_t *pool, fossil_cancel_token_t *token) {
+    fossil_cancel_token_cancel(token);
+
+    task_queue_t *removed = NULL;
+    size_t count = 0;
+
+    fossil_mutex_lock(&pool->mutex);
+    task_queue_t **link = &pool->head;
+    task_queue_t *last = NULL;
+    while (*link) {
+        task_queue_t *task = *link;
+        if (task->cancel == token) {
+            *link = task->next;
+            task->next = removed;
+            removed = task;
+            count++;
+        } else {
+            last = task;
+            link = &task->next;
+        }
+    }
+    pool->tail = last;
+    if (count) {
+        __atomic_fetch_sub(&pool->queued, (uint32_t)count, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&pool->pending, (uint32_t)count, __ATOMIC_RELAXED);
+        if (pool->blocked) fossil_cond_broadcast(&pool->not_full);
+    }
+    fossil_mutex_unlock(&pool->mutex);
+
+    __atomic_fetch_add(&pool->cancelled, count, __ATOMIC_RELAXED);
+    while (removed) {
+        task_queue_t *next = removed->next;
+        pool_discard(pool, removed);
+        removed = next;
+    }
+    return count;
+}
+
+int32_t fossil_thread_pool_cancel_requested(void) {
+    fossil_thread_pool_worker_t *worker = current_worker;
+    return worker && worker->cancel && fossil_cancel_token_is_cancelled(worker->cancel);
+}
+
+int32_t fossil_cancel_token_create(fossil_cancel_token_t *token) {
+    if (!token) return -1;
+    __atomic_store_n(&token->cancelled, 0, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int32_t fossil_cancel_token_cancel(fossil_cancel_token_t *token) {
+    if (!token) return -1;
+    __atomic_store_n(&token->cancelled, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int32_t fossil_cancel_token_is_cancelled(const fossil_cancel_token_t *token) {
+    return token && __atomic_load_n(&token->cancelled, __ATOMIC_ACQUIRE) ? 1 : 0;
+}
+
+int32_t fossil_thread_pool_set_idle(fossil_thread_pool_t *pool, uint32_t spin_count, uint32_t yield_count) {
+    __atomic_store_n(&pool->spin_count, spin_count, __ATOMIC_RELAXED);
+    __atomic_store_n(&pool->yield_count, yield_count, __ATOMIC_RELAXED);
+    return 0;
+}
+
+int32_t fossil_thread_pool_stats_enable(fossil_thread_pool_t *pool, int32_t enabled) {
+#ifdef FOSSIL_THREADS_STATS
+    __atomic_store_n(&pool->stats_enabled, enabled ? 1 : 0, __ATOMIC_RELAXED);
+    return 0;
+#else
+    (void)pool;
+    (void)enabled;
+    return -1;
+#endif
+}
+
+int32_t fossil_thread_pool_worker_stats(fossil_thread_pool_t *pool, uint32_t index, fossil_thread_pool_worker_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+#ifdef FOSSIL_THREADS_STATS
+    if (index >= __atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE) &&
+        (index < pool->spare_capacity || index >= pool->spare_capacity + __atomic_load_n(&pool->num_spares, __ATOMIC_ACQUIRE))) {
+        return -1;
+    }
+
+    const fossil_thread_pool_worker_stats_t *src = &pool->workers[index].stats;
+    stats->submitted = __atomic_load_n(&src->submitted, __ATOMIC_RELAXED);
+    stats->executed = __atomic_load_n(&src->executed, __ATOMIC_RELAXED);
+    stats->stolen = __atomic_load_n(&src->stolen, __ATOMIC_RELAXED);
+    stats->idle_ns = __atomic_load_n(&src->idle_ns, __ATOMIC_RELAXED);
+    stats->busy_ns = __atomic_load_n(&src->busy_ns, __ATOMIC_RELAXED);
+    return 0;
+#else
+    (void)pool;
+    (void)index;
+    return -1;
+#endif
+}
+
+int32_t fossil_thread_pool_stats(fossil_thread_pool_t *pool, fossil_thread_pool_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    uint32_t num_threads = __atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE);
+    stats->num_workers = num_threads;
+    stats->idle_workers = __atomic_load_n(&pool->num_idle, __ATOMIC_RELAXED);
+    stats->queue_depth = __atomic_load_n(&pool->pending, __ATOMIC_RELAXED);
+    for (uint32_t i = 0; i < num_threads; i++) {
+        stats->queue_depth += __atomic_load_n(&pool->workers[i].inbox_count, __ATOMIC_RELAXED);
+    }
+    stats->rejected = __atomic_load_n(&pool->rejected, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&pool->dropped, __ATOMIC_RELAXED);
+    stats->cancelled = __atomic_load_n(&pool->cancelled, __ATOMIC_RELAXED);
+    stats->spare_workers = __atomic_load_n(&pool->num_spares, __ATOMIC_ACQUIRE);
+    stats->blocked_workers = __atomic_load_n(&pool->blocked_workers, __ATOMIC_RELAXED);
+    stats->long_running = __atomic_load_n(&pool->long_running, __ATOMIC_RELAXED);
+#ifdef FOSSIL_THREADS_STATS
+    stats->external_submitted = __atomic_load_n(&pool->external_submitted, __ATOMIC_RELAXED);
+    stats->total.submitted = stats->external_submitted;
+
+    for (uint32_t i = 0; i < pool->spare_capacity + stats->spare_workers; i++) {
+        if (i >= num_threads && i < pool->spare_capacity) continue;
+        fossil_thread_pool_worker_t *worker = &pool->workers[i];
+        fossil_thread_pool_worker_stats_t counters;
+        fossil_thread_pool_worker_stats(pool, i, &counters);
+
+        stats->total.submitted += counters.submitted;
+        stats->total.executed += counters.executed;
+        stats->total.stolen += counters.stolen;
+        stats->total.idle_ns += counters.idle_ns;
+        stats->total.busy_ns += counters.busy_ns;
+
+        for (uint32_t b = 0; b < FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS; b++) {
+            stats->wait_histogram[b] += __atomic_load_n(&worker->wait_histogram[b], __ATOMIC_RELAXED);
+            stats->exec_histogram[b] += __atomic_load_n(&worker->exec_histogram[b], __ATOMIC_RELAXED);
+        }
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+void *fossil_thread_pool_scratch_alloc(size_t size) {
+    if (!current_worker) return NULL;
+    return fossil_arena_alloc(&current_worker->scratch, size);
+}
+
+int32_t fossil_thread_pool_worker_index(void) {
+    return current_worker ? (int32_t)current_worker->index : -1;
+}
+
+int32_t fossil_thread_pool_local_create(fossil_thread_pool_local_t *local, fossil_thread_pool_t *pool, size_t size) {
+    if (!local || !pool) return -1;
+
+    uint32_t count = pool->spare_capacity * 2;
+    size_t stride = (size + FOSSIL_CACHE_LINE - 1) & ~(size_t)(FOSSIL_CACHE_LINE - 1);
+    if (stride == 0) stride = FOSSIL_CACHE_LINE;
+
+    local->slots = (unsigned char *)fossil_platform_aligned_alloc(FOSSIL_CACHE_LINE, stride * (count ? count : 1));
+    if (!local->slots) return -1;
+
+    memset(local->slots, 0, stride * (count ? count : 1));
+    local->pool = pool;
+    local->stride = stride;
+    local->count = count;
+    return 0;
+}
+
+void *fossil_thread_pool_local_get(fossil_thread_pool_local_t *local) {
+    fossil_thread_pool_worker_t *worker = current_worker;
+    if (!worker || worker->pool != local->pool || worker->index >= local->count) return NULL;
+    return local->slots + worker->index * local->stride;
+}
+
+void *fossil_thread_pool_local_at(fossil_thread_pool_local_t *local, uint32_t index) {
+    if (index >= local->count) return NULL;
+    return local->slots + index * local->stride;
+}
+
+int32_t fossil_thread_pool_local_destroy(fossil_thread_pool_local_t *local) {
+    if (!local) return -1;
+    fossil_platform_aligned_free(local->slots);
+    local->slots = NULL;
+    local->count = 0;
+    return 0;
+}
+
+void fossil_thread_pool_enter_blocking(void) {
+    fossil_thread_pool_worker_t *worker = current_worker;
+    if (!worker || !worker->in_task || worker->blocking++) return;
+
+    // The task holds no RCU references while it waits (unless it is inside
+    // a read-side section, where going offline is ignored), so grace
+    // periods need not wait for it to wake up.
+    worker->rcu_online = fossil_rcu_thread_is_online();
+    fossil_rcu_thread_offline();
+
+    fossil_thread_pool_t *pool = worker->pool;
+    __atomic_fetch_add(&pool->blocked_workers, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->pending, __ATOMIC_SEQ_CST)) pool_compensate(pool);
+}
+
+void fossil_thread_pool_leave_blocking(void) {
+    fossil_thread_pool_worker_t *worker = current_worker;
+    if (!worker || !worker->blocking || --worker->blocking) return;
+    __atomic_fetch_sub(&worker->pool->blocked_workers, 1, __ATOMIC_SEQ_CST);
+    if (worker->rcu_online) fossil_rcu_thread_online();
+}
+
+int32_t fossil_thread_pool_set_max_spares(fossil_thread_pool_t *pool, uint32_t max_spares) {
+    if (!pool) return -1;
+    if (max_spares > pool->spare_capacity) max_spares = pool->spare_capacity;
+    __atomic_store_n(&pool->max_spares, max_spares, __ATOMIC_RELAXED);
+    return 0;
+}
+
+// Report each task running past the threshold once, keyed by its start time.
+static void pool_watchdog_scan(fossil_thread_pool_t *pool, uint64_t threshold) {
+    fossil_thread_pool_watchdog_t callback = __atomic_load_n(&pool->watchdog, __ATOMIC_ACQUIRE);
+    void *context = __atomic_load_n(&pool->watchdog_context, __ATOMIC_ACQUIRE);
+    uint64_t now = fossil_platform_now_ns();
+
+    uint32_t count = __atomic_load_n(&pool->num_threads, __ATOMIC_ACQUIRE);
+    uint32_t spares = __atomic_load_n(&pool->num_spares, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < pool->spare_capacity + spares; i++) {
+        if (i >= count && i < pool->spare_capacity) continue;
+        fossil_thread_pool_worker_t *worker = &pool->workers[i];
+        uint64_t start = __atomic_load_n(&worker->task_start, __ATOMIC_RELAXED);
+        if (!start || start == worker->flagged_start || now < start || now - start < threshold) continue;
+
+        worker->flagged_start = start;
+        __atomic_fetch_add(&pool->long_running, 1, __ATOMIC_RELAXED);
+        if (callback) callback(pool, i, now - start, context);
+    }
+}
+
+static void *pool_watchdog(void *arg) {
+    fossil_thread_pool_t *pool = (fossil_thread_pool_t *)arg;
+    while (!__atomic_load_n(&pool->watchdog_stop, __ATOMIC_ACQUIRE)) {
+        uint64_t threshold = __atomic_load_n(&pool->watchdog_ns, __ATOMIC_ACQUIRE);
+        uint64_t period = threshold / 4;
+        if (period < 1000000ull) period = 1000000ull;
+        if (period > 1000000000ull) period = 1000000000ull;
+
+        fossil_platform_futex_wait(&pool->watchdog_stop, 0, period);
+        if (threshold) pool_watchdog_scan(pool, threshold);
+    }
+    return NULL;
+}
+
+int32_t fossil_thread_pool_set_watchdog(fossil_thread_pool_t *pool, uint64_t threshold_ns,
+                                        fossil_thread_pool_watchdog_t callback, void *context) {
+    if (!pool) return -1;
+    __atomic_store_n(&pool->watchdog, callback, __ATOMIC_RELEASE);
+    __atomic_store_n(&pool->watchdog_context, context, __ATOMIC_RELEASE);
+    __atomic_store_n(&pool->watchdog_ns, threshold_ns, __ATOMIC_RELEASE);
+    if (!threshold_ns) return 0;
+
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&pool->watchdog_running, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+    if (fossil_thread_create(&pool->watchdog_thread, NULL, pool_watchdog, pool) != 0) {
+        __atomic_store_n(&pool->watchdog_running, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&pool->watchdog_ns, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
     return 0;
 }
 
 int32_t fossil_thread_pool_destroy(fossil_thread_pool_t *pool) {
+    __atomic_store_n(&pool->shutdown, 1, __ATOMIC_SEQ_CST);
+
+    // A worker being started now is either counted or sees the shutdown flag.
+    while (__atomic_load_n(&pool->spawning, __ATOMIC_SEQ_CST) == 1) {
+        fossil_platform_yield();
+    }
+
+    if (__atomic_load_n(&pool->watchdog_running, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&pool->watchdog_stop, 1, __ATOMIC_RELEASE);
+        fossil_platform_futex_wake(&pool->watchdog_stop, 1);
+        fossil_thread_join(pool->watchdog_thread, NULL);
+    }
+
+    // Submitters blocked on a full queue give up.
     fossil_mutex_lock(&pool->mutex);
-    pool->shutdown = 1;
-    fossil_cond_broadcast(&pool->cond);
+    fossil_cond_broadcast(&pool->not_full);
     fossil_mutex_unlock(&pool->mutex);
 
+    // Each worker sleeps on its own eventcount, so there is no herd to stampede.
+    for (uint32_t i = 0; i < pool->num_threads; i++) {
+        pool_unpark(&pool->workers[i]);
+        fossil_eventcount_notify(&pool->workers[i].idle);
+    }
+
+    // Workers drain the queue before exiting and may still block doing so,
+    // so spares keep standing in until the last one has exited.
     for (uint32_t i = 0; i < pool->num_threads; i++) {
         fossil_thread_join(pool->threads[i], NULL);
     }
 
+    __atomic_store_n(&pool->spare_exit, 1, __ATOMIC_SEQ_CST);
+    uint32_t expected = 0;
+    while (!__atomic_compare_exchange_n(&pool->spawning, &expected, 2, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        expected = 0;
+        fossil_platform_yield();
+    }
+    uint32_t spares = __atomic_load_n(&pool->num_spares, __ATOMIC_ACQUIRE);
+    for (uint32_t k = 0; k < spares; k++) {
+        pool_unpark(&pool->workers[pool->spare_capacity + k]);
+        fossil_eventcount_notify(&pool->workers[pool->spare_capacity + k].idle);
+    }
+    for (uint32_t k = 0; k < spares; k++) {
+        fossil_thread_join(pool->threads[pool->spare_capacity + k], NULL);
+    }
+
     // Free remaining tasks in the queue
     task_queue_t *task = pool->head;
     while (task) {
         task_queue_t *next = task->next;
-        free(task);
+        if (task->invoke) task->invoke(task->storage.bytes, 0);
+        fossil_slab_free(&pool->task_slab, task);
         task = next;
     }
 
+    for (uint32_t i = 0; i < pool->spare_capacity * 2; i++) {
+        fossil_thread_pool_worker_t *worker = &pool->workers[i];
+        while ((task = deque_pop(worker)) != NULL) {
+            if (task->invoke) task->invoke(task->storage.bytes, 0);
+            fossil_slab_free(&pool->task_slab, task);
+        }
+        while ((task = inbox_take(worker, 0)) != NULL) {
+            fossil_slab_free(&pool->task_slab, task);
+        }
+        for (deque_ring_t *ring = worker->ring; ring;) {
+            deque_ring_t *prev = ring->prev;
+            free(ring);
+            ring = prev;
+        }
+        fossil_eventcount_destroy(&worker->idle);
+        fossil_mutex_destroy(&worker->inbox_mutex);
+        fossil_arena_destroy(&worker->scratch);
+    }
+
     fossil_mutex_destroy(&pool->mutex);
-    fossil_cond_destroy(&pool->cond);
+    fossil_cond_destroy(&pool->not_full);
     fossil_semaphore_destroy(&pool->semaphore);
+    fossil_slab_destroy(&pool->task_slab);
+    fossil_platform_aligned_free(pool->workers);
     free(pool->threads);
 
     return 0;
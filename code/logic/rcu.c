@@ -0,0 +1,371 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/rcu.h"
+#include "fossil/threads/slab.h"
+#include "fossil/threads/sync.h"
+#include "fossil/threads/threads.h"
+#include "platform.h"
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+/* -------- Read-Copy-Update -------- */
+
+#define RCU_SPIN_COUNT 128
+#define RCU_YIELD_COUNT 64
+#define RCU_NAP_NS 100000ull
+
+// One per registered thread, never freed; released records are reused.
+// ctr is 0 while the thread holds no references, otherwise the grace
+// period counter it observed when it last entered a section or reported a
+// quiescent state. A grace period that advanced the counter to g is over
+// once every record reads 0 or at least g.
+typedef struct rcu_record_t {
+    FOSSIL_CACHE_ALIGNED uint64_t ctr;
+
+    // Owner only.
+    FOSSIL_CACHE_ALIGNED struct rcu_record_t *next;
+    uint32_t in_use;
+    uint32_t nesting;
+    uint32_t online;
+} rcu_record_t;
+
+typedef struct rcu_callback_t {
+    void *ptr;
+    fossil_reclaim_t reclaim;
+    struct rcu_callback_t *next;
+} rcu_callback_t;
+
+static FOSSIL_CACHE_ALIGNED uint64_t rcu_gp = 1;
+static rcu_record_t *rcu_records = NULL;
+static FOSSIL_THREAD_LOCAL rcu_record_t *rcu_current = NULL;
+
+static uint32_t rcu_init_state = 0;
+static uint32_t rcu_expedited = 0;
+static uint32_t rcu_nap = 0;
+static fossil_mutex_t rcu_gp_mutex;
+
+// Callbacks are pushed onto a lock-free stack and drained by the reclaimer.
+static FOSSIL_CACHE_ALIGNED rcu_callback_t *rcu_callbacks = NULL;
+static uint32_t rcu_reclaimer_state = 0;
+static uint32_t rcu_reclaimer_running = 0;
+static fossil_eventcount_t rcu_work;
+static fossil_eventcount_t rcu_idle;
+
+static uint32_t exit_hook_state = 0;
+#ifdef _WIN32
+static DWORD exit_hook_key;
+#else
+static pthread_key_t exit_hook_key;
+#endif
+
+static void rcu_release(rcu_record_t *record);
+
+#ifdef _WIN32
+static VOID NTAPI rcu_exit_callback(PVOID value) {
+    if (value && rcu_current) rcu_release(rcu_current);
+}
+#else
+static void rcu_exit_callback(void *value) {
+    (void)value;
+    if (rcu_current) rcu_release(rcu_current);
+}
+#endif
+
+static void exit_hook_init(void) {
+#ifdef _WIN32
+    exit_hook_key = FlsAlloc(rcu_exit_callback);
+#else
+    pthread_key_create(&exit_hook_key, rcu_exit_callback);
+#endif
+}
+
+// With a process-wide barrier available the writer pays for ordering and
+// readers only need to stop the compiler from reordering.
+static void rcu_init(void) {
+    fossil_mutex_create(&rcu_gp_mutex);
+    fossil_eventcount_create(&rcu_work);
+    fossil_eventcount_create(&rcu_idle);
+    if (fossil_platform_membarrier_init() == 0) {
+        __atomic_store_n(&rcu_expedited, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static inline void rcu_reader_fence(void) {
+    if (__atomic_load_n(&rcu_expedited, __ATOMIC_RELAXED)) {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    } else {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+static inline void rcu_writer_fence(void) {
+    if (__atomic_load_n(&rcu_expedited, __ATOMIC_RELAXED)) {
+        fossil_platform_membarrier();
+    } else {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+static rcu_record_t *rcu_acquire(void) {
+    rcu_record_t *record = rcu_current;
+    if (record) return record;
+
+    fossil_platform_once(&rcu_init_state, rcu_init);
+    for (record = __atomic_load_n(&rcu_records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        uint32_t expected = 0;
+        if (__atomic_load_n(&record->in_use, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&record->in_use, &expected, 1, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    if (!record) {
+        record = (rcu_record_t *)fossil_platform_aligned_alloc(FOSSIL_CACHE_LINE, sizeof(*record));
+        if (!record) return NULL;
+        memset(record, 0, sizeof(*record));
+        record->in_use = 1;
+
+        rcu_record_t *head = __atomic_load_n(&rcu_records, __ATOMIC_RELAXED);
+        do {
+            record->next = head;
+        } while (!__atomic_compare_exchange_n(&rcu_records, &head, record, 1,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    fossil_platform_once(&exit_hook_state, exit_hook_init);
+#ifdef _WIN32
+    FlsSetValue(exit_hook_key, (PVOID)1);
+#else
+    pthread_setspecific(exit_hook_key, (void *)1);
+#endif
+    rcu_current = record;
+    return record;
+}
+
+static void rcu_release(rcu_record_t *record) {
+    record->nesting = 0;
+    record->online = 0;
+    __atomic_store_n(&record->ctr, 0, __ATOMIC_RELEASE);
+    rcu_current = NULL;
+    __atomic_store_n(&record->in_use, 0, __ATOMIC_RELEASE);
+}
+
+// Start observing the current grace period. The store must be visible
+// before any protected pointer is read.
+static inline void rcu_enter(rcu_record_t *record) {
+    __atomic_store_n(&record->ctr, __atomic_load_n(&rcu_gp, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+    rcu_reader_fence();
+}
+
+int32_t fossil_rcu_register(void) {
+    return rcu_acquire() ? 0 : -1;
+}
+
+int32_t fossil_rcu_unregister(void) {
+    rcu_record_t *record = rcu_current;
+    if (!record) return 0;
+    if (record->nesting) return -1;
+    rcu_release(record);
+    return 0;
+}
+
+void fossil_rcu_read_lock(void) {
+    rcu_record_t *record = rcu_acquire();
+    if (!record) return;
+    if (record->nesting++ || record->online) return;
+    rcu_enter(record);
+}
+
+void fossil_rcu_read_unlock(void) {
+    rcu_record_t *record = rcu_current;
+    if (!record || record->nesting == 0) return;
+    if (--record->nesting || record->online) return;
+    __atomic_store_n(&record->ctr, 0, __ATOMIC_RELEASE);
+}
+
+void fossil_rcu_thread_online(void) {
+    rcu_record_t *record = rcu_acquire();
+    if (!record || record->online) return;
+    record->online = 1;
+    if (!record->nesting) rcu_enter(record);
+}
+
+uint32_t fossil_rcu_thread_is_online(void) {
+    rcu_record_t *record = rcu_current;
+    return record && record->online;
+}
+
+void fossil_rcu_thread_offline(void) {
+    rcu_record_t *record = rcu_current;
+    if (!record || !record->online || record->nesting) return;
+    record->online = 0;
+    __atomic_store_n(&record->ctr, 0, __ATOMIC_RELEASE);
+}
+
+// A later counter value can only delay a grace period, so unlike entering a
+// section this needs no fence.
+void fossil_rcu_quiescent_state(void) {
+    rcu_record_t *record = rcu_current;
+    if (!record || !record->online || record->nesting) return;
+    __atomic_store_n(&record->ctr, __atomic_load_n(&rcu_gp, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+void fossil_rcu_assign_pointer(void **slot, void *value) {
+    __atomic_store_n(slot, value, __ATOMIC_RELEASE);
+}
+
+void *fossil_rcu_dereference(void **slot) {
+    return __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+}
+
+// Readers never signal, so back off from spinning to napping.
+static void rcu_wait_reader(rcu_record_t *record, uint64_t target) {
+    for (uint32_t i = 0;; i++) {
+        uint64_t ctr = __atomic_load_n(&record->ctr, __ATOMIC_ACQUIRE);
+        if (ctr == 0 || ctr >= target) return;
+        if (i < RCU_SPIN_COUNT) {
+            fossil_platform_relax();
+        } else if (i < RCU_SPIN_COUNT + RCU_YIELD_COUNT) {
+            fossil_platform_yield();
+        } else {
+            fossil_platform_futex_wait(&rcu_nap, 0, RCU_NAP_NS);
+        }
+    }
+}
+
+int32_t fossil_rcu_synchronize(void) {
+    rcu_record_t *self = rcu_current;
+    if (self && self->nesting) return -1;
+    fossil_platform_once(&rcu_init_state, rcu_init);
+
+    uint32_t online = self && self->online;
+    if (online) fossil_rcu_thread_offline();
+
+    fossil_mutex_lock(&rcu_gp_mutex);
+    uint64_t target = __atomic_add_fetch(&rcu_gp, 1, __ATOMIC_SEQ_CST);
+    rcu_writer_fence();
+    for (rcu_record_t *record = __atomic_load_n(&rcu_records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        rcu_wait_reader(record, target);
+    }
+    fossil_mutex_unlock(&rcu_gp_mutex);
+
+    if (online) fossil_rcu_thread_online();
+    return 0;
+}
+
+// Run a batch in the order it was queued and free its nodes.
+static void rcu_invoke(rcu_callback_t *list) {
+    rcu_callback_t *ordered = NULL;
+    while (list) {
+        rcu_callback_t *next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    while (ordered) {
+        rcu_callback_t *next = ordered->next;
+        ordered->reclaim(ordered->ptr);
+        fossil_slab_free_size(ordered, sizeof(*ordered));
+        ordered = next;
+    }
+}
+
+// One grace period covers everything queued while the previous batch ran.
+static void *rcu_reclaimer(void *arg) {
+    (void)arg;
+    while (1) {
+        rcu_callback_t *list = __atomic_exchange_n(&rcu_callbacks, NULL, __ATOMIC_ACQUIRE);
+        if (!list) {
+            uint32_t key = fossil_eventcount_prepare_wait(&rcu_work);
+            if (__atomic_load_n(&rcu_callbacks, __ATOMIC_SEQ_CST)) {
+                fossil_eventcount_cancel_wait(&rcu_work);
+                continue;
+            }
+            fossil_eventcount_wait(&rcu_work, key);
+            continue;
+        }
+
+        fossil_rcu_synchronize();
+        rcu_invoke(list);
+    }
+    return NULL;
+}
+
+static void rcu_reclaimer_start(void) {
+    fossil_thread_t thread;
+    if (fossil_thread_create(&thread, NULL, rcu_reclaimer, NULL) == 0) {
+        fossil_thread_detach(thread);
+        __atomic_store_n(&rcu_reclaimer_running, 1, __ATOMIC_RELEASE);
+    }
+}
+
+int32_t fossil_rcu_call(void *ptr, fossil_reclaim_t reclaim) {
+    if (!reclaim) return -1;
+    fossil_platform_once(&rcu_init_state, rcu_init);
+    fossil_platform_once(&rcu_reclaimer_state, rcu_reclaimer_start);
+
+    // Without a reclaimer thread, pay for the grace period here.
+    if (!__atomic_load_n(&rcu_reclaimer_running, __ATOMIC_ACQUIRE)) {
+        if (fossil_rcu_synchronize() != 0) return -1;
+        reclaim(ptr);
+        return 0;
+    }
+
+    rcu_callback_t *node = (rcu_callback_t *)fossil_slab_alloc_size(sizeof(rcu_callback_t));
+    if (!node) return -1;
+    node->ptr = ptr;
+    node->reclaim = reclaim;
+
+    rcu_callback_t *head = __atomic_load_n(&rcu_callbacks, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&rcu_callbacks, &head, node, 1,
+                                          __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    fossil_eventcount_notify(&rcu_work);
+    return 0;
+}
+
+static void rcu_barrier_signal(void *ptr) {
+    __atomic_store_n((uint32_t *)ptr, 1, __ATOMIC_RELEASE);
+    fossil_eventcount_notify(&rcu_idle);
+}
+
+// Batches run in queue order, so once our own callback has run so has
+// everything queued before it.
+int32_t fossil_rcu_barrier(void) {
+    rcu_record_t *self = rcu_current;
+    if (self && self->nesting) return -1;
+
+    uint32_t online = self && self->online;
+    if (online) fossil_rcu_thread_offline();
+
+    uint32_t passed = 0;
+    int32_t result = fossil_rcu_call(&passed, rcu_barrier_signal);
+    while (result == 0 && !__atomic_load_n(&passed, __ATOMIC_ACQUIRE)) {
+        uint32_t key = fossil_eventcount_prepare_wait(&rcu_idle);
+        if (__atomic_load_n(&passed, __ATOMIC_SEQ_CST)) {
+            fossil_eventcount_cancel_wait(&rcu_idle);
+            break;
+        }
+        fossil_eventcount_wait(&rcu_idle, key);
+    }
+
+    if (online) fossil_rcu_thread_online();
+    return result;
+}
@@ -0,0 +1,566 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/slab.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+/* -------- Thread-Caching Slab Allocator -------- */
+
+#define SLAB_ALIGN 16
+#define SLAB_MAGAZINE 64
+#define SLAB_REFILL 32
+#define SLAB_REMOTE_BATCH 32
+#define SLAB_TLS_SLOTS 16
+#define SLAB_REGISTRY_INITIAL 64
+
+#define HEAP_ACTIVE 0
+#define HEAP_ABANDONED 1
+
+// Page header, stored at the start of each FOSSIL_SLAB_PAGE_SIZE page.
+typedef struct slab_page_t {
+    fossil_slab_heap_t *heap;
+    struct slab_page_t *next;
+    void *local_free;   // Owner only.
+    void *remote_free;  // Lock-free stack, pushed by other threads.
+    uint32_t bump;
+    uint32_t capacity;
+} slab_page_t;
+
+#define SLAB_PAGE_HEADER ((sizeof(slab_page_t) + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1))
+
+// One thread's cache for one slab. When the thread exits the heap is marked
+// abandoned and adopted, pages and all, by the next thread that needs one.
+struct fossil_slab_heap_t {
+    FOSSIL_CACHE_ALIGNED fossil_slab_heap_t *next;
+    fossil_slab_t *slab;
+    uint32_t state;
+    uint32_t count;
+    uint32_t remote_count;
+    slab_page_t *pages;
+    slab_page_t *cursor;
+    void *magazine[SLAB_MAGAZINE];
+    void *remote[SLAB_REMOTE_BATCH];
+};
+
+// A thread finds its heap for a slab in the slot picked by the slab's uid,
+// else anywhere in the table, else in an overflow list. Nothing is evicted,
+// so any number of slabs can be in use at once without thrashing.
+typedef struct slab_tls_t {
+    uint64_t uid;
+    fossil_slab_heap_t *heap;
+    struct slab_tls_t *next; // Overflow list only.
+} slab_tls_t;
+
+static FOSSIL_THREAD_LOCAL slab_tls_t slab_tls[SLAB_TLS_SLOTS];
+static FOSSIL_THREAD_LOCAL slab_tls_t *slab_tls_overflow = NULL;
+static FOSSIL_THREAD_LOCAL uint32_t slab_tls_overflow_count = 0;
+static FOSSIL_THREAD_LOCAL uint32_t slab_tls_purge_at = SLAB_TLS_SLOTS;
+
+// Live slabs, so an exiting thread never touches a destroyed allocator.
+// Grown as needed: a slab missing from it would strand its thread caches.
+static uint32_t registry_lock = 0;
+static uint64_t *registry = NULL;
+static uint32_t registry_size = 0;
+static uint64_t next_uid = 1;
+
+static uint32_t exit_hook_state = 0;
+#ifdef _WIN32
+static DWORD exit_hook_key;
+#else
+static pthread_key_t exit_hook_key;
+#endif
+static FOSSIL_THREAD_LOCAL uint32_t exit_hook_armed = 0;
+
+static void registry_acquire(void) {
+    uint32_t expected = 0;
+    while (!__atomic_compare_exchange_n(&registry_lock, &expected, 1, 1,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        expected = 0;
+        fossil_platform_relax();
+    }
+}
+
+static void registry_release(void) {
+    __atomic_store_n(&registry_lock, 0, __ATOMIC_RELEASE);
+}
+
+static int32_t registry_contains(uint64_t uid) {
+    for (uint32_t i = 0; i < registry_size; i++) {
+        if (registry[i] == uid) return 1;
+    }
+    return 0;
+}
+
+// Record a live slab, doubling the registry when it is full. Called with
+// the registry lock held.
+static int32_t registry_add(uint64_t uid) {
+    for (uint32_t i = 0; i < registry_size; i++) {
+        if (registry[i] == 0) {
+            registry[i] = uid;
+            return 0;
+        }
+    }
+
+    uint32_t size = registry_size ? registry_size * 2 : SLAB_REGISTRY_INITIAL;
+    uint64_t *grown = (uint64_t *)realloc(registry, size * sizeof(*grown));
+    if (!grown) return -1;
+    memset(grown + registry_size, 0, (size - registry_size) * sizeof(*grown));
+    grown[registry_size] = uid;
+    registry = grown;
+    registry_size = size;
+    return 0;
+}
+
+static inline slab_page_t *slab_page_of(void *ptr) {
+    return (slab_page_t *)((uintptr_t)ptr & ~(uintptr_t)(FOSSIL_SLAB_PAGE_SIZE - 1));
+}
+
+// Hand a batch of remote frees back to their pages: one CAS per page.
+static void slab_flush_remote(fossil_slab_heap_t *heap) {
+    for (uint32_t i = 0; i < heap->remote_count; i++) {
+        void *head = heap->remote[i];
+        if (!head) continue;
+
+        slab_page_t *page = slab_page_of(head);
+        void *tail = head;
+        for (uint32_t j = i + 1; j < heap->remote_count; j++) {
+            if (heap->remote[j] && slab_page_of(heap->remote[j]) == page) {
+                *(void **)tail = heap->remote[j];
+                tail = heap->remote[j];
+                heap->remote[j] = NULL;
+            }
+        }
+
+        void *old = __atomic_load_n(&page->remote_free, __ATOMIC_RELAXED);
+        do {
+            *(void **)tail = old;
+        } while (!__atomic_compare_exchange_n(&page->remote_free, &old, head, 1,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+    heap->remote_count = 0;
+}
+
+static void slab_release_slot(slab_tls_t *entry) {
+    registry_acquire();
+    if (registry_contains(entry->uid)) {
+        slab_flush_remote(entry->heap);
+        __atomic_store_n(&entry->heap->state, HEAP_ABANDONED, __ATOMIC_RELEASE);
+    }
+    registry_release();
+    entry->uid = 0;
+    entry->heap = NULL;
+}
+
+static void slab_thread_exit(void) {
+    // Re-arm on the next attach so destructors that run after ours and still
+    // free into a slab get another destructor pass.
+    exit_hook_armed = 0;
+    for (uint32_t i = 0; i < SLAB_TLS_SLOTS; i++) {
+        if (slab_tls[i].uid) slab_release_slot(&slab_tls[i]);
+    }
+    while (slab_tls_overflow) {
+        slab_tls_t *entry = slab_tls_overflow;
+        slab_tls_overflow = entry->next;
+        if (entry->uid) slab_release_slot(entry);
+        free(entry);
+    }
+    slab_tls_overflow_count = 0;
+    slab_tls_purge_at = SLAB_TLS_SLOTS;
+}
+
+#ifdef _WIN32
+static VOID NTAPI slab_exit_callback(PVOID value) {
+    if (value) slab_thread_exit();
+}
+#else
+static void slab_exit_callback(void *value) {
+    (void)value;
+    slab_thread_exit();
+}
+#endif
+
+static void exit_hook_init(void) {
+#ifdef _WIN32
+    exit_hook_key = FlsAlloc(slab_exit_callback);
+#else
+    pthread_key_create(&exit_hook_key, slab_exit_callback);
+#endif
+}
+
+static void exit_hook_arm(void) {
+    if (exit_hook_armed) return;
+    fossil_platform_once(&exit_hook_state, exit_hook_init);
+#ifdef _WIN32
+    FlsSetValue(exit_hook_key, (PVOID)1);
+#else
+    pthread_setspecific(exit_hook_key, (void *)1);
+#endif
+    exit_hook_armed = 1;
+}
+
+static slab_tls_t *slab_tls_find(uint64_t uid) {
+    for (uint32_t i = 0; i < SLAB_TLS_SLOTS; i++) {
+        if (slab_tls[i].uid == uid) return &slab_tls[i];
+    }
+    for (slab_tls_t *entry = slab_tls_overflow; entry; entry = entry->next) {
+        if (entry->uid == uid) return entry;
+    }
+    return NULL;
+}
+
+// Forget entries of slabs destroyed since they were cached; their heaps
+// went with the slab.
+static void slab_tls_purge(void) {
+    registry_acquire();
+    for (uint32_t i = 0; i < SLAB_TLS_SLOTS; i++) {
+        if (slab_tls[i].uid && !registry_contains(slab_tls[i].uid)) {
+            slab_tls[i].uid = 0;
+            slab_tls[i].heap = NULL;
+        }
+    }
+    slab_tls_t **link = &slab_tls_overflow;
+    while (*link) {
+        slab_tls_t *entry = *link;
+        if (entry->uid && registry_contains(entry->uid)) {
+            link = &entry->next;
+            continue;
+        }
+        *link = entry->next;
+        free(entry);
+        slab_tls_overflow_count--;
+    }
+    registry_release();
+    slab_tls_purge_at = slab_tls_overflow_count * 2 > SLAB_TLS_SLOTS ? slab_tls_overflow_count * 2 : SLAB_TLS_SLOTS;
+}
+
+// Find a free entry for uid, preferring its own slot.
+static slab_tls_t *slab_tls_insert(uint64_t uid) {
+    slab_tls_t *home = &slab_tls[uid % SLAB_TLS_SLOTS];
+    if (!home->uid) return home;
+    for (uint32_t i = 0; i < SLAB_TLS_SLOTS; i++) {
+        if (!slab_tls[i].uid) return &slab_tls[i];
+    }
+
+    if (slab_tls_overflow_count >= slab_tls_purge_at) {
+        slab_tls_purge();
+        if (!home->uid) return home;
+        for (uint32_t i = 0; i < SLAB_TLS_SLOTS; i++) {
+            if (!slab_tls[i].uid) return &slab_tls[i];
+        }
+    }
+    for (slab_tls_t *entry = slab_tls_overflow; entry; entry = entry->next) {
+        if (!entry->uid) return entry;
+    }
+
+    slab_tls_t *entry = (slab_tls_t *)malloc(sizeof(*entry));
+    if (!entry) return NULL;
+    entry->uid = 0;
+    entry->heap = NULL;
+    entry->next = slab_tls_overflow;
+    slab_tls_overflow = entry;
+    slab_tls_overflow_count++;
+    return entry;
+}
+
+static fossil_slab_heap_t *slab_heap_attach(fossil_slab_t *slab) {
+    slab_tls_t *entry = slab_tls_find(slab->uid);
+    if (entry) return entry->heap;
+
+    entry = slab_tls_insert(slab->uid);
+    if (!entry) return NULL;
+    exit_hook_arm();
+
+    fossil_slab_heap_t *heap = NULL;
+    fossil_mutex_lock(&slab->mutex);
+    for (fossil_slab_heap_t *it = slab->heaps; it; it = it->next) {
+        uint32_t expected = HEAP_ABANDONED;
+        if (__atomic_load_n(&it->state, __ATOMIC_RELAXED) == HEAP_ABANDONED &&
+            __atomic_compare_exchange_n(&it->state, &expected, HEAP_ACTIVE, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            heap = it;
+            break;
+        }
+    }
+    if (!heap) {
+        heap = (fossil_slab_heap_t *)fossil_platform_aligned_alloc(FOSSIL_CACHE_LINE, sizeof(*heap));
+        if (heap) {
+            memset(heap, 0, sizeof(*heap));
+            heap->slab = slab;
+            heap->state = HEAP_ACTIVE;
+            heap->next = slab->heaps;
+            slab->heaps = heap;
+        }
+    }
+    fossil_mutex_unlock(&slab->mutex);
+
+    if (heap) {
+        entry->uid = slab->uid;
+        entry->heap = heap;
+    }
+    return heap;
+}
+
+static inline fossil_slab_heap_t *slab_heap(fossil_slab_t *slab) {
+    slab_tls_t *entry = &slab_tls[slab->uid % SLAB_TLS_SLOTS];
+    if (entry->uid == slab->uid) return entry->heap;
+    return slab_heap_attach(slab);
+}
+
+// Move free objects from one page into the magazine, reclaiming remote frees
+// once the page's local list runs dry.
+static void slab_page_take(fossil_slab_t *slab, fossil_slab_heap_t *heap, slab_page_t *page) {
+    if (!page->local_free && __atomic_load_n(&page->remote_free, __ATOMIC_RELAXED)) {
+        page->local_free = __atomic_exchange_n(&page->remote_free, NULL, __ATOMIC_ACQUIRE);
+    }
+    while (heap->count < SLAB_REFILL && page->local_free) {
+        void *obj = page->local_free;
+        page->local_free = *(void **)obj;
+        heap->magazine[heap->count++] = obj;
+    }
+    while (heap->count < SLAB_REFILL && page->bump < page->capacity) {
+        heap->magazine[heap->count++] = (char *)page + SLAB_PAGE_HEADER + (size_t)page->bump * slab->object_size;
+        page->bump++;
+    }
+}
+
+static uint32_t slab_refill(fossil_slab_t *slab, fossil_slab_heap_t *heap) {
+    slab_page_t *start = heap->cursor ? heap->cursor : heap->pages;
+    slab_page_t *page = start;
+
+    while (page) {
+        slab_page_take(slab, heap, page);
+        if (heap->count >= SLAB_REFILL) break;
+        page = page->next ? page->next : heap->pages;
+        if (page == start) break;
+    }
+    heap->cursor = page;
+    if (heap->count) return heap->count;
+
+    page = (slab_page_t *)fossil_platform_aligned_alloc(FOSSIL_SLAB_PAGE_SIZE, FOSSIL_SLAB_PAGE_SIZE);
+    if (!page) return 0;
+    page->heap = heap;
+    page->local_free = NULL;
+    page->remote_free = NULL;
+    page->bump = 0;
+    page->capacity = slab->objects_per_page;
+    page->next = heap->pages;
+    heap->pages = page;
+    heap->cursor = page;
+
+    slab_page_take(slab, heap, page);
+    return heap->count;
+}
+
+// Return the top half of a full magazine to the owner's pages.
+static void slab_drain(fossil_slab_heap_t *heap) {
+    while (heap->count > SLAB_MAGAZINE / 2) {
+        void *obj = heap->magazine[--heap->count];
+        slab_page_t *page = slab_page_of(obj);
+        *(void **)obj = page->local_free;
+        page->local_free = obj;
+    }
+}
+
+int32_t fossil_slab_create(fossil_slab_t *slab, size_t object_size) {
+    if (object_size == 0 || object_size > FOSSIL_SLAB_MAX_OBJECT) return -1;
+
+    slab->object_size = (object_size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+    slab->objects_per_page = (uint32_t)((FOSSIL_SLAB_PAGE_SIZE - SLAB_PAGE_HEADER) / slab->object_size);
+    slab->heaps = NULL;
+    slab->uid = __atomic_fetch_add(&next_uid, 1, __ATOMIC_RELAXED);
+    if (fossil_mutex_create(&slab->mutex) != 0) return -1;
+
+    registry_acquire();
+    int32_t status = registry_add(slab->uid);
+    registry_release();
+    if (status != 0) fossil_mutex_destroy(&slab->mutex);
+    return status;
+}
+
+void *fossil_slab_alloc(fossil_slab_t *slab) {
+    fossil_slab_heap_t *heap = slab_heap(slab);
+    if (!heap) return NULL;
+    if (heap->count == 0 && slab_refill(slab, heap) == 0) return NULL;
+    return heap->magazine[--heap->count];
+}
+
+void fossil_slab_free(fossil_slab_t *slab, void *ptr) {
+    if (!ptr) return;
+
+    fossil_slab_heap_t *heap = slab_heap(slab);
+    slab_page_t *page = slab_page_of(ptr);
+
+    if (heap && page->heap == heap) {
+        if (heap->count == SLAB_MAGAZINE) slab_drain(heap);
+        heap->magazine[heap->count++] = ptr;
+        return;
+    }
+
+    if (!heap) {
+        // No cache for this thread: push straight to the owner.
+        void *old = __atomic_load_n(&page->remote_free, __ATOMIC_RELAXED);
+        do {
+            *(void **)ptr = old;
+        } while (!__atomic_compare_exchange_n(&page->remote_free, &old, ptr, 1,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+        return;
+    }
+
+    heap->remote[heap->remote_count++] = ptr;
+    if (heap->remote_count == SLAB_REMOTE_BATCH) slab_flush_remote(heap);
+}
+
+void fossil_slab_flush(fossil_slab_t *slab) {
+    slab_tls_t *entry = slab_tls_find(slab->uid);
+    if (entry) slab_flush_remote(entry->heap);
+}
+
+int32_t fossil_slab_destroy(fossil_slab_t *slab) {
+    registry_acquire();
+    for (uint32_t i = 0; i < registry_size; i++) {
+        if (registry[i] == slab->uid) registry[i] = 0;
+    }
+    registry_release();
+
+    fossil_slab_heap_t *heap = slab->heaps;
+    while (heap) {
+        fossil_slab_heap_t *next_heap = heap->next;
+        slab_page_t *page = heap->pages;
+        while (page) {
+            slab_page_t *next_page = page->next;
+            fossil_platform_aligned_free(page);
+            page = next_page;
+        }
+        fossil_platform_aligned_free(heap);
+        heap = next_heap;
+    }
+    slab->heaps = NULL;
+
+    slab_tls_t *entry = slab_tls_find(slab->uid);
+    if (entry) {
+        entry->uid = 0;
+        entry->heap = NULL;
+    }
+    return fossil_mutex_destroy(&slab->mutex) == 0 ? 0 : -1;
+}
+
+/* -------- Built-in Size Classes -------- */
+
+static const size_t class_sizes[FOSSIL_SLAB_SIZE_CLASSES] = { 16, 32, 64, 128, 256, 512, 1024, 2048 };
+static fossil_slab_t class_slabs[FOSSIL_SLAB_SIZE_CLASSES];
+static uint32_t class_state = 0;
+
+static void class_init(void) {
+    for (uint32_t i = 0; i < FOSSIL_SLAB_SIZE_CLASSES; i++) {
+        fossil_slab_create(&class_slabs[i], class_sizes[i]);
+    }
+}
+
+static inline int32_t class_index(size_t size) {
+    for (int32_t i = 0; i < FOSSIL_SLAB_SIZE_CLASSES; i++) {
+        if (size <= class_sizes[i]) return i;
+    }
+    return -1;
+}
+
+void *fossil_slab_alloc_size(size_t size) {
+    int32_t index = class_index(size);
+    if (index < 0) return malloc(size);
+    fossil_platform_once(&class_state, class_init);
+    return fossil_slab_alloc(&class_slabs[index]);
+}
+
+void fossil_slab_free_size(void *ptr, size_t size) {
+    int32_t index = class_index(size);
+    if (index < 0) {
+        free(ptr);
+        return;
+    }
+    fossil_slab_free(&class_slabs[index], ptr);
+}
+
+/* -------- Bump Arena -------- */
+
+#define ARENA_DEFAULT_CHUNK (64 * 1024)
+
+struct fossil_arena_chunk_t {
+    fossil_arena_chunk_t *next;
+    size_t size;
+    size_t used;
+};
+
+#define ARENA_HEADER ((sizeof(fossil_arena_chunk_t) + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1))
+
+int32_t fossil_arena_create(fossil_arena_t *arena, size_t chunk_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK;
+    return 0;
+}
+
+void *fossil_arena_alloc(fossil_arena_t *arena, size_t size) {
+    size = (size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+    fossil_arena_chunk_t *chunk = arena->current;
+
+    // Chunks past current were filled before the last reset: recycle them.
+    while (chunk) {
+        if (chunk->size - chunk->used >= size) {
+            void *ptr = (char *)chunk + ARENA_HEADER + chunk->used;
+            chunk->used += size;
+            arena->current = chunk;
+            return ptr;
+        }
+        if (!chunk->next) break;
+        chunk = chunk->next;
+        chunk->used = 0;
+    }
+
+    size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+    fossil_arena_chunk_t *fresh = (fossil_arena_chunk_t *)malloc(ARENA_HEADER + capacity);
+    if (!fresh) return NULL;
+    fresh->size = capacity;
+    fresh->used = size;
+
+    if (arena->current) {
+        fresh->next = arena->current->next;
+        arena->current->next = fresh;
+    } else {
+        fresh->next = arena->first;
+        arena->first = fresh;
+    }
+    arena->current = fresh;
+    return (char *)fresh + ARENA_HEADER;
+}
+
+void fossil_arena_reset(fossil_arena_t *arena) {
+    arena->current = arena->first;
+    if (arena->first) arena->first->used = 0;
+}
+
+int32_t fossil_arena_destroy(fossil_arena_t *arena) {
+    fossil_arena_chunk_t *chunk = arena->first;
+    while (chunk) {
+        fossil_arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    return 0;
+}
@@ -12,10 +12,240 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/threads/sync.h"
+#include "fossil/threads/pool.h"
+#include "platform.h"
 #include <stdlib.h>
+#include <string.h>
+
+/* -------- Lock Contention Profiler -------- */
+
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+#define PROFILE_SLOTS 4096
+#define PROFILE_HELD_MAX 16
+
+typedef struct {
+    uint64_t key;
+    uint32_t ready;
+    const void *lock;
+    const void *call_site;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+    uint64_t max_wait_ns;
+    uint64_t hold_ns;
+    uint64_t max_hold_ns;
+} profile_slot_t;
+
+typedef struct {
+    const void *lock;
+    profile_slot_t *slot;
+    uint64_t acquired_ns;
+    uint32_t weight;
+} profile_held_t;
+
+static profile_slot_t profile_table[PROFILE_SLOTS];
+static uint32_t profile_period = 0;
+
+static FOSSIL_THREAD_LOCAL uint32_t profile_countdown = 0;
+static FOSSIL_THREAD_LOCAL uint32_t profile_depth = 0;
+static FOSSIL_THREAD_LOCAL profile_held_t profile_held[PROFILE_HELD_MAX];
+
+// Returns the weight of this acquisition if it should be measured, else 0.
+// The weight is the sample period in force now, so that samples taken under
+// different periods each stand for the acquisitions they represent.
+static inline uint32_t profile_sample(void) {
+    uint32_t period = __atomic_load_n(&profile_period, __ATOMIC_RELAXED);
+    if (period == 0) return 0;
+    if (profile_countdown > 1 && profile_countdown <= period) {
+        profile_countdown--;
+        return 0;
+    }
+    profile_countdown = period;
+    return period;
+}
+
+static uint64_t profile_hash(const void *lock, const void *call_site) {
+    uint64_t h = (uint64_t)(uintptr_t)lock * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(uintptr_t)call_site + 0x7F4A7C159E3779B9ull + (h << 6) + (h >> 2);
+    return h ? h : 1;
+}
+
+static profile_slot_t *profile_lookup(const void *lock, const void *call_site) {
+    uint64_t key = profile_hash(lock, call_site);
+
+    for (uint32_t probe = 0; probe < PROFILE_SLOTS; probe++) {
+        profile_slot_t *slot = &profile_table[(key + probe) % PROFILE_SLOTS];
+        uint64_t current = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+
+        if (current == 0) {
+            uint64_t expected = 0;
+            if (__atomic_compare_exchange_n(&slot->key, &expected, key, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                slot->lock = lock;
+                slot->call_site = call_site;
+                __atomic_store_n(&slot->ready, 1, __ATOMIC_RELEASE);
+                return slot;
+            }
+            current = expected;
+        }
+
+        if (current == key) {
+            while (!__atomic_load_n(&slot->ready, __ATOMIC_ACQUIRE)) {
+                fossil_platform_relax();
+            }
+            if (slot->lock == lock && slot->call_site == call_site) return slot;
+        }
+    }
+    return NULL; // Table full: drop the sample.
+}
+
+static void profile_max(uint64_t *target, uint64_t value) {
+    uint64_t current = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value > current &&
+           !__atomic_compare_exchange_n(target, &current, value, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void profile_acquired(const void *lock, const void *call_site, uint32_t weight, int32_t contended,
+                             uint64_t start_ns, uint64_t acquired_ns, int32_t track_hold) {
+    profile_slot_t *slot = profile_lookup(lock, call_site);
+    if (!slot) return;
+
+    __atomic_fetch_add(&slot->acquisitions, weight, __ATOMIC_RELAXED);
+    if (contended) {
+        uint64_t wait = acquired_ns - start_ns;
+        __atomic_fetch_add(&slot->contended, weight, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&slot->wait_ns, wait * weight, __ATOMIC_RELAXED);
+        profile_max(&slot->max_wait_ns, wait);
+    }
+
+    if (track_hold && profile_depth < PROFILE_HELD_MAX) {
+        profile_held[profile_depth].lock = lock;
+        profile_held[profile_depth].slot = slot;
+        profile_held[profile_depth].acquired_ns = acquired_ns;
+        profile_held[profile_depth].weight = weight;
+        profile_depth++;
+    }
+}
+
+static void profile_released(const void *lock) {
+    for (uint32_t i = profile_depth; i-- > 0;) {
+        if (profile_held[i].lock != lock) continue;
+
+        uint64_t hold = fossil_platform_now_ns() - profile_held[i].acquired_ns;
+        __atomic_fetch_add(&profile_held[i].slot->hold_ns, hold * profile_held[i].weight, __ATOMIC_RELAXED);
+        profile_max(&profile_held[i].slot->max_hold_ns, hold);
+
+        profile_held[i] = profile_held[--profile_depth];
+        return;
+    }
+}
+
+static int profile_compare(const void *a, const void *b) {
+    const fossil_lock_profile_entry_t *x = (const fossil_lock_profile_entry_t *)a;
+    const fossil_lock_profile_entry_t *y = (const fossil_lock_profile_entry_t *)b;
+    if (x->wait_ns != y->wait_ns) return x->wait_ns < y->wait_ns ? 1 : -1;
+    if (x->contended != y->contended) return x->contended < y->contended ? 1 : -1;
+    return x->acquisitions < y->acquisitions ? 1 : (x->acquisitions > y->acquisitions ? -1 : 0);
+}
+#endif
+
+int32_t fossil_lock_profile_enable(uint32_t sample_period) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    __atomic_store_n(&profile_period, sample_period, __ATOMIC_RELAXED);
+    return 0;
+#else
+    (void)sample_period;
+    return -1;
+#endif
+}
+
+int32_t fossil_lock_profile_reset(void) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    for (uint32_t i = 0; i < PROFILE_SLOTS; i++) {
+        profile_slot_t *slot = &profile_table[i];
+        __atomic_store_n(&slot->acquisitions, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->contended, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->wait_ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->max_wait_ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->hold_ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->max_hold_ns, 0, __ATOMIC_RELAXED);
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int32_t fossil_lock_profile_snapshot(fossil_lock_profile_entry_t *entries, uint32_t max_entries) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    fossil_lock_profile_entry_t *all = (fossil_lock_profile_entry_t *)malloc(PROFILE_SLOTS * sizeof(*all));
+    if (!all) return -1;
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < PROFILE_SLOTS; i++) {
+        profile_slot_t *slot = &profile_table[i];
+        if (!__atomic_load_n(&slot->ready, __ATOMIC_ACQUIRE)) continue;
+
+        uint64_t acquisitions = __atomic_load_n(&slot->acquisitions, __ATOMIC_RELAXED);
+        if (acquisitions == 0) continue;
+
+        fossil_lock_profile_entry_t *entry = &all[count++];
+        entry->lock = slot->lock;
+        entry->call_site = slot->call_site;
+        entry->acquisitions = acquisitions;
+        entry->contended = __atomic_load_n(&slot->contended, __ATOMIC_RELAXED);
+        entry->wait_ns = __atomic_load_n(&slot->wait_ns, __ATOMIC_RELAXED);
+        entry->max_wait_ns = __atomic_load_n(&slot->max_wait_ns, __ATOMIC_RELAXED);
+        entry->hold_ns = __atomic_load_n(&slot->hold_ns, __ATOMIC_RELAXED);
+        entry->max_hold_ns = __atomic_load_n(&slot->max_hold_ns, __ATOMIC_RELAXED);
+    }
+
+    qsort(all, count, sizeof(*all), profile_compare);
+    if (count > max_entries) count = max_entries;
+    memcpy(entries, all, count * sizeof(*all));
+    free(all);
+    return (int32_t)count;
+#else
+    (void)entries;
+    (void)max_entries;
+    return -1;
+#endif
+}
+
+int32_t fossil_lock_profile_report(FILE *out, uint32_t max_entries) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    fossil_lock_profile_entry_t *entries = (fossil_lock_profile_entry_t *)malloc(
+        (max_entries ? max_entries : 1) * sizeof(*entries));
+    if (!entries) return -1;
+
+    int32_t count = fossil_lock_profile_snapshot(entries, max_entries);
+    fprintf(out, "%-18s %-18s %12s %12s %14s %12s %14s %12s\n",
+            "lock", "call_site", "acquired", "contended", "wait_ns", "max_wait", "hold_ns", "max_hold");
+    for (int32_t i = 0; i < count; i++) {
+        fossil_lock_profile_entry_t *e = &entries[i];
+        fprintf(out, "%-18p %-18p %12llu %12llu %14llu %12llu %14llu %12llu\n",
+                e->lock, e->call_site,
+                (unsigned long long)e->acquisitions, (unsigned long long)e->contended,
+                (unsigned long long)e->wait_ns, (unsigned long long)e->max_wait_ns,
+                (unsigned long long)e->hold_ns, (unsigned long long)e->max_hold_ns);
+    }
+
+    free(entries);
+    return count < 0 ? -1 : 0;
+#else
+    (void)out;
+    (void)max_entries;
+    return -1;
+#endif
+}
 
 /* -------- Syncronization Primitives Implementation -------- */
 
+// Retries of a contended mutex before its caller counts as blocked.
+#define MUTEX_SPIN_COUNT 64
+
 int32_t fossil_mutex_create(fossil_mutex_t *mutex) {
 #ifdef _WIN32
     *mutex = CreateMutex(NULL, FALSE, NULL);
@@ -25,15 +255,59 @@ int32_t fossil_mutex_create(fossil_mutex_t *mutex) {
 #endif
 }
 
-int32_t fossil_mutex_lock(fossil_mutex_t *mutex) {
+static int32_t mutex_trylock(fossil_mutex_t *mutex) {
+#ifdef _WIN32
+    return WaitForSingleObject(*mutex, 0) == WAIT_OBJECT_0 ? 0 : -1;
+#else
+    return pthread_mutex_trylock(mutex);
+#endif
+}
+
+// A contended lock is retried briefly before the caller counts as blocked,
+// so that short critical sections never bring in a spare pool worker.
+static int32_t mutex_lock_contended(fossil_mutex_t *mutex) {
+    for (uint32_t i = 0; i < MUTEX_SPIN_COUNT; i++) {
+        fossil_platform_relax();
+        if (mutex_trylock(mutex) == 0) return 0;
+    }
+
+    fossil_thread_pool_enter_blocking();
 #ifdef _WIN32
-    return WaitForSingleObject(*mutex, INFINITE) == WAIT_OBJECT_0 ? 0 : -1;
+    int32_t status = WaitForSingleObject(*mutex, INFINITE) == WAIT_OBJECT_0 ? 0 : -1;
 #else
-    return pthread_mutex_lock(mutex);
+    int32_t status = pthread_mutex_lock(mutex);
+#endif
+    fossil_thread_pool_leave_blocking();
+    return status;
+}
+
+static int32_t mutex_lock(fossil_mutex_t *mutex) {
+    if (mutex_trylock(mutex) == 0) return 0;
+    return mutex_lock_contended(mutex);
+}
+
+int32_t fossil_mutex_lock(fossil_mutex_t *mutex) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    uint32_t weight = profile_sample();
+    if (weight) {
+        uint64_t start = fossil_platform_now_ns();
+        int32_t contended = mutex_trylock(mutex) != 0;
+        if (contended) {
+            int32_t status = mutex_lock_contended(mutex);
+            if (status != 0) return status;
+        }
+        uint64_t acquired = contended ? fossil_platform_now_ns() : start;
+        profile_acquired(mutex, FOSSIL_RETURN_ADDRESS(), weight, contended, start, acquired, 1);
+        return 0;
+    }
 #endif
+    return mutex_lock(mutex);
 }
 
 int32_t fossil_mutex_unlock(fossil_mutex_t *mutex) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    if (profile_depth) profile_released(mutex);
+#endif
 #ifdef _WIN32
     return ReleaseMutex(*mutex) ? 0 : -1;
 #else
@@ -59,13 +333,16 @@ int32_t fossil_cond_create(fossil_cond_t *cond) {
 }
 
 int32_t fossil_cond_wait(fossil_cond_t *cond, fossil_mutex_t *mutex) {
+    fossil_thread_pool_enter_blocking();
 #ifdef _WIN32
     ReleaseMutex(*mutex);
     WaitForSingleObject(*cond, INFINITE);
-    return WaitForSingleObject(*cond, INFINITE) == WAIT_OBJECT_0 ? 0 : -1;
+    int32_t status = WaitForSingleObject(*cond, INFINITE) == WAIT_OBJECT_0 ? 0 : -1;
 #else
-    return pthread_cond_wait(cond, mutex);
+    int32_t status = pthread_cond_wait(cond, mutex);
 #endif
+    fossil_thread_pool_leave_blocking();
+    return status;
 }
 
 int32_t fossil_cond_signal(fossil_cond_t *cond) {
@@ -98,8 +375,27 @@ int32_t fossil_semaphore_create(fossil_semaphore_t *sem, unsigned int value) {
     return *sem ? 0 : -1;
 }
 
+static int32_t semaphore_block(fossil_semaphore_t *sem) {
+    fossil_thread_pool_enter_blocking();
+    int32_t status = WaitForSingleObject(*sem, INFINITE) == WAIT_OBJECT_0 ? 0 : -1;
+    fossil_thread_pool_leave_blocking();
+    return status;
+}
+
 int32_t fossil_semaphore_wait(fossil_semaphore_t *sem) {
-    return WaitForSingleObject(*sem, INFINITE) == WAIT_OBJECT_0 ? 0 : -1;
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    uint32_t weight = profile_sample();
+    if (weight) {
+        uint64_t start = fossil_platform_now_ns();
+        int32_t contended = WaitForSingleObject(*sem, 0) != WAIT_OBJECT_0;
+        if (contended && semaphore_block(sem) != 0) return -1;
+        profile_acquired(sem, FOSSIL_RETURN_ADDRESS(), weight, contended, start,
+                         contended ? fossil_platform_now_ns() : start, 0);
+        return 0;
+    }
+#endif
+    if (WaitForSingleObject(*sem, 0) == WAIT_OBJECT_0) return 0;
+    return semaphore_block(sem);
 }
 
 int32_t fossil_semaphore_post(fossil_semaphore_t *sem) {
@@ -125,12 +421,30 @@ int32_t fossil_semaphore_create(fossil_semaphore_t *sem, unsigned int value) {
 }
 
 int32_t fossil_semaphore_wait(fossil_semaphore_t *sem) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    uint32_t weight = profile_sample();
+    uint64_t start = weight ? fossil_platform_now_ns() : 0;
+    int32_t contended = 0;
+#endif
     pthread_mutex_lock(&sem->mutex);
-    while (sem->value == 0) {
-        pthread_cond_wait(&sem->cond, &sem->mutex);
+    if (sem->value == 0) {
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+        contended = 1;
+#endif
+        fossil_thread_pool_enter_blocking();
+        while (sem->value == 0) {
+            pthread_cond_wait(&sem->cond, &sem->mutex);
+        }
+        fossil_thread_pool_leave_blocking();
     }
     sem->value--;
     pthread_mutex_unlock(&sem->mutex);
+#ifdef FOSSIL_THREADS_LOCK_PROFILER
+    if (weight) {
+        profile_acquired(sem, FOSSIL_RETURN_ADDRESS(), weight, contended, start,
+                         contended ? fossil_platform_now_ns() : start, 0);
+    }
+#endif
     return 0;
 }
 
@@ -148,3 +462,226 @@ int32_t fossil_semaphore_destroy(fossil_semaphore_t *sem) {
     return 0;
 }
 #endif
+
+int32_t fossil_eventcount_create(fossil_eventcount_t *ec) {
+    ec->epoch = 0;
+    ec->waiters = 0;
+    return 0;
+}
+
+uint32_t fossil_eventcount_prepare_wait(fossil_eventcount_t *ec) {
+    __atomic_fetch_add(&ec->waiters, 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&ec->epoch, __ATOMIC_SEQ_CST);
+}
+
+void fossil_eventcount_cancel_wait(fossil_eventcount_t *ec) {
+    __atomic_fetch_sub(&ec->waiters, 1, __ATOMIC_SEQ_CST);
+}
+
+int32_t fossil_eventcount_wait(fossil_eventcount_t *ec, uint32_t key) {
+    if (__atomic_load_n(&ec->epoch, __ATOMIC_ACQUIRE) == key) {
+        fossil_thread_pool_enter_blocking();
+        while (__atomic_load_n(&ec->epoch, __ATOMIC_ACQUIRE) == key) {
+            fossil_platform_futex_wait(&ec->epoch, key, FOSSIL_PLATFORM_INFINITE);
+        }
+        fossil_thread_pool_leave_blocking();
+    }
+    __atomic_fetch_sub(&ec->waiters, 1, __ATOMIC_SEQ_CST);
+    return 0;
+}
+
+int32_t fossil_eventcount_notify(fossil_eventcount_t *ec) {
+    // Pairs with the increment in prepare_wait: either the waiter sees the
+    // notifier's state change, or we see the waiter and bump the epoch.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ec->waiters, __ATOMIC_RELAXED) == 0) return 0;
+
+    __atomic_fetch_add(&ec->epoch, 1, __ATOMIC_SEQ_CST);
+    fossil_platform_futex_wake(&ec->epoch, UINT32_MAX);
+    return 0;
+}
+
+int32_t fossil_eventcount_destroy(fossil_eventcount_t *ec) {
+    return __atomic_load_n(&ec->waiters, __ATOMIC_ACQUIRE) == 0 ? 0 : -1;
+}
+
+/* -------- Barrier and Latch -------- */
+
+/*
+ * A barrier phase ends when the arrival counter hits zero. The thread that
+ * brings it there resets the counter and bumps the phase word, which every
+ * other thread spins on and, failing that, parks on. The tree form keeps
+ * one counter per group of fanin threads; the last arrival at a node goes
+ * on to the parent, so only the winner of the root bumps the phase. Every
+ * counter is reset before the phase moves, and the next phase starts only
+ * after a thread has seen it move.
+ */
+
+#define BARRIER_SPIN_COUNT 4096
+#define BARRIER_ROOT UINT32_MAX
+
+struct fossil_barrier_node_t {
+    FOSSIL_CACHE_ALIGNED uint32_t remaining;
+    uint32_t count;
+    uint32_t parent;
+};
+
+static uint32_t barrier_default_spin(void) {
+    return fossil_platform_cpu_count() > 1 ? BARRIER_SPIN_COUNT : 0;
+}
+
+static int32_t barrier_release(fossil_barrier_t *barrier, uint32_t phase) {
+    __atomic_store_n(&barrier->phase, phase + 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&barrier->waiters, __ATOMIC_RELAXED)) {
+        fossil_platform_futex_wake(&barrier->phase, UINT32_MAX);
+    }
+    return 1;
+}
+
+static int32_t barrier_await(fossil_barrier_t *barrier, uint32_t phase) {
+    uint32_t spins = __atomic_load_n(&barrier->spin_count, __ATOMIC_RELAXED);
+    for (uint32_t i = 0; i < spins; i++) {
+        if (__atomic_load_n(&barrier->phase, __ATOMIC_ACQUIRE) != phase) return 0;
+        fossil_platform_relax();
+    }
+
+    fossil_thread_pool_enter_blocking();
+    __atomic_fetch_add(&barrier->waiters, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&barrier->phase, __ATOMIC_SEQ_CST) == phase) {
+        fossil_platform_futex_wait(&barrier->phase, phase, FOSSIL_PLATFORM_INFINITE);
+    }
+    __atomic_fetch_sub(&barrier->waiters, 1, __ATOMIC_RELAXED);
+    fossil_thread_pool_leave_blocking();
+    return 0;
+}
+
+int32_t fossil_barrier_create(fossil_barrier_t *barrier, uint32_t count) {
+    if (!barrier || count == 0) return -1;
+    memset(barrier, 0, sizeof(*barrier));
+    barrier->count = count;
+    barrier->remaining = count;
+    barrier->spin_count = barrier_default_spin();
+    return 0;
+}
+
+int32_t fossil_barrier_create_tree(fossil_barrier_t *barrier, uint32_t count, uint32_t fanin) {
+    if (!barrier || count == 0 || fanin < 2) return -1;
+    if (fossil_barrier_create(barrier, count) != 0) return -1;
+
+    uint32_t total = 0;
+    for (uint32_t width = count; width > 1 || total == 0;) {
+        width = (width + fanin - 1) / fanin;
+        total += width;
+    }
+
+    barrier->nodes = (fossil_barrier_node_t *)fossil_platform_aligned_alloc(
+        FOSSIL_CACHE_LINE, total * sizeof(fossil_barrier_node_t));
+    if (!barrier->nodes) return -1;
+    barrier->num_nodes = total;
+
+    // Levels are laid out leaves first; node j of a level serves children
+    // j * fanin .. j * fanin + fanin - 1 of the level below.
+    uint32_t below = count;
+    uint32_t offset = 0;
+    do {
+        uint32_t width = (below + fanin - 1) / fanin;
+        for (uint32_t j = 0; j < width; j++) {
+            fossil_barrier_node_t *node = &barrier->nodes[offset + j];
+            uint32_t children = below - j * fanin;
+            node->count = children < fanin ? children : fanin;
+            node->remaining = node->count;
+            node->parent = width == 1 ? BARRIER_ROOT : offset + width + j / fanin;
+        }
+        offset += width;
+        below = width;
+    } while (below > 1);
+
+    barrier->fanin = fanin;
+    return 0;
+}
+
+int32_t fossil_barrier_set_spin(fossil_barrier_t *barrier, uint32_t spin_count) {
+    __atomic_store_n(&barrier->spin_count, spin_count, __ATOMIC_RELAXED);
+    return 0;
+}
+
+int32_t fossil_barrier_wait(fossil_barrier_t *barrier) {
+    if (barrier->nodes) return -1;
+
+    uint32_t phase = __atomic_load_n(&barrier->phase, __ATOMIC_ACQUIRE);
+    if (__atomic_sub_fetch(&barrier->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+        __atomic_store_n(&barrier->remaining, barrier->count, __ATOMIC_RELAXED);
+        return barrier_release(barrier, phase);
+    }
+    return barrier_await(barrier, phase);
+}
+
+int32_t fossil_barrier_wait_id(fossil_barrier_t *barrier, uint32_t id) {
+    if (id >= barrier->count) return -1;
+    if (!barrier->nodes) return fossil_barrier_wait(barrier);
+
+    uint32_t phase = __atomic_load_n(&barrier->phase, __ATOMIC_ACQUIRE);
+    uint32_t index = id / barrier->fanin;
+    while (1) {
+        fossil_barrier_node_t *node = &barrier->nodes[index];
+        if (__atomic_sub_fetch(&node->remaining, 1, __ATOMIC_ACQ_REL) != 0) {
+            return barrier_await(barrier, phase);
+        }
+        __atomic_store_n(&node->remaining, node->count, __ATOMIC_RELAXED);
+        if (node->parent == BARRIER_ROOT) return barrier_release(barrier, phase);
+        index = node->parent;
+    }
+}
+
+int32_t fossil_barrier_destroy(fossil_barrier_t *barrier) {
+    if (__atomic_load_n(&barrier->waiters, __ATOMIC_ACQUIRE) != 0) return -1;
+    fossil_platform_aligned_free(barrier->nodes);
+    barrier->nodes = NULL;
+    barrier->num_nodes = 0;
+    return 0;
+}
+
+int32_t fossil_latch_create(fossil_latch_t *latch, uint32_t count) {
+    latch->count = count;
+    return 0;
+}
+
+int32_t fossil_latch_count_down(fossil_latch_t *latch, uint32_t n) {
+    uint32_t count = __atomic_load_n(&latch->count, __ATOMIC_RELAXED);
+    do {
+        if (n > count) return -1;
+    } while (!__atomic_compare_exchange_n(&latch->count, &count, count - n, 1,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    // A latch reaches zero once, so an unconditional wake costs one system
+    // call per latch and never reads the latch after the final store.
+    if (n && count == n) fossil_platform_futex_wake(&latch->count, UINT32_MAX);
+    return 0;
+}
+
+int32_t fossil_latch_try_wait(fossil_latch_t *latch) {
+    return __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE) == 0;
+}
+
+int32_t fossil_latch_wait(fossil_latch_t *latch) {
+    uint32_t count = __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE);
+    if (count == 0) return 0;
+
+    fossil_thread_pool_enter_blocking();
+    do {
+        fossil_platform_futex_wait(&latch->count, count, FOSSIL_PLATFORM_INFINITE);
+    } while ((count = __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE)) != 0);
+    fossil_thread_pool_leave_blocking();
+    return 0;
+}
+
+int32_t fossil_latch_arrive_and_wait(fossil_latch_t *latch) {
+    if (fossil_latch_count_down(latch, 1) != 0) return -1;
+    return fossil_latch_wait(latch);
+}
+
+int32_t fossil_latch_destroy(fossil_latch_t *latch) {
+    (void)latch;
+    return 0;
+}
@@ -12,6 +12,7 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/threads/threads.h"
+#include "platform.h"
 #include <stdlib.h>
 
 #ifdef _WIN32
@@ -32,9 +33,237 @@ static DWORD WINAPI fossil_thread_wrapper(LPVOID arg) {
 }
 #endif
 
+/* -------- Thread Reuse Cache -------- */
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#define THREAD_CACHE 1
+
+/*
+ * With the cache enabled, every thread created runs on a detached host
+ * thread that parks after its task instead of exiting. The handle given to
+ * the caller is the host's cell with the low bit set; native pthread_t
+ * values are aligned pointers on these platforms, so they never have it.
+ * Cells are never freed: a cell whose host exits goes to a spare list.
+ */
+_Static_assert(sizeof(pthread_t) >= sizeof(void *), "pthread_t must hold a pointer");
+
+enum {
+    CELL_IDLE,     // Parked in the cache.
+    CELL_RUNNING,  // Running a joinable task.
+    CELL_DETACHED, // Running a detached task.
+    CELL_FINISHED, // Joinable task done, result waiting for the joiner.
+    CELL_RELEASED, // Joined or detached after finishing, with no room to park.
+    CELL_RETIRED   // Told to exit while parked.
+};
+
+typedef struct thread_cell_t {
+    uint32_t state;
+    fossil_task_t task;
+    void *arg;
+    void *result;
+    size_t stack_size;
+    size_t guard_size;
+    struct thread_cell_t *next;
+} thread_cell_t;
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static thread_cell_t *cache_idle = NULL;
+static thread_cell_t *cache_spare = NULL;
+static uint32_t cache_idle_count = 0;
+static uint32_t cache_limit = 0;
+static size_t cache_default_stack = 0;
+static size_t cache_default_guard = 0;
+
+static inline int32_t cache_is_cell(fossil_thread_t thread) {
+    return ((uintptr_t)thread & 1) != 0;
+}
+
+static inline thread_cell_t *cache_cell(fossil_thread_t thread) {
+    return (thread_cell_t *)((uintptr_t)thread & ~(uintptr_t)1);
+}
+
+static void cache_wait_while(thread_cell_t *cell, uint32_t state) {
+    while (__atomic_load_n(&cell->state, __ATOMIC_ACQUIRE) == state) {
+        fossil_platform_futex_wait(&cell->state, state, FOSSIL_PLATFORM_INFINITE);
+    }
+}
+
+static inline void cache_set_state(thread_cell_t *cell, uint32_t state) {
+    __atomic_store_n(&cell->state, state, __ATOMIC_RELEASE);
+    fossil_platform_futex_wake(&cell->state, UINT32_MAX);
+}
+
+// Put a host whose task is over back in the cache if there is room, or
+// mark it released so that it exits. The joiner does this on the host's
+// behalf, so the host is available again as soon as join returns.
+static void cache_release(thread_cell_t *cell) {
+    pthread_mutex_lock(&cache_mutex);
+    if (cache_idle_count < cache_limit) {
+        __atomic_store_n(&cell->state, CELL_IDLE, __ATOMIC_RELEASE);
+        cell->next = cache_idle;
+        cache_idle = cell;
+        cache_idle_count++;
+    } else {
+        __atomic_store_n(&cell->state, CELL_RELEASED, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    fossil_platform_futex_wake(&cell->state, UINT32_MAX);
+}
+
+static void *cache_host(void *arg) {
+    thread_cell_t *cell = (thread_cell_t *)arg;
+    while (1) {
+        cache_wait_while(cell, CELL_IDLE);
+        if (__atomic_load_n(&cell->state, __ATOMIC_ACQUIRE) == CELL_RETIRED) break;
+
+        cell->result = cell->task(cell->arg);
+
+        // A joinable task waits here until its joiner has the result.
+        uint32_t expected = CELL_RUNNING;
+        if (__atomic_compare_exchange_n(&cell->state, &expected, CELL_FINISHED, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            fossil_platform_futex_wake(&cell->state, UINT32_MAX);
+            cache_wait_while(cell, CELL_FINISHED);
+        } else {
+            cache_release(cell);
+        }
+        if (__atomic_load_n(&cell->state, __ATOMIC_ACQUIRE) == CELL_RELEASED) break;
+    }
+
+    pthread_mutex_lock(&cache_mutex);
+    cell->next = cache_spare;
+    cache_spare = cell;
+    pthread_mutex_unlock(&cache_mutex);
+    return NULL;
+}
+
+// Hand the task to a parked host with the same stack layout, or start one.
+static int32_t cache_create(fossil_thread_t *thread, fossil_thread_attr_t *attr, fossil_task_t task, fossil_argumet_t arg) {
+    size_t stack_size = cache_default_stack;
+    size_t guard_size = cache_default_guard;
+    int detach_state = PTHREAD_CREATE_JOINABLE;
+    if (attr) {
+        pthread_attr_getstacksize(attr, &stack_size);
+        pthread_attr_getguardsize(attr, &guard_size);
+        pthread_attr_getdetachstate(attr, &detach_state);
+    }
+    uint32_t state = detach_state == PTHREAD_CREATE_DETACHED ? CELL_DETACHED : CELL_RUNNING;
+
+    pthread_mutex_lock(&cache_mutex);
+    thread_cell_t **link = &cache_idle;
+    while (*link && ((*link)->stack_size != stack_size || (*link)->guard_size != guard_size)) {
+        link = &(*link)->next;
+    }
+    thread_cell_t *cell = *link;
+    if (cell) {
+        *link = cell->next;
+        cache_idle_count--;
+    } else if (cache_spare) {
+        cell = cache_spare;
+        cache_spare = cell->next;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+
+    int32_t reused = cell && __atomic_load_n(&cell->state, __ATOMIC_RELAXED) == CELL_IDLE;
+    if (!cell) {
+        cell = (thread_cell_t *)malloc(sizeof(thread_cell_t));
+        if (!cell) return -1;
+    }
+    cell->task = task;
+    cell->arg = arg;
+    cell->result = NULL;
+    *thread = (fossil_thread_t)((uintptr_t)cell | 1);
+
+    if (reused) {
+        cache_set_state(cell, state);
+        return 0;
+    }
+
+    cell->stack_size = stack_size;
+    cell->guard_size = guard_size;
+    __atomic_store_n(&cell->state, state, __ATOMIC_RELAXED);
+    pthread_t native;
+    if (pthread_create(&native, attr, cache_host, cell) != 0) {
+        pthread_mutex_lock(&cache_mutex);
+        cell->next = cache_spare;
+        cache_spare = cell;
+        pthread_mutex_unlock(&cache_mutex);
+        return -1;
+    }
+    if (detach_state != PTHREAD_CREATE_DETACHED) pthread_detach(native);
+    return 0;
+}
+
+static int32_t cache_join(thread_cell_t *cell, void **retval) {
+    cache_wait_while(cell, CELL_RUNNING);
+    if (__atomic_load_n(&cell->state, __ATOMIC_ACQUIRE) != CELL_FINISHED) return -1;
+    if (retval) *retval = cell->result;
+    cache_release(cell);
+    return 0;
+}
+
+static int32_t cache_detach(thread_cell_t *cell) {
+    uint32_t expected = CELL_RUNNING;
+    if (__atomic_compare_exchange_n(&cell->state, &expected, CELL_DETACHED, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    if (expected != CELL_FINISHED) return -1;
+    cache_release(cell);
+    return 0;
+}
+#endif
+
+int32_t fossil_thread_cache_enable(uint32_t max_idle) {
+#ifdef THREAD_CACHE
+    pthread_mutex_lock(&cache_mutex);
+    if (cache_default_stack == 0) {
+        pthread_attr_t defaults;
+        pthread_attr_init(&defaults);
+        pthread_attr_getstacksize(&defaults, &cache_default_stack);
+        pthread_attr_getguardsize(&defaults, &cache_default_guard);
+        pthread_attr_destroy(&defaults);
+    }
+    __atomic_store_n(&cache_limit, max_idle, __ATOMIC_RELEASE);
+
+    // Retire parked hosts beyond the new limit.
+    thread_cell_t *retired = NULL;
+    while (cache_idle_count > max_idle) {
+        thread_cell_t *cell = cache_idle;
+        cache_idle = cell->next;
+        cache_idle_count--;
+        cell->next = retired;
+        retired = cell;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+
+    while (retired) {
+        thread_cell_t *next = retired->next;
+        cache_set_state(retired, CELL_RETIRED);
+        retired = next;
+    }
+    return 0;
+#else
+    (void)max_idle;
+    return -1;
+#endif
+}
+
+int32_t fossil_thread_cache_disable(void) {
+#ifdef THREAD_CACHE
+    return fossil_thread_cache_enable(0);
+#else
+    return 0;
+#endif
+}
+
 /* -------- Kernel Threads Implementation -------- */
 
 int32_t fossil_thread_create(fossil_thread_t *thread, fossil_thread_attr_t *attr, fossil_task_t task, fossil_argumet_t arg) {
+    if (!thread || !task) return -1;
+#ifdef THREAD_CACHE
+    if (__atomic_load_n(&cache_limit, __ATOMIC_ACQUIRE)) return cache_create(thread, attr, task, arg);
+#endif
 #ifdef _WIN32
     // Allocate and initialize thread data
     thread_data_t *thread_data = malloc(sizeof(thread_data_t));
@@ -59,6 +288,9 @@ int32_t fossil_thread_create(fossil_thread_t *thread, fossil_thread_attr_t *attr
 }
 
 int32_t fossil_thread_join(fossil_thread_t thread, void **retval) {
+#ifdef THREAD_CACHE
+    if (cache_is_cell(thread)) return cache_join(cache_cell(thread), retval);
+#endif
 #ifdef _WIN32
     DWORD res = WaitForSingleObject(thread, INFINITE);
     if (res == WAIT_OBJECT_0 && retval) {
@@ -72,6 +304,9 @@ int32_t fossil_thread_join(fossil_thread_t thread, void **retval) {
 }
 
 int32_t fossil_thread_detach(fossil_thread_t thread) {
+#ifdef THREAD_CACHE
+    if (cache_is_cell(thread)) return cache_detach(cache_cell(thread));
+#endif
 #ifdef _WIN32
     return CloseHandle(thread) ? 0 : -1;
 #else
@@ -0,0 +1,350 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/trace.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(FOSSIL_THREADS_TRACE) && !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#if defined(FOSSIL_THREADS_TRACE) && (defined(__x86_64__) || defined(__i386__))
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+/* -------- Task and Fiber Tracer -------- */
+
+#ifdef FOSSIL_THREADS_TRACE
+#define TRACE_NAME_MAX 32
+
+typedef struct {
+    uint64_t ticks;
+    const void *id;
+    uint64_t aux;
+    uint32_t kind;
+} trace_record_t;
+
+// One ring per thread. Only the owning thread writes records and head.
+// Rings are never unlinked: when a thread exits its ring is released, and
+// the next new thread reuses it once its events belong to an older trace.
+typedef struct trace_ring_t {
+    struct trace_ring_t *next;
+    trace_record_t *records;
+    uint64_t head;
+    uint32_t mask;
+    uint32_t generation;
+    uint32_t tid;
+    uint32_t owned;
+    char name[TRACE_NAME_MAX];
+} trace_ring_t;
+
+// Current generation while recording, 0 while stopped. Read by the hooks.
+uint32_t fossil_trace_active = 0;
+
+static trace_ring_t *trace_rings = NULL;
+static uint32_t trace_generation = 0;
+static uint32_t trace_capacity = FOSSIL_TRACE_DEFAULT_EVENTS;
+static uint32_t trace_next_tid = 1;
+static uint64_t trace_start_ticks, trace_start_ns;
+static uint64_t trace_stop_ticks, trace_stop_ns;
+
+static FOSSIL_THREAD_LOCAL trace_ring_t *trace_local = NULL;
+static FOSSIL_THREAD_LOCAL char trace_local_name[TRACE_NAME_MAX];
+
+static uint32_t trace_exit_state = 0;
+#ifdef _WIN32
+static DWORD trace_exit_key;
+#else
+static pthread_key_t trace_exit_key;
+#endif
+
+static inline uint64_t trace_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return fossil_platform_now_ns();
+#endif
+}
+
+// Release the ring of an exiting thread for reuse.
+static void trace_ring_release(trace_ring_t *ring) {
+    __atomic_store_n(&ring->owned, 0, __ATOMIC_RELEASE);
+}
+
+#ifdef _WIN32
+static VOID NTAPI trace_exit_callback(PVOID value) {
+    if (value) trace_ring_release((trace_ring_t *)value);
+}
+#else
+static void trace_exit_callback(void *value) {
+    trace_ring_release((trace_ring_t *)value);
+}
+#endif
+
+static void trace_exit_init(void) {
+#ifdef _WIN32
+    trace_exit_key = FlsAlloc(trace_exit_callback);
+#else
+    pthread_key_create(&trace_exit_key, trace_exit_callback);
+#endif
+}
+
+// Claim a released ring whose events are not part of the current trace,
+// so threads that come and go do not each leave a buffer behind.
+static trace_ring_t *trace_ring_reuse(uint32_t generation) {
+    for (trace_ring_t *ring = __atomic_load_n(&trace_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        uint32_t expected = 0;
+        if (__atomic_load_n(&ring->owned, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&ring->owned, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            if (ring->generation != generation) return ring;
+            trace_ring_release(ring);
+        }
+    }
+    return NULL;
+}
+
+// Called by the owner when it has no ring yet or its ring is from an older
+// generation: (re)size the buffer and forget the stale events.
+static trace_ring_t *trace_ring_refresh(uint32_t generation) {
+    trace_ring_t *ring = trace_local;
+    uint32_t capacity = __atomic_load_n(&trace_capacity, __ATOMIC_RELAXED);
+
+    if (!ring) {
+        ring = trace_ring_reuse(generation);
+        if (!ring) {
+            ring = (trace_ring_t *)calloc(1, sizeof(*ring));
+            if (!ring) return NULL;
+            ring->owned = 1;
+
+            ring->next = __atomic_load_n(&trace_rings, __ATOMIC_RELAXED);
+            while (!__atomic_compare_exchange_n(&trace_rings, &ring->next, ring, 1,
+                                                __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            }
+        }
+        ring->tid = __atomic_fetch_add(&trace_next_tid, 1, __ATOMIC_RELAXED);
+        memcpy(ring->name, trace_local_name, TRACE_NAME_MAX);
+
+        fossil_platform_once(&trace_exit_state, trace_exit_init);
+#ifdef _WIN32
+        FlsSetValue(trace_exit_key, ring);
+#else
+        pthread_setspecific(trace_exit_key, ring);
+#endif
+        trace_local = ring;
+    }
+
+    if (!ring->records || ring->mask + 1 != capacity) {
+        trace_record_t *records = (trace_record_t *)malloc(capacity * sizeof(trace_record_t));
+        if (!records) return NULL;
+        free(ring->records);
+        ring->records = records;
+        ring->mask = capacity - 1;
+    }
+
+    __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+    ring->generation = generation;
+    return ring;
+}
+
+// Copy a thread name into a JSON string body.
+static void json_escape(char *out, size_t size, const char *in) {
+    size_t used = 0;
+    for (; *in && used + 7 < size; in++) {
+        unsigned char c = (unsigned char)*in;
+        if (c == '"' || c == '\\') {
+            out[used++] = '\\';
+            out[used++] = (char)c;
+        } else if (c < 0x20) {
+            used += (size_t)snprintf(out + used, size - used, "\\u%04x", c);
+        } else {
+            out[used++] = (char)c;
+        }
+    }
+    out[used] = '\0';
+}
+
+static void json_event(FILE *out, int *first, const char *ph, const char *name, const char *cat,
+                       uint32_t tid, double ts, const void *id, const char *extra) {
+    fprintf(out, "%s\n{\"ph\":\"%s\",\"name\":\"%s\",\"cat\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f",
+            *first ? "" : ",", ph, name, cat, tid, ts);
+    if (id) fprintf(out, ",\"id\":\"%p\"", id);
+    if (extra) fprintf(out, ",%s", extra);
+    fputc('}', out);
+    *first = 0;
+}
+
+static void trace_dump_record(FILE *out, int *first, uint32_t tid, double ts, const trace_record_t *r) {
+    char extra[96];
+
+    switch (r->kind) {
+        case FOSSIL_TRACE_SUBMIT:
+            snprintf(extra, sizeof(extra), "\"s\":\"t\",\"args\":{\"func\":\"0x%llx\"}", (unsigned long long)r->aux);
+            json_event(out, first, "i", "submit", "pool", tid, ts, r->id, extra);
+            json_event(out, first, "s", "task", "flow", tid, ts, r->id, NULL);
+            break;
+        case FOSSIL_TRACE_DEQUEUE:
+            json_event(out, first, "i", "dequeue", "pool", tid, ts, r->id, "\"s\":\"t\"");
+            break;
+        case FOSSIL_TRACE_START:
+            snprintf(extra, sizeof(extra), "\"args\":{\"task\":\"%p\",\"func\":\"0x%llx\"}", r->id, (unsigned long long)r->aux);
+            json_event(out, first, "B", "task", "pool", tid, ts, NULL, extra);
+            json_event(out, first, "f", "task", "flow", tid, ts, r->id, "\"bp\":\"e\"");
+            break;
+        case FOSSIL_TRACE_END:
+            json_event(out, first, "E", "task", "pool", tid, ts, NULL, NULL);
+            break;
+        case FOSSIL_TRACE_STEAL:
+            snprintf(extra, sizeof(extra), "\"s\":\"t\",\"args\":{\"victim\":%llu}", (unsigned long long)r->aux);
+            json_event(out, first, "i", "steal", "pool", tid, ts, r->id, extra);
+            break;
+        case FOSSIL_TRACE_PARK:
+            json_event(out, first, "B", "parked", "pool", tid, ts, NULL, NULL);
+            break;
+        case FOSSIL_TRACE_WAKE:
+            json_event(out, first, "E", "parked", "pool", tid, ts, NULL, NULL);
+            break;
+        case FOSSIL_TRACE_FIBER_SWITCH:
+            // Fibers are async slices keyed by fiber so they need not nest
+            // with the task slices of the thread that runs them.
+            json_event(out, first, "e", "fiber", "fiber", tid, ts, (const void *)(uintptr_t)r->aux, NULL);
+            json_event(out, first, "b", "fiber", "fiber", tid, ts, r->id, NULL);
+            break;
+        default:
+            snprintf(extra, sizeof(extra), "\"s\":\"t\",\"args\":{\"aux\":%llu}", (unsigned long long)r->aux);
+            json_event(out, first, "i", "user", "user", tid, ts, r->id, extra);
+            break;
+    }
+}
+#endif
+
+int32_t fossil_trace_start(uint32_t events_per_thread) {
+#ifdef FOSSIL_THREADS_TRACE
+    uint32_t capacity = 1;
+    if (events_per_thread == 0) events_per_thread = FOSSIL_TRACE_DEFAULT_EVENTS;
+    while (capacity < events_per_thread && capacity < (1u << 30)) capacity <<= 1;
+
+    __atomic_store_n(&trace_capacity, capacity, __ATOMIC_RELAXED);
+    trace_start_ns = fossil_platform_now_ns();
+    trace_start_ticks = trace_ticks();
+
+    uint32_t generation = __atomic_add_fetch(&trace_generation, 1, __ATOMIC_RELAXED);
+    if (generation == 0) generation = __atomic_add_fetch(&trace_generation, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&fossil_trace_active, generation, __ATOMIC_RELEASE);
+    return 0;
+#else
+    (void)events_per_thread;
+    return -1;
+#endif
+}
+
+int32_t fossil_trace_stop(void) {
+#ifdef FOSSIL_THREADS_TRACE
+    __atomic_store_n(&fossil_trace_active, 0, __ATOMIC_RELEASE);
+    trace_stop_ticks = trace_ticks();
+    trace_stop_ns = fossil_platform_now_ns();
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int32_t fossil_trace_thread_name(const char *name) {
+#ifdef FOSSIL_THREADS_TRACE
+    strncpy(trace_local_name, name, TRACE_NAME_MAX - 1);
+    trace_local_name[TRACE_NAME_MAX - 1] = '\0';
+    if (trace_local) memcpy(trace_local->name, trace_local_name, TRACE_NAME_MAX);
+    return 0;
+#else
+    (void)name;
+    return -1;
+#endif
+}
+
+void fossil_trace_record(fossil_trace_event_t kind, const void *id, uint64_t aux) {
+#ifdef FOSSIL_THREADS_TRACE
+    uint32_t generation = __atomic_load_n(&fossil_trace_active, __ATOMIC_RELAXED);
+    if (!generation) return;
+
+    trace_ring_t *ring = trace_local;
+    if (!ring || ring->generation != generation) {
+        ring = trace_ring_refresh(generation);
+        if (!ring) return;
+    }
+
+    uint64_t head = ring->head;
+    trace_record_t *record = &ring->records[head & ring->mask];
+    record->ticks = trace_ticks();
+    record->id = id;
+    record->aux = aux;
+    record->kind = (uint32_t)kind;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+#else
+    (void)kind;
+    (void)id;
+    (void)aux;
+#endif
+}
+
+int32_t fossil_trace_dump(FILE *out) {
+#ifdef FOSSIL_THREADS_TRACE
+    uint32_t generation = __atomic_load_n(&trace_generation, __ATOMIC_RELAXED);
+    uint64_t end_ticks = trace_stop_ticks, end_ns = trace_stop_ns;
+    if (__atomic_load_n(&fossil_trace_active, __ATOMIC_ACQUIRE) || end_ns < trace_start_ns) {
+        end_ticks = trace_ticks();
+        end_ns = fossil_platform_now_ns();
+    }
+
+    // Calibrate ticks against the monotonic clock over the traced interval.
+    double ticks_per_us = 1000.0;
+    if (end_ns > trace_start_ns && end_ticks > trace_start_ticks) {
+        ticks_per_us = (double)(end_ticks - trace_start_ticks) * 1000.0 / (double)(end_ns - trace_start_ns);
+    }
+
+    int first = 1;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    for (trace_ring_t *ring = __atomic_load_n(&trace_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        if (ring->generation != generation || !ring->records) continue;
+
+        char name[TRACE_NAME_MAX * 6];
+        char extra[sizeof(name) + 32];
+        json_escape(name, sizeof(name), ring->name[0] ? ring->name : "thread");
+        snprintf(extra, sizeof(extra), "\"args\":{\"name\":\"%s\"}", name);
+        json_event(out, &first, "M", "thread_name", "meta", ring->tid, 0.0, NULL, extra);
+
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t capacity = (uint64_t)ring->mask + 1;
+        for (uint64_t i = head > capacity ? head - capacity : 0; i < head; i++) {
+            const trace_record_t *r = &ring->records[i & ring->mask];
+            double ts = r->ticks >= trace_start_ticks ? (double)(r->ticks - trace_start_ticks) / ticks_per_us : 0.0;
+            trace_dump_record(out, &first, ring->tid, ts, r);
+        }
+    }
+
+    fprintf(out, "\n]}\n");
+    return ferror(out) ? -1 : 0;
+#else
+    (void)out;
+    return -1;
+#endif
+}
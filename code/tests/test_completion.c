@@ -0,0 +1,195 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+// Test variables
+#define COMPLETION_TASKS 200
+
+fossil_completion_queue_t test_completions;
+static int completion_values[COMPLETION_TASKS];
+
+void *completion_task(void *arg) {
+    return arg;
+}
+
+static void completion_test_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static int32_t completion_gate = 0;
+static int32_t completion_gate_started = 0;
+
+// Occupies the only worker until completion_gate is raised.
+void *completion_gate_task(void *arg) {
+    __atomic_store_n(&completion_gate_started, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&completion_gate, __ATOMIC_ACQUIRE)) {
+        completion_test_yield();
+    }
+    return arg;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Posts come back in order, in batches of at most max
+FOSSIL_TEST(fossil_completion_post_and_drain) {
+    void *results[4];
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_create(&test_completions));
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)fossil_completion_drain(&test_completions, results, 4));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_completion_wait(&test_completions, 1000000));
+
+    for (int i = 0; i < 10; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_completion_post(&test_completions, &completion_values[i]));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_wait(&test_completions, UINT64_MAX));
+
+    int next = 0;
+    size_t got;
+    while ((got = fossil_completion_drain(&test_completions, results, 4)) != 0) {
+        ASSUME_ITS_TRUE(got <= 4);
+        for (size_t i = 0; i < got; i++) {
+            ASSUME_ITS_TRUE(results[i] == &completion_values[next++]);
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(10, next);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_completion_wait(&test_completions, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_destroy(&test_completions));
+}
+
+// Test Case 2: Tasks the pool drops still post a result
+FOSSIL_TEST(fossil_completion_discarded) {
+    fossil_thread_pool_t pool;
+    void *results[8];
+    int discarded = 0;
+    int received = 0;
+    completion_gate = 0;
+    completion_gate_started = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_create(&test_completions));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_max_spares(&pool, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&pool, 1, FOSSIL_THREAD_POOL_DROP_OLDEST));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_completion(&pool, &test_completions, completion_gate_task, &completion_values[0]));
+    while (!__atomic_load_n(&completion_gate_started, __ATOMIC_ACQUIRE)) {
+        completion_test_yield();
+    }
+
+    // Each submission pushes the one queued before it out.
+    for (int i = 1; i <= 3; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_completion(&pool, &test_completions, completion_task, &completion_values[i]));
+    }
+    __atomic_store_n(&completion_gate, 1, __ATOMIC_RELEASE);
+
+    while (received < 4 && fossil_completion_wait(&test_completions, 5000000000ull) == 0) {
+        size_t got = fossil_completion_drain(&test_completions, results, 8);
+        for (size_t i = 0; i < got; i++) {
+            if (results[i] == FOSSIL_COMPLETION_DISCARDED) discarded++;
+        }
+        received += (int)got;
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+    ASSUME_ITS_EQUAL_I32(4, received);
+    ASSUME_ITS_EQUAL_I32(2, discarded);
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_destroy(&test_completions));
+}
+
+#ifdef __linux__
+// Test Case 3: An epoll loop collects pool results with coalesced wakeups
+FOSSIL_TEST(fossil_completion_epoll_loop) {
+    fossil_thread_pool_t pool;
+    struct epoll_event event = {0};
+    int seen[COMPLETION_TASKS] = {0};
+    void *results[16];
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_create(&test_completions));
+    int epfd = epoll_create1(0);
+    ASSUME_ITS_TRUE(epfd >= 0);
+    event.events = EPOLLIN;
+    ASSUME_ITS_EQUAL_I32(0, epoll_ctl(epfd, EPOLL_CTL_ADD, fossil_completion_fd(&test_completions), &event));
+
+    // Nothing posted yet: the descriptor is not readable.
+    ASSUME_ITS_EQUAL_I32(0, epoll_wait(epfd, &event, 1, 0));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 4));
+    for (int i = 0; i < COMPLETION_TASKS; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_completion(&pool, &test_completions, completion_task, &completion_values[i]));
+    }
+
+    int received = 0;
+    int wakeups = 0;
+    while (received < COMPLETION_TASKS) {
+        if (epoll_wait(epfd, &event, 1, 5000) != 1) break;
+        wakeups++;
+        size_t got = fossil_completion_drain(&test_completions, results, 16);
+        for (size_t i = 0; i < got; i++) {
+            seen[(int *)results[i] - completion_values]++;
+        }
+        received += (int)got;
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+
+    ASSUME_ITS_EQUAL_I32(COMPLETION_TASKS, received);
+    ASSUME_ITS_TRUE(wakeups <= COMPLETION_TASKS);
+    for (int i = 0; i < COMPLETION_TASKS; i++) {
+        ASSUME_ITS_EQUAL_I32(1, seen[i]);
+    }
+
+    // Once drained the descriptor goes quiet again.
+    fossil_completion_drain(&test_completions, results, 16);
+    ASSUME_ITS_EQUAL_I32(0, epoll_wait(epfd, &event, 1, 0));
+
+    // Many posts, one wakeup; a partial drain leaves it readable.
+    for (int i = 0; i < 20; i++) {
+        fossil_completion_post(&test_completions, &completion_values[i]);
+    }
+    ASSUME_ITS_EQUAL_I32(1, epoll_wait(epfd, &event, 1, 0));
+    ASSUME_ITS_EQUAL_I32(16, (int32_t)fossil_completion_drain(&test_completions, results, 16));
+    ASSUME_ITS_EQUAL_I32(1, epoll_wait(epfd, &event, 1, 0));
+    ASSUME_ITS_EQUAL_I32(4, (int32_t)fossil_completion_drain(&test_completions, results, 16));
+    ASSUME_ITS_EQUAL_I32(0, epoll_wait(epfd, &event, 1, 0));
+
+    close(epfd);
+    ASSUME_ITS_EQUAL_I32(0, fossil_completion_destroy(&test_completions));
+}
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_completion_tests) {
+    ADD_TEST(fossil_completion_post_and_drain);
+    ADD_TEST(fossil_completion_discarded);
+#ifdef __linux__
+    ADD_TEST(fossil_completion_epoll_loop);
+#endif
+}
@@ -0,0 +1,175 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/coro.hpp"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Test variables
+#define CPP_CORO_TASKS 100
+
+static fossil::task<int> coro_leaf(fossil::thread_pool &pool, int value) {
+    co_await pool.schedule();
+    co_return value;
+}
+
+static fossil::task<void> coro_touch(fossil::thread_pool &pool, std::atomic<int> &count) {
+    co_await pool.schedule();
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+static fossil::task<int> coro_throw(fossil::thread_pool &pool) {
+    co_await pool.schedule();
+    throw std::runtime_error("coro");
+}
+
+static fossil::task<int32_t> coro_where(fossil::thread_pool &pool) {
+    co_await pool.schedule();
+    co_return fossil_thread_pool_worker_index();
+}
+
+static fossil::task<int> coro_sum(fossil::thread_pool &pool) {
+    std::vector<fossil::task<int>> tasks;
+    for (int i = 0; i < CPP_CORO_TASKS; i++) tasks.push_back(coro_leaf(pool, i));
+    std::vector<int> values = co_await fossil::when_all(std::move(tasks));
+
+    int sum = 0;
+    for (int value : values) sum += value;
+    co_return sum;
+}
+
+static fossil::task<int> coro_pair(fossil::thread_pool &pool) {
+    auto [a, b] = co_await fossil::when_all(coro_leaf(pool, 1), coro_leaf(pool, 2));
+    co_return a + b;
+}
+
+static fossil::task<void> coro_locker(fossil::thread_pool &pool, fossil::async_mutex &mutex, int &counter) {
+    for (int i = 0; i < CPP_CORO_TASKS; i++) {
+        co_await pool.schedule();
+        auto guard = co_await mutex.lock_scoped();
+        int seen = counter;
+        std::this_thread::yield();
+        counter = seen + 1;
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: schedule() moves the coroutine onto a worker
+FOSSIL_TEST(cpp_coro_schedule) {
+    fossil::thread_pool pool(2);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_thread_pool_worker_index());
+    int32_t index = fossil::sync_wait(coro_where(pool));
+    ASSUME_ITS_TRUE(index >= 0 && index < 2);
+}
+
+// Test Case 2: sync_wait returns the result or rethrows the exception
+FOSSIL_TEST(cpp_coro_sync_wait) {
+    fossil::thread_pool pool(2);
+    ASSUME_ITS_EQUAL_I32(42, fossil::sync_wait(coro_leaf(pool, 42)));
+
+    int32_t threw = 0;
+    try {
+        fossil::sync_wait(coro_throw(pool));
+    } catch (const std::runtime_error &) {
+        threw = 1;
+    }
+    ASSUME_ITS_EQUAL_I32(1, threw);
+}
+
+// Test Case 3: when_all collects every result in task order
+FOSSIL_TEST(cpp_coro_when_all) {
+    fossil::thread_pool pool(4);
+    ASSUME_ITS_EQUAL_I32(CPP_CORO_TASKS * (CPP_CORO_TASKS - 1) / 2, fossil::sync_wait(coro_sum(pool)));
+    ASSUME_ITS_EQUAL_I32(3, fossil::sync_wait(coro_pair(pool)));
+
+    std::atomic<int> count{0};
+    std::vector<fossil::task<void>> tasks;
+    for (int i = 0; i < CPP_CORO_TASKS; i++) tasks.push_back(coro_touch(pool, count));
+    fossil::sync_wait(fossil::when_all(std::move(tasks)));
+    ASSUME_ITS_EQUAL_I32(CPP_CORO_TASKS, count.load());
+}
+
+// Test Case 4: when_any yields the first task to finish
+FOSSIL_TEST(cpp_coro_when_any) {
+    fossil::thread_pool pool(4);
+    std::vector<fossil::task<int>> tasks;
+    for (int i = 0; i < 8; i++) tasks.push_back(coro_leaf(pool, i * 10));
+    auto [index, value] = fossil::sync_wait(fossil::when_any(std::move(tasks)));
+    ASSUME_ITS_TRUE(index < 8);
+    ASSUME_ITS_EQUAL_I32((int32_t)index * 10, value);
+}
+
+// Test Case 5: async_mutex serializes contending coroutines
+FOSSIL_TEST(cpp_coro_async_mutex) {
+    fossil::thread_pool pool(4);
+    fossil::async_mutex mutex;
+    int counter = 0;
+    std::vector<fossil::task<void>> tasks;
+    for (int i = 0; i < 8; i++) tasks.push_back(coro_locker(pool, mutex, counter));
+    fossil::sync_wait(fossil::when_all(std::move(tasks)));
+    ASSUME_ITS_EQUAL_I32(8 * CPP_CORO_TASKS, counter);
+}
+
+// Test Case 6: A coroutine whose resume task is dropped still finishes
+FOSSIL_TEST(cpp_coro_schedule_dropped) {
+    fossil::semaphore release;
+    fossil::semaphore started;
+    fossil::thread_pool pool(1);
+    // No spare may drain the queue while the worker waits.
+    fossil_thread_pool_set_max_spares(pool.native_handle(), 0);
+    fossil_thread_pool_set_capacity(pool.native_handle(), 1, FOSSIL_THREAD_POOL_DROP_OLDEST);
+    pool.submit([&] {
+        started.release();
+        release.acquire();
+    });
+    started.acquire();
+
+    int result = 0;
+    std::thread waiter([&] { result = fossil::sync_wait(coro_leaf(pool, 7)); });
+    fossil_thread_pool_stats_t stats;
+    do {
+        std::this_thread::yield();
+        fossil_thread_pool_stats(pool.native_handle(), &stats);
+    } while (stats.queue_depth == 0);
+
+    // Displaces the queued resume, which then runs on this thread.
+    pool.submit([] {});
+    waiter.join();
+    release.release();
+    ASSUME_ITS_EQUAL_I32(7, result);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// The generated runner is C.
+extern "C" void cpp_coro_tests(void);
+
+FOSSIL_TEST_GROUP(cpp_coro_tests) {
+    ADD_TEST(cpp_coro_schedule);
+    ADD_TEST(cpp_coro_sync_wait);
+    ADD_TEST(cpp_coro_when_all);
+    ADD_TEST(cpp_coro_when_any);
+    ADD_TEST(cpp_coro_async_mutex);
+    ADD_TEST(cpp_coro_schedule_dropped);
+}
@@ -0,0 +1,97 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+// Test variables
+#define COUNTER_TEST_THREADS 4
+#define COUNTER_TEST_ADDS 100000
+
+fossil_sharded_counter_t test_counter;
+static int64_t counter_drained = 0;
+static int counter_adders_done = 0;
+
+void *counter_adder(void *arg) {
+    (void)arg;
+    for (int i = 0; i < COUNTER_TEST_ADDS; i++) {
+        fossil_sharded_counter_add(&test_counter, 1);
+    }
+    __atomic_fetch_add(&counter_adders_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void *counter_drainer(void *arg) {
+    (void)arg;
+    while (__atomic_load_n(&counter_adders_done, __ATOMIC_ACQUIRE) < COUNTER_TEST_THREADS) {
+        counter_drained += fossil_sharded_counter_drain(&test_counter);
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Adds and reads from one thread
+FOSSIL_TEST(fossil_sharded_counter_basic) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_sharded_counter_create(&test_counter, 3));
+    ASSUME_ITS_EQUAL_I32(3, (int32_t)test_counter.mask);
+    fossil_sharded_counter_add(&test_counter, 5);
+    fossil_sharded_counter_add(&test_counter, -2);
+    ASSUME_ITS_EQUAL_I32(3, (int32_t)fossil_sharded_counter_read(&test_counter));
+
+    // The cached total is kept until it expires.
+    ASSUME_ITS_EQUAL_I32(3, (int32_t)fossil_sharded_counter_read_approx(&test_counter, UINT64_MAX));
+    fossil_sharded_counter_add(&test_counter, 4);
+    ASSUME_ITS_EQUAL_I32(3, (int32_t)fossil_sharded_counter_read_approx(&test_counter, UINT64_MAX));
+    ASSUME_ITS_EQUAL_I32(7, (int32_t)fossil_sharded_counter_read_approx(&test_counter, 0));
+
+    ASSUME_ITS_EQUAL_I32(7, (int32_t)fossil_sharded_counter_drain(&test_counter));
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)fossil_sharded_counter_read(&test_counter));
+    ASSUME_ITS_EQUAL_I32(0, fossil_sharded_counter_destroy(&test_counter));
+}
+
+// Test Case 2: Concurrent adds are never lost, even while being drained
+FOSSIL_TEST(fossil_sharded_counter_concurrent) {
+    fossil_thread_t adders[COUNTER_TEST_THREADS];
+    fossil_thread_t drainer;
+    counter_drained = 0;
+    counter_adders_done = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_sharded_counter_create(&test_counter, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&drainer, NULL, counter_drainer, NULL));
+    for (int i = 0; i < COUNTER_TEST_THREADS; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&adders[i], NULL, counter_adder, NULL));
+    }
+    for (int i = 0; i < COUNTER_TEST_THREADS; i++) {
+        fossil_thread_join(adders[i], NULL);
+    }
+    fossil_thread_join(drainer, NULL);
+
+    int64_t total = counter_drained + fossil_sharded_counter_read(&test_counter);
+    ASSUME_ITS_EQUAL_I32(COUNTER_TEST_THREADS * COUNTER_TEST_ADDS, (int32_t)total);
+    ASSUME_ITS_EQUAL_I32(0, fossil_sharded_counter_destroy(&test_counter));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_counter_tests) {
+    ADD_TEST(fossil_sharded_counter_basic);
+    ADD_TEST(fossil_sharded_counter_concurrent);
+}
@@ -0,0 +1,143 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+// Test variables
+#define EPOCH_LIVE 0x11
+#define EPOCH_DEAD 0xDD
+#define EPOCH_NODES 4096
+
+typedef struct {
+    int magic;
+} epoch_test_node_t;
+
+static epoch_test_node_t epoch_nodes[EPOCH_NODES];
+static epoch_test_node_t *epoch_shared = NULL;
+static int epoch_reclaimed = 0;
+static int epoch_bad_reads = 0;
+static int epoch_next_node = 0;
+
+static void epoch_test_reclaim(void *ptr) {
+    ((epoch_test_node_t *)ptr)->magic = EPOCH_DEAD;
+    __atomic_fetch_add(&epoch_reclaimed, 1, __ATOMIC_RELAXED);
+}
+
+void *epoch_reader_task(void *arg) {
+    (void)arg;
+    for (int i = 0; i < 100; i++) {
+        fossil_epoch_enter();
+        epoch_test_node_t *node = __atomic_load_n(&epoch_shared, __ATOMIC_ACQUIRE);
+        if (node && __atomic_load_n(&node->magic, __ATOMIC_RELAXED) != EPOCH_LIVE) {
+            __atomic_fetch_add(&epoch_bad_reads, 1, __ATOMIC_RELAXED);
+        }
+        fossil_epoch_exit();
+    }
+    return NULL;
+}
+
+void *epoch_writer_task(void *arg) {
+    (void)arg;
+    for (int i = 0; i < 10; i++) {
+        int index = __atomic_fetch_add(&epoch_next_node, 1, __ATOMIC_RELAXED);
+        if (index >= EPOCH_NODES) return NULL;
+        epoch_test_node_t *node = &epoch_nodes[index];
+        __atomic_store_n(&node->magic, EPOCH_LIVE, __ATOMIC_RELAXED);
+
+        epoch_test_node_t *old = __atomic_exchange_n(&epoch_shared, node, __ATOMIC_ACQ_REL);
+        if (old) fossil_epoch_retire(old, epoch_test_reclaim);
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: A barrier reclaims everything the thread retired
+FOSSIL_TEST(fossil_epoch_barrier_reclaims) {
+    epoch_reclaimed = 0;
+    for (int i = 0; i < 10; i++) {
+        epoch_nodes[i].magic = EPOCH_LIVE;
+        ASSUME_ITS_EQUAL_I32(0, fossil_epoch_retire(&epoch_nodes[i], epoch_test_reclaim));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_epoch_barrier());
+    ASSUME_ITS_EQUAL_I32(10, epoch_reclaimed);
+    ASSUME_ITS_EQUAL_I32(EPOCH_DEAD, epoch_nodes[0].magic);
+}
+
+// Test Case 2: An open critical section holds back reclamation
+FOSSIL_TEST(fossil_epoch_critical_section_pins) {
+    epoch_reclaimed = 0;
+    epoch_nodes[0].magic = EPOCH_LIVE;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_epoch_enter());
+    ASSUME_ITS_EQUAL_I32(0, fossil_epoch_retire(&epoch_nodes[0], epoch_test_reclaim));
+    for (int i = 0; i < 8; i++) {
+        fossil_epoch_reclaim();
+    }
+    ASSUME_ITS_EQUAL_I32(0, epoch_reclaimed);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_epoch_barrier());
+    fossil_epoch_exit();
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_epoch_barrier());
+    ASSUME_ITS_EQUAL_I32(1, epoch_reclaimed);
+}
+
+// Test Case 3: Readers on pool workers never see a reclaimed object
+FOSSIL_TEST(fossil_epoch_pool_readers) {
+    fossil_thread_pool_t pool;
+    epoch_bad_reads = 0;
+    epoch_next_node = 0;
+    epoch_shared = NULL;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 4));
+    for (int i = 0; i < 200; i++) {
+        fossil_thread_pool_submit(&pool, (i % 4) ? epoch_reader_task : epoch_writer_task, NULL);
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+    ASSUME_ITS_EQUAL_I32(0, epoch_bad_reads);
+}
+
+// Test Case 4: Hazard pointers protect a single object
+FOSSIL_TEST(fossil_hazard_protects) {
+    void *shared = &epoch_nodes[1];
+    epoch_reclaimed = 0;
+    epoch_nodes[1].magic = EPOCH_LIVE;
+
+    ASSUME_ITS_TRUE(fossil_hazard_protect(0, &shared) == &epoch_nodes[1]);
+    shared = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_hazard_retire(&epoch_nodes[1], epoch_test_reclaim));
+    fossil_epoch_reclaim();
+    ASSUME_ITS_EQUAL_I32(0, epoch_reclaimed);
+    ASSUME_ITS_EQUAL_I32(EPOCH_LIVE, epoch_nodes[1].magic);
+
+    fossil_hazard_clear(0);
+    fossil_epoch_reclaim();
+    ASSUME_ITS_EQUAL_I32(1, epoch_reclaimed);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_epoch_tests) {
+    ADD_TEST(fossil_epoch_barrier_reclaims);
+    ADD_TEST(fossil_epoch_critical_section_pins);
+    ADD_TEST(fossil_epoch_pool_readers);
+    ADD_TEST(fossil_hazard_protects);
+}
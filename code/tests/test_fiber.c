@@ -17,23 +17,38 @@
 
 #include "fossil/threads/framework.h"
 
-FOSSIL_FIXEXIT(fixture_fiber);
 // Test variables
-fossil_fiber_t test_fiber;
-fossil_fiber_t main_fiber;
+#define FIBER_TEST_STACK 65536
+#define FIBER_TEST_ROUNDS 5
 
-void *fiber_task(void *arg) {
-    int *num = (int *)arg;
-    *num += 1;
-    return NULL;
+static fossil_fiber_t fiber_main;
+static fossil_fiber_t fiber_inner;
+static int32_t fiber_trace[4];
+static int32_t fiber_steps = 0;
+
+void fiber_count_task(void *arg) {
+    *(int32_t *)arg += 1;
+}
+
+// Hands control back to the main fiber after every round.
+void fiber_yield_task(void *arg) {
+    int32_t *rounds = (int32_t *)arg;
+    for (int i = 0; i < FIBER_TEST_ROUNDS; i++) {
+        *rounds += 1;
+        fossil_fiber_switch(fiber_main);
+    }
 }
 
-FOSSIL_SETUP(fixture_fiber) {
-    fossil_fiber_create(&test_fiber, fiber_task, NULL);
+void fiber_inner_task(void *arg) {
+    fiber_trace[fiber_steps++] = (int32_t)(intptr_t)arg;
 }
 
-FOSSIL_TEARDOWN(fixture_fiber) {
-    fossil_fiber_destroy(&test_fiber);
+// Runs fiber_inner to completion from inside another fiber.
+void fiber_outer_task(void *arg) {
+    (void)arg;
+    fiber_trace[fiber_steps++] = 1;
+    fossil_fiber_switch(fiber_inner);
+    fiber_trace[fiber_steps++] = 3;
 }
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -42,46 +57,68 @@ FOSSIL_TEARDOWN(fixture_fiber) {
 
 // Test Case 1: Create and delete a fiber
 FOSSIL_TEST(fossil_fiber_create_delete_case) {
-    test_fiber = fossil_fiber_create(4096, fiber_task, NULL);
-    ASSUME_NOT_CNULL(test_fiber);  // Check if the fiber was successfully created
-    fossil_fiber_delete(test_fiber);  // Ensure deletion succeeds
+    int32_t value = 0;
+    ASSUME_ITS_CNULL(fossil_fiber_create(FIBER_TEST_STACK, NULL, NULL));
+
+    // Stacks below the minimum are rounded up rather than refused.
+    fossil_fiber_t fiber = fossil_fiber_create(1, fiber_count_task, &value);
+    ASSUME_NOT_CNULL(fiber);
+    fossil_fiber_delete(fiber);
+    fossil_fiber_delete(NULL);
+    ASSUME_ITS_EQUAL_I32(0, value);
 }
 
-// Test Case 2: Switch between main fiber and created fiber
+// Test Case 2: A finished fiber returns to its caller and is not run again
 FOSSIL_TEST(fossil_fiber_switch_case) {
-    int value = 0;
-
-    // Create the fiber with a task that increments the value
-    test_fiber = fossil_fiber_create(4096, fiber_task, &value);
-    ASSUME_NOT_CNULL(test_fiber);
-
-    // Switch to the fiber, which should run its task
-    fossil_fiber_switch(test_fiber);
-
-    // Verify that the fiber task executed properly and modified the value
-    ASSUME_ITS_EQUAL_I32(10, value);
-
-    // Switch back to the main fiber (which is implicit here since the main fiber was converted)
+    int32_t value = 0;
+    fossil_fiber_t fiber = fossil_fiber_create(FIBER_TEST_STACK, fiber_count_task, &value);
+    ASSUME_NOT_CNULL(fiber);
+
+    fossil_fiber_switch(fiber);
+    ASSUME_ITS_EQUAL_I32(1, value);
+    fossil_fiber_switch(fiber);
+    ASSUME_ITS_EQUAL_I32(1, value);
+    fossil_fiber_delete(fiber);
 }
 
-// Test Case 3: Convert main thread to fiber and switch back
+// Test Case 3: A converted thread and a fiber switch back and forth
 FOSSIL_TEST(fossil_fiber_convert_case) {
-    int value = 0;
-
-    // Convert the main thread to a fiber
-    fossil_fiber_t fiber_main = fossil_fiber_convert(NULL);
-    ASSUME_NOT_CNULL(fiber_main);  // Ensure the main fiber was successfully created
-
-    // Create a new fiber with a task
-    test_fiber = fossil_fiber_create(4096, fiber_task, &value);
-    ASSUME_NOT_CNULL(test_fiber);
-
-    // Switch to the test fiber and execute its task
-    fossil_fiber_switch(test_fiber);
-    ASSUME_ITS_EQUAL_I32(10, value);  // Check if the task ran
+    int32_t rounds = 0;
+    fiber_main = fossil_fiber_convert(NULL);
+    ASSUME_NOT_CNULL(fiber_main);
+    ASSUME_ITS_TRUE(fossil_fiber_convert(NULL) == fiber_main);
+
+    fossil_fiber_t fiber = fossil_fiber_create(FIBER_TEST_STACK, fiber_yield_task, &rounds);
+    ASSUME_NOT_CNULL(fiber);
+    for (int i = 1; i <= FIBER_TEST_ROUNDS; i++) {
+        fossil_fiber_switch(fiber);
+        ASSUME_ITS_EQUAL_I32(i, rounds);
+    }
+
+    // The last switch lets the task return, which lands back here.
+    fossil_fiber_switch(fiber);
+    fossil_fiber_switch(fiber);
+    ASSUME_ITS_EQUAL_I32(FIBER_TEST_ROUNDS, rounds);
+    fossil_fiber_delete(fiber);
+    fossil_fiber_delete(fiber_main);
+}
 
-    // Switch back to the main fiber
-    fossil_fiber_switch(fiber_main);
+// Test Case 4: A fiber that finishes returns to the fiber that started it
+FOSSIL_TEST(fossil_fiber_nested_case) {
+    fiber_steps = 0;
+    fossil_fiber_t outer = fossil_fiber_create(FIBER_TEST_STACK, fiber_outer_task, NULL);
+    fiber_inner = fossil_fiber_create(FIBER_TEST_STACK, fiber_inner_task, (void *)(intptr_t)2);
+    ASSUME_NOT_CNULL(outer);
+    ASSUME_NOT_CNULL(fiber_inner);
+
+    fossil_fiber_switch(outer);
+    fiber_trace[fiber_steps++] = 4;
+    ASSUME_ITS_EQUAL_I32(4, fiber_steps);
+    for (int i = 0; i < 4; i++) {
+        ASSUME_ITS_EQUAL_I32(i + 1, fiber_trace[i]);
+    }
+    fossil_fiber_delete(fiber_inner);
+    fossil_fiber_delete(outer);
 }
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -89,7 +126,8 @@ FOSSIL_TEST(fossil_fiber_convert_case) {
 // * * * * * * * * * * * * * * * * * * * * * * * *
 
 FOSSIL_TEST_GROUP(c_fiber_tests) {
-    ADD_TESTF(fossil_fiber_create_delete_case, fixture_fiber);
-    ADD_TESTF(fossil_fiber_switch_case, fixture_fiber);
-    ADD_TESTF(fossil_fiber_convert_case, fixture_fiber);
-}
\ No newline at end of file
+    ADD_TEST(fossil_fiber_create_delete_case);
+    ADD_TEST(fossil_fiber_switch_case);
+    ADD_TEST(fossil_fiber_convert_case);
+    ADD_TEST(fossil_fiber_nested_case);
+}
@@ -0,0 +1,221 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+// Test variables
+#define GRAPH_TEST_FANOUT 200
+
+fossil_thread_pool_t graph_pool;
+fossil_task_graph_t test_graph;
+static int32_t graph_clock = 0;
+static int32_t graph_stamps[4];
+static int32_t graph_runs = 0;
+static int32_t graph_fanout_done = 0;
+static int32_t graph_fanout_seen = -1;
+
+void *graph_stamp_task(void *arg) {
+    graph_stamps[(intptr_t)arg] = __atomic_add_fetch(&graph_clock, 1, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+void *graph_count_task(void *arg) {
+    (void)arg;
+    __atomic_fetch_add(&graph_runs, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+void *graph_leaf_task(void *arg) {
+    (void)arg;
+    __atomic_fetch_add(&graph_fanout_done, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+void *graph_sink_task(void *arg) {
+    (void)arg;
+    graph_fanout_seen = __atomic_load_n(&graph_fanout_done, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static void graph_test_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static int32_t graph_gate = 0;
+static int32_t graph_gate_started = 0;
+
+// Occupies the only worker until graph_gate is raised.
+void *graph_gate_task(void *arg) {
+    (void)arg;
+    __atomic_store_n(&graph_gate_started, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&graph_gate, __ATOMIC_ACQUIRE)) {
+        graph_test_yield();
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: A diamond runs each node after its dependencies
+FOSSIL_TEST(fossil_task_graph_diamond) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&graph_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_create(&test_graph, &graph_pool));
+
+    int32_t top = fossil_task_graph_add(&test_graph, graph_stamp_task, (void *)0);
+    int32_t left = fossil_task_graph_add(&test_graph, graph_stamp_task, (void *)1);
+    int32_t right = fossil_task_graph_add(&test_graph, graph_stamp_task, (void *)2);
+    int32_t bottom = fossil_task_graph_add(&test_graph, graph_stamp_task, (void *)3);
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, left, top));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, right, top));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, bottom, left));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, bottom, right));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_run(&test_graph));
+    ASSUME_ITS_TRUE(graph_stamps[0] < graph_stamps[1]);
+    ASSUME_ITS_TRUE(graph_stamps[0] < graph_stamps[2]);
+    ASSUME_ITS_TRUE(graph_stamps[1] < graph_stamps[3]);
+    ASSUME_ITS_TRUE(graph_stamps[2] < graph_stamps[3]);
+    ASSUME_ITS_EQUAL_I32(4, graph_clock);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_destroy(&test_graph));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&graph_pool));
+}
+
+// Test Case 2: The same graph runs repeatedly
+FOSSIL_TEST(fossil_task_graph_rerun) {
+    graph_runs = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&graph_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_create(&test_graph, &graph_pool));
+
+    // A chain of eight nodes with a second branch off every node.
+    int32_t prev = fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+    for (int i = 0; i < 7; i++) {
+        int32_t next = fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+        int32_t side = fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+        ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, next, prev));
+        ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, side, prev));
+        prev = next;
+    }
+
+    for (int run = 0; run < 100; run++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_run(&test_graph));
+    }
+    ASSUME_ITS_EQUAL_I32(100 * 15, graph_runs);
+
+    // Starting twice without waiting is refused.
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_start(&test_graph));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_task_graph_start(&test_graph));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_wait(&test_graph));
+    ASSUME_ITS_EQUAL_I32(101 * 15, graph_runs);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_destroy(&test_graph));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&graph_pool));
+}
+
+// Test Case 3: Invalid edges and cycles are rejected
+FOSSIL_TEST(fossil_task_graph_invalid) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&graph_pool, 2));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_create(&test_graph, &graph_pool));
+
+    // An empty graph finishes immediately.
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_run(&test_graph));
+
+    int32_t a = fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+    int32_t b = fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_task_graph_depend(&test_graph, a, a));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_task_graph_depend(&test_graph, a, 7));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, b, a));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, a, b));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_task_graph_run(&test_graph));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_destroy(&test_graph));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&graph_pool));
+}
+
+// Test Case 4: A wide fan-out spreads across the workers and joins again
+FOSSIL_TEST(fossil_task_graph_fanout) {
+    graph_fanout_done = 0;
+    graph_fanout_seen = -1;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&graph_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_create(&test_graph, &graph_pool));
+
+    int32_t root = fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+    int32_t sink = fossil_task_graph_add(&test_graph, graph_sink_task, NULL);
+    for (int i = 0; i < GRAPH_TEST_FANOUT; i++) {
+        int32_t leaf = fossil_task_graph_add(&test_graph, graph_leaf_task, NULL);
+        ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, leaf, root));
+        ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_depend(&test_graph, sink, leaf));
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_run(&test_graph));
+    ASSUME_ITS_EQUAL_I32(GRAPH_TEST_FANOUT, graph_fanout_seen);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_destroy(&test_graph));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&graph_pool));
+}
+
+// Test Case 5: DROP_OLDEST never discards a queued graph node
+FOSSIL_TEST(fossil_task_graph_drop_oldest) {
+    fossil_thread_pool_stats_t stats;
+    graph_runs = 0;
+    graph_gate = 0;
+    graph_gate_started = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&graph_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_max_spares(&graph_pool, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&graph_pool, 1, FOSSIL_THREAD_POOL_DROP_OLDEST));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&graph_pool, graph_gate_task, NULL));
+    while (!__atomic_load_n(&graph_gate_started, __ATOMIC_ACQUIRE)) {
+        graph_test_yield();
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_create(&test_graph, &graph_pool));
+    fossil_task_graph_add(&test_graph, graph_count_task, NULL);
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_start(&test_graph));
+    // Only the graph's node is queued, so this submission is rejected.
+    ASSUME_ITS_EQUAL_I32(-1, fossil_thread_pool_submit(&graph_pool, graph_count_task, NULL));
+
+    __atomic_store_n(&graph_gate, 1, __ATOMIC_RELEASE);
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_wait(&test_graph));
+    ASSUME_ITS_EQUAL_I32(1, graph_runs);
+    fossil_thread_pool_stats(&graph_pool, &stats);
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)stats.dropped);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_task_graph_destroy(&test_graph));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&graph_pool));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_graph_tests) {
+    ADD_TEST(fossil_task_graph_diamond);
+    ADD_TEST(fossil_task_graph_rerun);
+    ADD_TEST(fossil_task_graph_invalid);
+    ADD_TEST(fossil_task_graph_fanout);
+    ADD_TEST(fossil_task_graph_drop_oldest);
+}
@@ -0,0 +1,168 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+// Test variables
+#define MAP_TEST_WRITERS 4
+#define MAP_TEST_KEYS 20000
+
+fossil_concurrent_map_t test_map;
+static int map_missing = 0;
+
+void *map_writer_thread(void *arg) {
+    uint64_t base = (uint64_t)(uintptr_t)arg * MAP_TEST_KEYS;
+    for (uint64_t i = 0; i < MAP_TEST_KEYS; i++) {
+        fossil_concurrent_map_insert(&test_map, base + i, (void *)(uintptr_t)(base + i + 1));
+    }
+    // Erase every other key while the other writers may still be growing the table.
+    for (uint64_t i = 0; i < MAP_TEST_KEYS; i += 2) {
+        fossil_concurrent_map_erase(&test_map, base + i, NULL);
+    }
+    return NULL;
+}
+
+void *map_reader_thread(void *arg) {
+    (void)arg;
+    // UINT64_MAX is inserted before the readers start and never erased.
+    for (int i = 0; i < 100000; i++) {
+        void *value = NULL;
+        if (fossil_concurrent_map_get(&test_map, UINT64_MAX, &value) != 0 || value != (void *)1) {
+            __atomic_fetch_add(&map_missing, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Insert, look up, replace and erase a key
+FOSSIL_TEST(fossil_concurrent_map_basic) {
+    void *value = NULL;
+    int a = 1, b = 2;
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_create(&test_map, 0));
+
+    ASSUME_ITS_EQUAL_I32(-1, fossil_concurrent_map_get(&test_map, 42, &value));
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_insert(&test_map, 42, &a));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_concurrent_map_insert(&test_map, 42, &b));
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_get(&test_map, 42, &value));
+    ASSUME_ITS_TRUE(value == &a);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_put(&test_map, 42, &b, &value));
+    ASSUME_ITS_TRUE(value == &a);
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_get(&test_map, 42, &value));
+    ASSUME_ITS_TRUE(value == &b);
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)fossil_concurrent_map_size(&test_map));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_erase(&test_map, 42, &value));
+    ASSUME_ITS_TRUE(value == &b);
+    ASSUME_ITS_EQUAL_I32(-1, fossil_concurrent_map_erase(&test_map, 42, NULL));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_concurrent_map_get(&test_map, 42, NULL));
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)fossil_concurrent_map_size(&test_map));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_destroy(&test_map));
+}
+
+// Test Case 2: The table grows while keeping every key
+FOSSIL_TEST(fossil_concurrent_map_grow) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_create(&test_map, 0));
+    for (uint64_t key = 0; key < 100000; key++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_insert(&test_map, key * 7919, (void *)(uintptr_t)(key + 1)));
+    }
+    ASSUME_ITS_EQUAL_I32(100000, (int32_t)fossil_concurrent_map_size(&test_map));
+
+    int32_t wrong = 0;
+    for (uint64_t key = 0; key < 100000; key++) {
+        void *value = NULL;
+        if (fossil_concurrent_map_get(&test_map, key * 7919, &value) != 0 || value != (void *)(uintptr_t)(key + 1)) {
+            wrong++;
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(0, wrong);
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_destroy(&test_map));
+}
+
+// Test Case 3: Concurrent writers and lock-free readers
+FOSSIL_TEST(fossil_concurrent_map_concurrent) {
+    fossil_thread_t writers[MAP_TEST_WRITERS];
+    fossil_thread_t readers[2];
+    map_missing = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_create(&test_map, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_insert(&test_map, UINT64_MAX, (void *)1));
+
+    for (uintptr_t i = 0; i < MAP_TEST_WRITERS; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&writers[i], NULL, map_writer_thread, (void *)i));
+    }
+    for (int i = 0; i < 2; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&readers[i], NULL, map_reader_thread, NULL));
+    }
+    for (int i = 0; i < MAP_TEST_WRITERS; i++) {
+        fossil_thread_join(writers[i], NULL);
+    }
+    for (int i = 0; i < 2; i++) {
+        fossil_thread_join(readers[i], NULL);
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, map_missing);
+    ASSUME_ITS_EQUAL_I32(MAP_TEST_WRITERS * MAP_TEST_KEYS / 2 + 1, (int32_t)fossil_concurrent_map_size(&test_map));
+
+    int32_t wrong = 0;
+    for (uint64_t key = 0; key < MAP_TEST_WRITERS * MAP_TEST_KEYS; key++) {
+        void *value = NULL;
+        int32_t found = fossil_concurrent_map_get(&test_map, key, &value);
+        if ((key & 1) ? (found != 0 || value != (void *)(uintptr_t)(key + 1)) : found == 0) wrong++;
+    }
+    ASSUME_ITS_EQUAL_I32(0, wrong);
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_destroy(&test_map));
+}
+
+// Test Case 4: Lookups see keys of probe chains that are only partly migrated
+FOSSIL_TEST(fossil_concurrent_map_partial_migration) {
+    // 256 buckets start growing at the 1345th key. Every later write then
+    // migrates the next 16 buckets, leaving chains split across the boundary.
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_create(&test_map, 1000));
+    for (uint64_t key = 0; key < 1345; key++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_insert(&test_map, key, (void *)(uintptr_t)(key + 1)));
+    }
+
+    int32_t wrong = 0;
+    for (uint64_t step = 0; step < 20; step++) {
+        fossil_concurrent_map_erase(&test_map, UINT64_MAX - step, NULL);
+        for (uint64_t key = 0; key < 1345; key++) {
+            void *value = NULL;
+            if (fossil_concurrent_map_get(&test_map, key, &value) != 0 || value != (void *)(uintptr_t)(key + 1)) {
+                wrong++;
+            }
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(0, wrong);
+    ASSUME_ITS_EQUAL_I32(0, fossil_concurrent_map_destroy(&test_map));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_map_tests) {
+    ADD_TEST(fossil_concurrent_map_basic);
+    ADD_TEST(fossil_concurrent_map_grow);
+    ADD_TEST(fossil_concurrent_map_concurrent);
+    ADD_TEST(fossil_concurrent_map_partial_migration);
+}
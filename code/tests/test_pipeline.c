@@ -0,0 +1,268 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+// Test variables
+#define PIPELINE_TEST_ITEMS 2000
+#define PIPELINE_TEST_TOKENS 8
+
+fossil_thread_pool_t pipeline_pool;
+fossil_pipeline_t test_pipeline;
+static int32_t pipeline_items[PIPELINE_TEST_ITEMS];
+static int32_t pipeline_next_input = 0;
+static int32_t pipeline_live = 0;
+static int32_t pipeline_max_live = 0;
+static int32_t pipeline_in_serial = 0;
+static int32_t pipeline_overlap = 0;
+static int32_t pipeline_last = -1;
+static int32_t pipeline_out_of_order = 0;
+static int32_t pipeline_count = 0;
+
+void *pipeline_input_stage(void *item, void *context) {
+    (void)item;
+    (void)context;
+    if (pipeline_next_input == PIPELINE_TEST_ITEMS) return NULL;
+    int32_t *value = &pipeline_items[pipeline_next_input];
+    *value = pipeline_next_input++;
+
+    int32_t live = __atomic_add_fetch(&pipeline_live, 1, __ATOMIC_RELAXED);
+    int32_t max = __atomic_load_n(&pipeline_max_live, __ATOMIC_RELAXED);
+    while (live > max && !__atomic_compare_exchange_n(&pipeline_max_live, &max, live, 0,
+                                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return value;
+}
+
+void *pipeline_square_stage(void *item, void *context) {
+    (void)context;
+    int32_t *value = (int32_t *)item;
+    // Uneven work so that items overtake each other.
+    for (volatile int i = 0; i < (*value % 7) * 200; i++) {
+    }
+    *value = *value * 2;
+    return value;
+}
+
+void *pipeline_drop_odd_stage(void *item, void *context) {
+    (void)context;
+    int32_t *value = (int32_t *)item;
+    if ((*value / 2) & 1) {
+        __atomic_fetch_sub(&pipeline_live, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    return value;
+}
+
+void *pipeline_ordered_sink(void *item, void *context) {
+    (void)context;
+    int32_t *value = (int32_t *)item;
+    if (*value <= pipeline_last) pipeline_out_of_order++;
+    pipeline_last = *value;
+    pipeline_count++;
+    __atomic_fetch_sub(&pipeline_live, 1, __ATOMIC_RELAXED);
+    return item;
+}
+
+void *pipeline_serial_sink(void *item, void *context) {
+    (void)context;
+    if (__atomic_exchange_n(&pipeline_in_serial, 1, __ATOMIC_ACQ_REL)) {
+        __atomic_fetch_add(&pipeline_overlap, 1, __ATOMIC_RELAXED);
+    }
+    pipeline_count++;
+    __atomic_fetch_sub(&pipeline_live, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&pipeline_in_serial, 0, __ATOMIC_RELEASE);
+    return item;
+}
+
+static void pipeline_test_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static int32_t pipeline_gate = 0;
+static int32_t pipeline_gate_started = 0;
+static int32_t pipeline_rejected = 0;
+
+// Occupies the only worker until pipeline_gate is raised.
+void *pipeline_gate_task(void *arg) {
+    (void)arg;
+    __atomic_store_n(&pipeline_gate_started, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&pipeline_gate, __ATOMIC_ACQUIRE)) {
+        pipeline_test_yield();
+    }
+    return NULL;
+}
+
+// Once the pipeline's first step is queued behind the gate, submits a task
+// that would push it out under DROP_OLDEST, then opens the gate.
+void *pipeline_pressure_thread(void *arg) {
+    (void)arg;
+    fossil_thread_pool_stats_t stats;
+    do {
+        pipeline_test_yield();
+        fossil_thread_pool_stats(&pipeline_pool, &stats);
+    } while (stats.queue_depth == 0);
+
+    pipeline_rejected = fossil_thread_pool_submit(&pipeline_pool, pipeline_gate_task, NULL) != 0;
+    __atomic_store_n(&pipeline_gate, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void pipeline_reset(void) {
+    pipeline_next_input = 0;
+    pipeline_live = 0;
+    pipeline_max_live = 0;
+    pipeline_overlap = 0;
+    pipeline_last = -1;
+    pipeline_out_of_order = 0;
+    pipeline_count = 0;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: An in-order stage sees items in input order
+FOSSIL_TEST(fossil_pipeline_in_order) {
+    pipeline_reset();
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pipeline_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_create(&test_pipeline, &pipeline_pool, PIPELINE_TEST_TOKENS));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_input_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_PARALLEL, pipeline_square_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_ordered_sink, NULL));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_run(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(PIPELINE_TEST_ITEMS, pipeline_count);
+    ASSUME_ITS_EQUAL_I32(0, pipeline_out_of_order);
+    ASSUME_ITS_EQUAL_I32(2 * (PIPELINE_TEST_ITEMS - 1), pipeline_last);
+    ASSUME_ITS_TRUE(pipeline_max_live <= PIPELINE_TEST_TOKENS);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_destroy(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pipeline_pool));
+}
+
+// Test Case 2: Dropped items do not hold back the ones behind them
+FOSSIL_TEST(fossil_pipeline_filter) {
+    pipeline_reset();
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pipeline_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_create(&test_pipeline, &pipeline_pool, PIPELINE_TEST_TOKENS));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_input_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_PARALLEL, pipeline_square_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_PARALLEL, pipeline_drop_odd_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_ordered_sink, NULL));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_run(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(PIPELINE_TEST_ITEMS / 2, pipeline_count);
+    ASSUME_ITS_EQUAL_I32(0, pipeline_out_of_order);
+    ASSUME_ITS_EQUAL_I32(0, pipeline_live);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_destroy(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pipeline_pool));
+}
+
+// Test Case 3: A serial stage never runs twice at once, across repeated runs
+FOSSIL_TEST(fossil_pipeline_serial_rerun) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pipeline_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_create(&test_pipeline, &pipeline_pool, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_input_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_PARALLEL, pipeline_square_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_OUT_OF_ORDER, pipeline_serial_sink, NULL));
+
+    for (int run = 0; run < 3; run++) {
+        pipeline_reset();
+        ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_run(&test_pipeline));
+        ASSUME_ITS_EQUAL_I32(PIPELINE_TEST_ITEMS, pipeline_count);
+        ASSUME_ITS_EQUAL_I32(0, pipeline_overlap);
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_destroy(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pipeline_pool));
+}
+
+// Test Case 4: A pipeline without stages cannot run
+FOSSIL_TEST(fossil_pipeline_empty) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pipeline_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_create(&test_pipeline, &pipeline_pool, 1));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_pipeline_run(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_PARALLEL, NULL, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_destroy(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pipeline_pool));
+}
+
+// Test Case 5: DROP_OLDEST never discards a queued pipeline step
+FOSSIL_TEST(fossil_pipeline_drop_oldest) {
+    fossil_thread_t pressure;
+    fossil_thread_pool_stats_t stats;
+    pipeline_reset();
+    pipeline_gate = 0;
+    pipeline_gate_started = 0;
+    pipeline_rejected = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pipeline_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_max_spares(&pipeline_pool, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&pipeline_pool, 1, FOSSIL_THREAD_POOL_DROP_OLDEST));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pipeline_pool, pipeline_gate_task, NULL));
+    while (!__atomic_load_n(&pipeline_gate_started, __ATOMIC_ACQUIRE)) {
+        pipeline_test_yield();
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_create(&test_pipeline, &pipeline_pool, PIPELINE_TEST_TOKENS));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_input_stage, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_add_stage(&test_pipeline, FOSSIL_PIPELINE_SERIAL_IN_ORDER, pipeline_ordered_sink, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&pressure, NULL, pipeline_pressure_thread, NULL));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_run(&test_pipeline));
+    fossil_thread_join(pressure, NULL);
+    ASSUME_ITS_EQUAL_I32(1, pipeline_rejected);
+    ASSUME_ITS_EQUAL_I32(PIPELINE_TEST_ITEMS, pipeline_count);
+    fossil_thread_pool_stats(&pipeline_pool, &stats);
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)stats.dropped);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_destroy(&test_pipeline));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pipeline_pool));
+}
+
+// Test Case 6: The default token count follows the pool's size, even
+// before a lazy pool has started any worker
+FOSSIL_TEST(fossil_pipeline_default_tokens) {
+    // Creating a pipeline submits nothing, so the shared pool stays idle.
+    fossil_thread_pool_t *pool = fossil_thread_pool_default();
+    ASSUME_NOT_CNULL(pool);
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_create(&test_pipeline, pool, 0));
+    ASSUME_ITS_EQUAL_I32((int32_t)(2 * pool->spare_capacity), (int32_t)test_pipeline.max_tokens);
+    ASSUME_ITS_EQUAL_I32(0, fossil_pipeline_destroy(&test_pipeline));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_pipeline_tests) {
+    ADD_TEST(fossil_pipeline_in_order);
+    ADD_TEST(fossil_pipeline_filter);
+    ADD_TEST(fossil_pipeline_serial_rerun);
+    ADD_TEST(fossil_pipeline_empty);
+    ADD_TEST(fossil_pipeline_drop_oldest);
+    ADD_TEST(fossil_pipeline_default_tokens);
+}
@@ -17,6 +17,10 @@
 
 #include "fossil/threads/framework.h"
 
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
 // Test variables
 fossil_thread_pool_t test_pool;
 
@@ -26,6 +30,182 @@ void *simple_task(void *arg) {
     return NULL;
 }
 
+void *atomic_task(void *arg) {
+    __atomic_fetch_add((int *)arg, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+typedef struct {
+    int *counter;
+    int amount;
+} inline_state_t;
+
+static int inline_destroyed = 0;
+
+void inline_task(void *storage, int32_t run) {
+    inline_state_t *state = (inline_state_t *)storage;
+    if (run) __atomic_fetch_add(state->counter, state->amount, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&inline_destroyed, 1, __ATOMIC_RELAXED);
+}
+
+void inline_construct(void *storage, void *context) {
+    inline_state_t *state = (inline_state_t *)storage;
+    state->counter = (int *)context;
+    state->amount = 2;
+}
+
+static void pool_test_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static int pool_gate = 0;
+static int pool_gate_started = 0;
+static int pool_blocked_done = 0;
+
+// Occupies a worker until pool_gate is raised.
+void *gate_task(void *arg) {
+    (void)arg;
+    __atomic_store_n(&pool_gate_started, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&pool_gate, __ATOMIC_ACQUIRE)) {
+        pool_test_yield();
+    }
+    return NULL;
+}
+
+static void gate_close(void) {
+    pool_gate = 0;
+    pool_gate_started = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, gate_task, NULL));
+    while (!__atomic_load_n(&pool_gate_started, __ATOMIC_ACQUIRE)) {
+        pool_test_yield();
+    }
+}
+
+void *blocked_submitter(void *arg) {
+    fossil_thread_pool_submit(&test_pool, atomic_task, arg);
+    __atomic_store_n(&pool_blocked_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+fossil_thread_pool_local_t test_local;
+static int local_bad_index = 0;
+
+// Counts executions in the running worker's own slot.
+void *local_count_task(void *arg) {
+    (void)arg;
+    int32_t index = fossil_thread_pool_worker_index();
+    uint64_t *slot = (uint64_t *)fossil_thread_pool_local_get(&test_local);
+    if (index < 0 || !slot || slot != fossil_thread_pool_local_at(&test_local, (uint32_t)index)) {
+        __atomic_fetch_add(&local_bad_index, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    (*slot)++;
+    return NULL;
+}
+
+#define KEYED_KEYS 8
+#define KEYED_TASKS 400
+
+typedef struct {
+    uint32_t key;
+    uint32_t seq;
+} keyed_arg_t;
+
+static keyed_arg_t keyed_args[KEYED_TASKS];
+static int32_t keyed_worker[KEYED_KEYS];
+static uint32_t keyed_next[KEYED_KEYS];
+static int keyed_bad = 0;
+static int keyed_extra = 0;
+
+// Records the worker of each key; every task of a key must agree.
+void *keyed_affinity_task(void *arg) {
+    keyed_arg_t *item = (keyed_arg_t *)arg;
+    int32_t index = fossil_thread_pool_worker_index();
+    int32_t expected = -1;
+    if (!__atomic_compare_exchange_n(&keyed_worker[item->key], &expected, index, 0,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED) && expected != index) {
+        __atomic_fetch_add(&keyed_bad, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+// Serial tasks of a key see their predecessors' plain writes, in order.
+void *keyed_serial_task(void *arg) {
+    keyed_arg_t *item = (keyed_arg_t *)arg;
+    if (keyed_next[item->key] != item->seq) {
+        __atomic_fetch_add(&keyed_bad, 1, __ATOMIC_RELAXED);
+    }
+    keyed_next[item->key] = item->seq + 1;
+    return NULL;
+}
+
+void *cancel_poll_task(void *arg) {
+    __atomic_store_n(&pool_gate_started, 1, __ATOMIC_RELEASE);
+    while (!fossil_thread_pool_cancel_requested()) {
+        pool_test_yield();
+    }
+    __atomic_store_n((int *)arg, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+fossil_latch_t blocking_latch;
+fossil_latch_t blocking_done;
+
+// Blocks its worker until another task opens the latch.
+void *latch_wait_task(void *arg) {
+    (void)arg;
+    fossil_latch_wait(&blocking_latch);
+    fossil_latch_count_down(&blocking_done, 1);
+    return NULL;
+}
+
+void *latch_open_task(void *arg) {
+    (void)arg;
+    fossil_latch_count_down(&blocking_latch, 1);
+    return NULL;
+}
+
+// Opens the latch, then keeps its worker busy until pool_gate is raised.
+void *latch_open_gate_task(void *arg) {
+    (void)arg;
+    fossil_latch_count_down(&blocking_latch, 1);
+    while (!__atomic_load_n(&pool_gate, __ATOMIC_ACQUIRE)) {
+        pool_test_yield();
+    }
+    return NULL;
+}
+
+// Polls pool_gate inside an explicit blocking region.
+void *blocking_gate_task(void *arg) {
+    (void)arg;
+    fossil_thread_pool_enter_blocking();
+    while (!__atomic_load_n(&pool_gate, __ATOMIC_ACQUIRE)) {
+        pool_test_yield();
+    }
+    fossil_thread_pool_leave_blocking();
+    return NULL;
+}
+
+void *gate_open_task(void *arg) {
+    (void)arg;
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static int watchdog_calls = 0;
+static int watchdog_bad = 0;
+
+void watchdog_callback(fossil_thread_pool_t *pool, uint32_t worker, uint64_t running_ns, void *context) {
+    if (pool != &test_pool || worker != 0 || running_ns < 1000000 || context != &watchdog_calls) {
+        __atomic_fetch_add(&watchdog_bad, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&watchdog_calls, 1, __ATOMIC_RELAXED);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -61,6 +241,356 @@ FOSSIL_TEST(fossil_thread_pool_multiple_tasks) {
     }
 }
 
+// Test Case 4: Workers that park immediately still pick up every task
+FOSSIL_TEST(fossil_thread_pool_idle_park) {
+    int counter = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_idle(&test_pool, 0, 0));
+
+    for (int i = 0; i < 1000; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(1000, counter);
+}
+
+// Test Case 5: Spinning workers pick up every task
+FOSSIL_TEST(fossil_thread_pool_idle_spin) {
+    int counter = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 2));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_idle(&test_pool, 100000, 16));
+
+    for (int i = 0; i < 1000; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(1000, counter);
+}
+
+// Test Case 6: Statistics account for every executed task
+FOSSIL_TEST(fossil_thread_pool_stats_snapshot) {
+    int counter = 0;
+    fossil_thread_pool_stats_t stats;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 2));
+
+    if (fossil_thread_pool_stats_enable(&test_pool, 1) == 0) {
+        for (int i = 0; i < 100; i++) {
+            ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+        }
+        do {
+            ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_stats(&test_pool, &stats));
+        } while (stats.total.executed < 100);
+        // The queue depth is read before the counters, so take a fresh look.
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_stats(&test_pool, &stats));
+
+        ASSUME_ITS_EQUAL_I32(2, stats.num_workers);
+        ASSUME_ITS_EQUAL_I32(100, stats.total.submitted);
+        ASSUME_ITS_EQUAL_I32(100, stats.external_submitted);
+        ASSUME_ITS_EQUAL_I32(0, stats.queue_depth);
+
+        uint64_t samples = 0;
+        for (int b = 0; b < FOSSIL_THREAD_POOL_HISTOGRAM_BUCKETS; b++) {
+            samples += stats.wait_histogram[b];
+        }
+        ASSUME_ITS_EQUAL_I32(100, samples);
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+}
+
+// Test Case 7: Inline and emplaced task state runs and is destroyed once
+FOSSIL_TEST(fossil_thread_pool_inline_tasks) {
+    int counter = 0;
+    inline_state_t state = { &counter, 1 };
+    char oversized[FOSSIL_THREAD_POOL_INLINE_SIZE + 1] = { 0 };
+    inline_destroyed = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 2));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_thread_pool_submit_inline(&test_pool, inline_task, oversized, sizeof(oversized)));
+    for (int i = 0; i < 50; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_inline(&test_pool, inline_task, &state, sizeof(state)));
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_emplace(&test_pool, inline_task, inline_construct, &counter, sizeof(inline_state_t)));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+
+    ASSUME_ITS_EQUAL_I32(150, counter);
+    ASSUME_ITS_EQUAL_I32(100, inline_destroyed);
+}
+
+// Test Case 8: A full queue fails, runs on the caller or drops the oldest task
+FOSSIL_TEST(fossil_thread_pool_capacity_policies) {
+    int counter = 0;
+    fossil_thread_pool_stats_t stats;
+    inline_destroyed = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    gate_close();
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&test_pool, 2, FOSSIL_THREAD_POOL_FAIL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    // A rejected emplaced task is destroyed without running.
+    ASSUME_ITS_EQUAL_I32(-1, fossil_thread_pool_emplace(&test_pool, inline_task, inline_construct, &counter, sizeof(inline_state_t)));
+    ASSUME_ITS_EQUAL_I32(1, inline_destroyed);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&test_pool, 2, FOSSIL_THREAD_POOL_CALLER_RUNS));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    ASSUME_ITS_EQUAL_I32(1, __atomic_load_n(&counter, __ATOMIC_RELAXED));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&test_pool, 2, FOSSIL_THREAD_POOL_DROP_OLDEST));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_emplace(&test_pool, inline_task, inline_construct, &counter, sizeof(inline_state_t)));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_emplace(&test_pool, inline_task, inline_construct, &counter, sizeof(inline_state_t)));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    // Both plain tasks and the first emplaced one were dropped.
+    ASSUME_ITS_EQUAL_I32(2, inline_destroyed);
+
+    fossil_thread_pool_stats(&test_pool, &stats);
+    ASSUME_ITS_EQUAL_I32(3, (int32_t)stats.rejected);
+    ASSUME_ITS_EQUAL_I32(3, (int32_t)stats.dropped);
+
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(4, counter);
+    ASSUME_ITS_EQUAL_I32(3, inline_destroyed);
+}
+
+// Test Case 9: A submitter blocks until a worker makes room
+FOSSIL_TEST(fossil_thread_pool_capacity_block) {
+    int counter = 0;
+    fossil_thread_t submitter;
+    pool_blocked_done = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    gate_close();
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_capacity(&test_pool, 1, FOSSIL_THREAD_POOL_BLOCK));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&submitter, NULL, blocked_submitter, &counter));
+    for (int i = 0; i < 100; i++) {
+        pool_test_yield();
+    }
+    ASSUME_ITS_EQUAL_I32(0, __atomic_load_n(&pool_blocked_done, __ATOMIC_ACQUIRE));
+
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    fossil_thread_join(submitter, NULL);
+    ASSUME_ITS_EQUAL_I32(1, pool_blocked_done);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(2, counter);
+}
+
+// Test Case 10: Cancelled tasks are removed unrun; running ones see the request
+FOSSIL_TEST(fossil_thread_pool_cancellation) {
+    int counter = 0;
+    int stopped = 0;
+    fossil_cancel_token_t token;
+    fossil_cancel_token_t running;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_cancel_token_create(&token));
+    ASSUME_ITS_EQUAL_I32(0, fossil_cancel_token_create(&running));
+    gate_close();
+
+    for (int i = 0; i < 10; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_cancellable(&test_pool, atomic_task, &counter, &token));
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, atomic_task, &counter));
+    }
+    ASSUME_ITS_EQUAL_I32(10, (int32_t)fossil_thread_pool_cancel(&test_pool, &token));
+    ASSUME_ITS_EQUAL_I32(1, fossil_cancel_token_is_cancelled(&token));
+    // Tasks submitted with an already cancelled token never run either.
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_cancellable(&test_pool, atomic_task, &counter, &token));
+
+    __atomic_store_n(&pool_gate_started, 0, __ATOMIC_RELEASE);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_cancellable(&test_pool, cancel_poll_task, &stopped, &running));
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&pool_gate_started, __ATOMIC_ACQUIRE)) {
+        pool_test_yield();
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_cancel_token_cancel(&running));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+
+    ASSUME_ITS_EQUAL_I32(10, counter);
+    ASSUME_ITS_EQUAL_I32(1, stopped);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_cancel_requested());
+}
+
+// Test Case 11: Workers know their index and own a private slot
+FOSSIL_TEST(fossil_thread_pool_worker_local) {
+    local_bad_index = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_local_create(&test_local, &test_pool, sizeof(uint64_t)));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_thread_pool_worker_index());
+    // Spare workers get the slots after the regular ones.
+    ASSUME_ITS_TRUE(fossil_thread_pool_local_at(&test_local, 4) != NULL);
+    ASSUME_ITS_TRUE(fossil_thread_pool_local_at(&test_local, 8) == NULL);
+    ASSUME_ITS_TRUE(test_local.stride % 64 == 0);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, local_count_task, NULL));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        total += *(uint64_t *)fossil_thread_pool_local_at(&test_local, i);
+    }
+    ASSUME_ITS_EQUAL_I32(0, local_bad_index);
+    ASSUME_ITS_EQUAL_I32(1000, (int32_t)total);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_local_destroy(&test_local));
+}
+
+// Test Case 12: Tasks with the same key stay on one worker
+FOSSIL_TEST(fossil_thread_pool_keyed_affinity) {
+    keyed_bad = 0;
+    for (int i = 0; i < KEYED_KEYS; i++) keyed_worker[i] = -1;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 4));
+    for (int i = 0; i < KEYED_TASKS; i++) {
+        keyed_args[i].key = (uint32_t)(i % KEYED_KEYS);
+        keyed_args[i].seq = (uint32_t)(i / KEYED_KEYS);
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_keyed(&test_pool, keyed_args[i].key, keyed_affinity_task, &keyed_args[i]));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(0, keyed_bad);
+    for (int i = 0; i < KEYED_KEYS; i++) {
+        ASSUME_ITS_TRUE(keyed_worker[i] >= 0 && keyed_worker[i] < 4);
+    }
+}
+
+// Test Case 13: Serial tasks run in order per key, even with stealing on
+FOSSIL_TEST(fossil_thread_pool_keyed_serial) {
+    keyed_bad = 0;
+    keyed_extra = 0;
+    for (int i = 0; i < KEYED_KEYS; i++) keyed_next[i] = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 4));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_affinity_steal(&test_pool, 1));
+    for (int i = 0; i < KEYED_TASKS; i++) {
+        keyed_args[i].key = (uint32_t)(i % KEYED_KEYS);
+        keyed_args[i].seq = (uint32_t)(i / KEYED_KEYS);
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_serial(&test_pool, keyed_args[i].key, keyed_serial_task, &keyed_args[i]));
+        // Stealable keyed work alongside, so thieves visit the same FIFOs.
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_keyed(&test_pool, (uint64_t)i, atomic_task, &keyed_extra));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(0, keyed_bad);
+    ASSUME_ITS_EQUAL_I32(KEYED_TASKS, keyed_extra);
+    for (int i = 0; i < KEYED_KEYS; i++) {
+        ASSUME_ITS_EQUAL_I32(KEYED_TASKS / KEYED_KEYS, (int32_t)keyed_next[i]);
+    }
+}
+
+// Test Case 14: A task waiting on a latch does not starve the task that opens it
+FOSSIL_TEST(fossil_thread_pool_blocking_latch) {
+    fossil_thread_pool_stats_t stats;
+    fossil_latch_create(&blocking_latch, 1);
+    fossil_latch_create(&blocking_done, 1);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, latch_wait_task, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, latch_open_task, NULL));
+    fossil_latch_wait(&blocking_done);
+    fossil_thread_pool_stats(&test_pool, &stats);
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)stats.num_workers);
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)stats.spare_workers);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+}
+
+// Test Case 15: Explicit blocking regions bring in a spare, unless disabled
+FOSSIL_TEST(fossil_thread_pool_blocking_region) {
+    fossil_thread_pool_stats_t stats;
+    pool_gate = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, blocking_gate_task, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, gate_open_task, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+
+    // Without spares the gate can only be opened from outside the pool.
+    pool_gate = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_max_spares(&test_pool, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, blocking_gate_task, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, gate_open_task, NULL));
+    while (1) {
+        fossil_thread_pool_stats(&test_pool, &stats);
+        if (stats.blocked_workers == 1) break;
+        pool_test_yield();
+    }
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)stats.spare_workers);
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+}
+
+// Test Case 16: The watchdog reports a long task exactly once
+FOSSIL_TEST(fossil_thread_pool_watchdog) {
+    fossil_thread_pool_stats_t stats;
+    watchdog_calls = 0;
+    watchdog_bad = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_watchdog(&test_pool, 2000000, watchdog_callback, &watchdog_calls));
+    gate_close();
+    while (!__atomic_load_n(&watchdog_calls, __ATOMIC_RELAXED)) {
+        pool_test_yield();
+    }
+    // Let a few more scans see the same task before it ends.
+    for (int i = 0; i < 1000; i++) pool_test_yield();
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    fossil_thread_pool_stats(&test_pool, &stats);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+    ASSUME_ITS_EQUAL_I32(1, watchdog_calls);
+    ASSUME_ITS_EQUAL_I32(0, watchdog_bad);
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)stats.long_running);
+}
+
+// Test Case 17: The shared pool starts workers only once work arrives
+FOSSIL_TEST(fossil_thread_pool_default_executor) {
+    // The shared pool is never joined, so its tasks must not touch this frame.
+    static int counter = 0;
+    fossil_thread_pool_stats_t stats;
+    fossil_thread_pool_t *pool = fossil_thread_pool_default();
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_TRUE(fossil_thread_pool_default() == pool);
+    fossil_thread_pool_stats(pool, &stats);
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)stats.num_workers);
+
+    for (int i = 0; i < 100; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(pool, atomic_task, &counter));
+    }
+    // Keyed routing starts the worker a key maps to.
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit_keyed(pool, 7, atomic_task, &counter));
+    while (__atomic_load_n(&counter, __ATOMIC_ACQUIRE) != 101) {
+        pool_test_yield();
+    }
+    fossil_thread_pool_stats(pool, &stats);
+    ASSUME_ITS_TRUE(stats.num_workers >= 1);
+    ASSUME_ITS_TRUE(stats.num_workers <= pool->spare_capacity);
+}
+
+// Test Case 18: A spare that parks after its task does not hold up RCU
+FOSSIL_TEST(fossil_thread_pool_spare_rcu_offline) {
+    fossil_thread_pool_stats_t stats;
+    pool_gate = 0;
+    fossil_latch_create(&blocking_latch, 1);
+    fossil_latch_create(&blocking_done, 1);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_max_spares(&test_pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, latch_wait_task, NULL));
+    while (1) {
+        fossil_thread_pool_stats(&test_pool, &stats);
+        if (stats.blocked_workers == 1) break;
+        pool_test_yield();
+    }
+
+    // The spare runs this task until after the blocked worker is back.
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&test_pool, latch_open_gate_task, NULL));
+    fossil_latch_wait(&blocking_done);
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+
+    // The spare reports a quiescent state after its task and then parks; the
+    // second grace period can only end if it went offline before parking.
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_synchronize());
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_synchronize());
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&test_pool));
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -69,4 +599,19 @@ FOSSIL_TEST_GROUP(c_pool_tests) {
     ADD_TEST(fossil_thread_pool_create_and_destroy);
     ADD_TEST(fossil_thread_pool_submit_task);
     ADD_TEST(fossil_thread_pool_multiple_tasks);
+    ADD_TEST(fossil_thread_pool_idle_park);
+    ADD_TEST(fossil_thread_pool_idle_spin);
+    ADD_TEST(fossil_thread_pool_stats_snapshot);
+    ADD_TEST(fossil_thread_pool_inline_tasks);
+    ADD_TEST(fossil_thread_pool_capacity_policies);
+    ADD_TEST(fossil_thread_pool_capacity_block);
+    ADD_TEST(fossil_thread_pool_cancellation);
+    ADD_TEST(fossil_thread_pool_worker_local);
+    ADD_TEST(fossil_thread_pool_keyed_affinity);
+    ADD_TEST(fossil_thread_pool_keyed_serial);
+    ADD_TEST(fossil_thread_pool_blocking_latch);
+    ADD_TEST(fossil_thread_pool_blocking_region);
+    ADD_TEST(fossil_thread_pool_watchdog);
+    ADD_TEST(fossil_thread_pool_default_executor);
+    ADD_TEST(fossil_thread_pool_spare_rcu_offline);
 }
@@ -0,0 +1,140 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <system_error>
+
+// Test variables
+#define CPP_POOL_TASKS 1000
+
+static std::atomic<int> cpp_pool_count{0};
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Small trivially copyable lambdas are copied into the node
+FOSSIL_TEST(cpp_pool_submit_trivial) {
+    cpp_pool_count = 0;
+    {
+        fossil::thread_pool pool(4);
+        std::atomic<int> *count = &cpp_pool_count;
+        for (int i = 0; i < CPP_POOL_TASKS; i++) {
+            pool.submit([count, i] { count->fetch_add(i >= 0, std::memory_order_relaxed); });
+        }
+        ASSUME_ITS_EQUAL_I32(4, (int32_t)pool.size());
+    }
+    ASSUME_ITS_EQUAL_I32(CPP_POOL_TASKS, cpp_pool_count.load());
+}
+
+// Test Case 2: Callables that fit but are not trivially copyable are
+// move-constructed in place and destroyed after running
+FOSSIL_TEST(cpp_pool_submit_emplaced) {
+    cpp_pool_count = 0;
+    auto owner = std::make_shared<int>(1);
+    {
+        fossil::thread_pool pool(4);
+        for (int i = 0; i < CPP_POOL_TASKS; i++) {
+            pool.submit([owner] { cpp_pool_count.fetch_add(*owner, std::memory_order_relaxed); });
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(CPP_POOL_TASKS, cpp_pool_count.load());
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)owner.use_count());
+}
+
+// Test Case 3: Callables larger than the node are boxed on the heap
+FOSSIL_TEST(cpp_pool_submit_boxed) {
+    cpp_pool_count = 0;
+    auto owner = std::make_shared<int>(1);
+    std::array<int, 64> values{};
+    values[63] = 1;
+    {
+        fossil::thread_pool pool(4);
+        for (int i = 0; i < CPP_POOL_TASKS; i++) {
+            pool.submit([owner, values] { cpp_pool_count.fetch_add(values[63], std::memory_order_relaxed); });
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(CPP_POOL_TASKS, cpp_pool_count.load());
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)owner.use_count());
+}
+
+// Test Case 4: A rejected submit throws and destroys the callable
+FOSSIL_TEST(cpp_pool_submit_rejected) {
+    auto owner = std::make_shared<int>(1);
+    fossil::semaphore release;
+    fossil::semaphore started;
+    int32_t threw = 0;
+    {
+        fossil::thread_pool pool(1);
+        // No spare may drain the queue while the worker waits.
+        fossil_thread_pool_set_max_spares(pool.native_handle(), 0);
+        fossil_thread_pool_set_capacity(pool.native_handle(), 1, FOSSIL_THREAD_POOL_FAIL);
+        pool.submit([&] {
+            started.release();
+            release.acquire();
+        });
+        started.acquire();
+        pool.submit([owner] {});
+        try {
+            pool.submit([owner] {});
+        } catch (const std::system_error &) {
+            threw = 1;
+        }
+        ASSUME_ITS_EQUAL_I32(2, (int32_t)owner.use_count());
+        release.release();
+    }
+    ASSUME_ITS_EQUAL_I32(1, threw);
+    ASSUME_ITS_EQUAL_I32(1, (int32_t)owner.use_count());
+}
+
+// Test Case 5: The mutex and condition variable work with the std lock types
+FOSSIL_TEST(cpp_pool_mutex_condition) {
+    fossil::mutex mutex;
+    fossil::condition_variable ready;
+    int counter = 0;
+    {
+        fossil::thread_pool pool(4);
+        for (int i = 0; i < CPP_POOL_TASKS; i++) {
+            pool.submit([&] {
+                fossil::lock_guard guard(mutex);
+                if (++counter == CPP_POOL_TASKS) ready.notify_all();
+            });
+        }
+        fossil::unique_lock lock(mutex);
+        ready.wait(lock, [&] { return counter == CPP_POOL_TASKS; });
+    }
+    ASSUME_ITS_EQUAL_I32(CPP_POOL_TASKS, counter);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// The generated runner is C.
+extern "C" void cpp_pool_tests(void);
+
+FOSSIL_TEST_GROUP(cpp_pool_tests) {
+    ADD_TEST(cpp_pool_submit_trivial);
+    ADD_TEST(cpp_pool_submit_emplaced);
+    ADD_TEST(cpp_pool_submit_boxed);
+    ADD_TEST(cpp_pool_submit_rejected);
+    ADD_TEST(cpp_pool_mutex_condition);
+}
@@ -0,0 +1,250 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+// Test variables
+#define RCU_LIVE 0x11
+#define RCU_DEAD 0xDD
+#define RCU_NODES 512
+#define RCU_READERS 3
+
+typedef struct {
+    int magic;
+} rcu_test_node_t;
+
+static rcu_test_node_t rcu_nodes[RCU_NODES];
+static void *rcu_shared = NULL;
+static int rcu_reclaimed = 0;
+static int rcu_bad_reads = 0;
+static int rcu_stop = 0;
+
+static void rcu_test_reclaim(void *ptr) {
+    __atomic_store_n(&((rcu_test_node_t *)ptr)->magic, RCU_DEAD, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&rcu_reclaimed, 1, __ATOMIC_RELAXED);
+}
+
+static void rcu_test_read(void) {
+    fossil_rcu_read_lock();
+    rcu_test_node_t *node = (rcu_test_node_t *)fossil_rcu_dereference(&rcu_shared);
+    for (int spin = 0; spin < 16; spin++) {
+        if (node && __atomic_load_n(&node->magic, __ATOMIC_RELAXED) != RCU_LIVE) {
+            __atomic_fetch_add(&rcu_bad_reads, 1, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    fossil_rcu_read_unlock();
+}
+
+void *rcu_reader_thread(void *arg) {
+    (void)arg;
+    while (!__atomic_load_n(&rcu_stop, __ATOMIC_ACQUIRE)) {
+        rcu_test_read();
+    }
+    fossil_rcu_unregister();
+    return NULL;
+}
+
+void *rcu_reader_task(void *arg) {
+    (void)arg;
+    for (int i = 0; i < 1000; i++) {
+        rcu_test_read();
+    }
+    return NULL;
+}
+
+void *rcu_sync_task(void *arg) {
+    // Runs on an online worker, which synchronize must not wait for.
+    *(int32_t *)arg = fossil_rcu_synchronize();
+    return NULL;
+}
+
+static void rcu_test_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static int32_t rcu_hold = 0;
+
+void *rcu_hold_task(void *arg) {
+    (void)arg;
+    fossil_rcu_read_lock();
+    while (__atomic_load_n(&rcu_hold, __ATOMIC_ACQUIRE)) {
+        rcu_test_yield();
+    }
+    fossil_rcu_read_unlock();
+    return NULL;
+}
+
+fossil_latch_t rcu_latch;
+
+void *rcu_latch_task(void *arg) {
+    (void)arg;
+    fossil_latch_wait(&rcu_latch);
+    return NULL;
+}
+
+// Replace the shared node, retiring the old one either way.
+static void rcu_test_publish(int index, int deferred) {
+    rcu_test_node_t *node = &rcu_nodes[index];
+    __atomic_store_n(&node->magic, RCU_LIVE, __ATOMIC_RELAXED);
+    void *old = fossil_rcu_dereference(&rcu_shared);
+    fossil_rcu_assign_pointer(&rcu_shared, node);
+    if (!old) return;
+    if (deferred) {
+        fossil_rcu_call(old, rcu_test_reclaim);
+    } else {
+        fossil_rcu_synchronize();
+        rcu_test_reclaim(old);
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Sections nest and synchronize refuses to run inside one
+FOSSIL_TEST(fossil_rcu_read_sections) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_register());
+    fossil_rcu_read_lock();
+    fossil_rcu_read_lock();
+    ASSUME_ITS_EQUAL_I32(-1, fossil_rcu_synchronize());
+    ASSUME_ITS_EQUAL_I32(-1, fossil_rcu_unregister());
+    fossil_rcu_read_unlock();
+    ASSUME_ITS_EQUAL_I32(-1, fossil_rcu_barrier());
+    fossil_rcu_read_unlock();
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_synchronize());
+
+    // An online thread is its own reader and must not block itself.
+    fossil_rcu_thread_online();
+    fossil_rcu_quiescent_state();
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_synchronize());
+    fossil_rcu_thread_offline();
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_unregister());
+}
+
+// Test Case 2: Readers never see a node reclaimed after a grace period
+FOSSIL_TEST(fossil_rcu_readers_and_writer) {
+    fossil_thread_t readers[RCU_READERS];
+    rcu_shared = NULL;
+    rcu_reclaimed = 0;
+    rcu_bad_reads = 0;
+    rcu_stop = 0;
+
+    rcu_test_publish(0, 0);
+    for (int i = 0; i < RCU_READERS; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&readers[i], NULL, rcu_reader_thread, NULL));
+    }
+    for (int i = 1; i < RCU_NODES; i++) {
+        rcu_test_publish(i, i % 2);
+    }
+    __atomic_store_n(&rcu_stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < RCU_READERS; i++) {
+        fossil_thread_join(readers[i], NULL);
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_barrier());
+    ASSUME_ITS_EQUAL_I32(0, rcu_bad_reads);
+    ASSUME_ITS_EQUAL_I32(RCU_NODES - 1, rcu_reclaimed);
+}
+
+// Test Case 3: Pool workers report quiescent states on their own
+FOSSIL_TEST(fossil_rcu_pool_workers) {
+    fossil_thread_pool_t pool;
+    int32_t sync_result = -1;
+    rcu_shared = NULL;
+    rcu_reclaimed = 0;
+    rcu_bad_reads = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 4));
+    rcu_test_publish(0, 0);
+    for (int i = 0; i < 16; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pool, rcu_reader_task, NULL));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pool, rcu_sync_task, &sync_result));
+    for (int i = 1; i < 64; i++) {
+        rcu_test_publish(i, i % 2);
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_barrier());
+    ASSUME_ITS_EQUAL_I32(0, sync_result);
+    ASSUME_ITS_EQUAL_I32(0, rcu_bad_reads);
+    ASSUME_ITS_EQUAL_I32(63, rcu_reclaimed);
+}
+
+// Test Case 4: A worker blocked in a library wait does not hold up RCU
+FOSSIL_TEST(fossil_rcu_blocked_worker) {
+    fossil_thread_pool_t pool;
+    fossil_thread_pool_stats_t stats;
+    fossil_latch_create(&rcu_latch, 1);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pool, rcu_latch_task, NULL));
+    while (1) {
+        fossil_thread_pool_stats(&pool, &stats);
+        if (stats.blocked_workers == 1) break;
+    }
+
+    // The latch only opens once the grace period is over.
+    ASSUME_ITS_EQUAL_I32(0, fossil_rcu_synchronize());
+    fossil_latch_count_down(&rcu_latch, 1);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+    fossil_latch_destroy(&rcu_latch);
+}
+
+// Test Case 5: A worker that blocks on the grace-period lock stays offline
+FOSSIL_TEST(fossil_rcu_contended_synchronize) {
+    fossil_thread_pool_t pool;
+    fossil_thread_pool_stats_t stats;
+    int32_t sync_results[2] = {-1, -1};
+    rcu_hold = 1;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 3));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_set_max_spares(&pool, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pool, rcu_hold_task, NULL));
+    for (int i = 0; i < 2; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pool, rcu_sync_task, &sync_results[i]));
+    }
+
+    // One synchronize waits for the held section, the other for its lock.
+    while (1) {
+        fossil_thread_pool_stats(&pool, &stats);
+        if (stats.blocked_workers == 1) break;
+    }
+    __atomic_store_n(&rcu_hold, 0, __ATOMIC_RELEASE);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+    ASSUME_ITS_EQUAL_I32(0, sync_results[0]);
+    ASSUME_ITS_EQUAL_I32(0, sync_results[1]);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_rcu_tests) {
+    ADD_TEST(fossil_rcu_read_sections);
+    ADD_TEST(fossil_rcu_readers_and_writer);
+    ADD_TEST(fossil_rcu_pool_workers);
+    ADD_TEST(fossil_rcu_blocked_worker);
+    ADD_TEST(fossil_rcu_contended_synchronize);
+}
@@ -0,0 +1,228 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+#include <string.h>
+
+// Test variables
+fossil_slab_t test_slab;
+
+#define SLAB_TEST_OBJECTS 1000
+#define SLAB_TEST_LIVE 300
+#define SLAB_TEST_IN_USE 24
+#define SLAB_TEST_USERS 4
+
+static void *remote_objects[SLAB_TEST_OBJECTS];
+static fossil_slab_t live_slabs[SLAB_TEST_LIVE];
+
+void *slab_remote_free(void *arg) {
+    fossil_slab_t *slab = (fossil_slab_t *)arg;
+    for (int i = 0; i < SLAB_TEST_OBJECTS; i++) {
+        fossil_slab_free(slab, remote_objects[i]);
+    }
+    return NULL;
+}
+
+// Allocates and frees one object, then exits, leaving its cache behind.
+void *slab_touch(void *arg) {
+    fossil_slab_t *slab = (fossil_slab_t *)arg;
+    void *object = fossil_slab_alloc(slab);
+    fossil_slab_free(slab, object);
+    return object;
+}
+
+// Cycles an object through every in-use slab. Each thread keeps its own
+// cache for every slab, so a freed object comes straight back.
+void *slab_round_robin(void *arg) {
+    (void)arg;
+    void *last[SLAB_TEST_IN_USE] = { NULL };
+    uintptr_t misses = 0;
+    for (int round = 0; round < 2000; round++) {
+        for (int i = 0; i < SLAB_TEST_IN_USE; i++) {
+            void *object = fossil_slab_alloc(&live_slabs[i]);
+            if (!object || (round && object != last[i])) misses++;
+            last[i] = object;
+            fossil_slab_free(&live_slabs[i], object);
+        }
+    }
+    return (void *)misses;
+}
+
+void *scratch_task(void *arg) {
+    char *scratch = (char *)fossil_thread_pool_scratch_alloc(256);
+    if (scratch) {
+        memset(scratch, 0xAB, 256);
+        __atomic_fetch_add((int *)arg, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Objects are distinct, aligned and reused after free
+FOSSIL_TEST(fossil_slab_alloc_and_free) {
+    void *objects[SLAB_TEST_OBJECTS];
+    ASSUME_ITS_EQUAL_I32(0, fossil_slab_create(&test_slab, 40));
+
+    for (int i = 0; i < SLAB_TEST_OBJECTS; i++) {
+        objects[i] = fossil_slab_alloc(&test_slab);
+        ASSUME_NOT_CNULL(objects[i]);
+        ASSUME_ITS_EQUAL_I32(0, (int32_t)((uintptr_t)objects[i] & 15));
+        memset(objects[i], i & 0xFF, 40);
+    }
+    for (int i = 1; i < SLAB_TEST_OBJECTS; i++) {
+        ASSUME_ITS_TRUE(objects[i] != objects[i - 1]);
+    }
+
+    void *last = objects[SLAB_TEST_OBJECTS - 1];
+    for (int i = 0; i < SLAB_TEST_OBJECTS; i++) {
+        fossil_slab_free(&test_slab, objects[i]);
+    }
+    ASSUME_ITS_TRUE(fossil_slab_alloc(&test_slab) == last);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_slab_destroy(&test_slab));
+}
+
+// Test Case 2: Objects freed on another thread return to their owner
+FOSSIL_TEST(fossil_slab_remote_free) {
+    fossil_thread_t thread;
+    ASSUME_ITS_EQUAL_I32(0, fossil_slab_create(&test_slab, 64));
+
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < SLAB_TEST_OBJECTS; i++) {
+            remote_objects[i] = fossil_slab_alloc(&test_slab);
+            ASSUME_NOT_CNULL(remote_objects[i]);
+        }
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&thread, NULL, slab_remote_free, &test_slab));
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(thread, NULL));
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_slab_destroy(&test_slab));
+}
+
+// Test Case 3: Oversized objects are rejected
+FOSSIL_TEST(fossil_slab_create_invalid) {
+    ASSUME_ITS_EQUAL_I32(-1, fossil_slab_create(&test_slab, 0));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_slab_create(&test_slab, FOSSIL_SLAB_MAX_OBJECT + 1));
+}
+
+// Test Case 4: Size classes cover small sizes and fall back to malloc
+FOSSIL_TEST(fossil_slab_size_classes) {
+    size_t sizes[] = { 1, 24, 100, 2048, 2049, 100000 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        char *ptr = (char *)fossil_slab_alloc_size(sizes[i]);
+        ASSUME_NOT_CNULL(ptr);
+        memset(ptr, 0x5A, sizes[i]);
+        fossil_slab_free_size(ptr, sizes[i]);
+    }
+}
+
+// Test Case 5: Resetting an arena rewinds it to its first chunk
+FOSSIL_TEST(fossil_arena_reset_reuses) {
+    fossil_arena_t arena;
+    ASSUME_ITS_EQUAL_I32(0, fossil_arena_create(&arena, 1024));
+
+    void *first = fossil_arena_alloc(&arena, 100);
+    ASSUME_NOT_CNULL(first);
+    for (int i = 0; i < 64; i++) {
+        ASSUME_NOT_CNULL(fossil_arena_alloc(&arena, 100));
+    }
+    ASSUME_NOT_CNULL(fossil_arena_alloc(&arena, 4096));
+
+    fossil_arena_reset(&arena);
+    ASSUME_ITS_TRUE(fossil_arena_alloc(&arena, 100) == first);
+    ASSUME_ITS_EQUAL_I32(0, fossil_arena_destroy(&arena));
+}
+
+// Test Case 6: Pool tasks get scratch memory, other threads do not
+FOSSIL_TEST(fossil_slab_pool_scratch) {
+    fossil_thread_pool_t pool;
+    int counter = 0;
+
+    ASSUME_ITS_TRUE(fossil_thread_pool_scratch_alloc(16) == NULL);
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&pool, 2));
+    for (int i = 0; i < 100; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_submit(&pool, scratch_task, &counter));
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&pool));
+    ASSUME_ITS_EQUAL_I32(100, counter);
+}
+
+// Test Case 7: Any number of live slabs hand exited threads' caches on
+FOSSIL_TEST(fossil_slab_many_live) {
+    fossil_thread_t thread;
+    void *first = NULL;
+    void *second = NULL;
+
+    for (int i = 0; i < SLAB_TEST_LIVE; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_slab_create(&live_slabs[i], 32));
+    }
+    fossil_slab_t *last = &live_slabs[SLAB_TEST_LIVE - 1];
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&thread, NULL, slab_touch, last));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(thread, &first));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&thread, NULL, slab_touch, last));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(thread, &second));
+
+    // The second thread adopts the cache the first abandoned.
+    ASSUME_NOT_CNULL(first);
+    ASSUME_ITS_TRUE(((uintptr_t)first & ~(uintptr_t)(FOSSIL_SLAB_PAGE_SIZE - 1)) ==
+                    ((uintptr_t)second & ~(uintptr_t)(FOSSIL_SLAB_PAGE_SIZE - 1)));
+
+    for (int i = 0; i < SLAB_TEST_LIVE; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_slab_destroy(&live_slabs[i]));
+    }
+}
+
+// Test Case 8: More slabs in use than a thread has direct cache slots
+FOSSIL_TEST(fossil_slab_many_in_use) {
+    fossil_thread_t threads[SLAB_TEST_USERS];
+    uintptr_t misses = 0;
+
+    for (int i = 0; i < SLAB_TEST_IN_USE; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_slab_create(&live_slabs[i], 32));
+    }
+    for (int i = 0; i < SLAB_TEST_USERS; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&threads[i], NULL, slab_round_robin, NULL));
+    }
+    for (int i = 0; i < SLAB_TEST_USERS; i++) {
+        void *result = NULL;
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(threads[i], &result));
+        misses += (uintptr_t)result;
+    }
+    ASSUME_ITS_EQUAL_I32(0, (int32_t)misses);
+
+    for (int i = 0; i < SLAB_TEST_IN_USE; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_slab_destroy(&live_slabs[i]));
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_slab_tests) {
+    ADD_TEST(fossil_slab_alloc_and_free);
+    ADD_TEST(fossil_slab_remote_free);
+    ADD_TEST(fossil_slab_create_invalid);
+    ADD_TEST(fossil_slab_size_classes);
+    ADD_TEST(fossil_arena_reset_reuses);
+    ADD_TEST(fossil_slab_pool_scratch);
+    ADD_TEST(fossil_slab_many_live);
+    ADD_TEST(fossil_slab_many_in_use);
+}
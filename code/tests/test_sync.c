@@ -16,6 +16,7 @@
 #include <fossil/xassume.h>
 
 #include "fossil/threads/framework.h"
+#include <string.h>
 
 FOSSIL_FIXEXIT(fixture_sync);
 // Test variables
@@ -63,6 +64,73 @@ void *increment_task(void *arg) {
     return NULL;
 }
 
+fossil_eventcount_t test_eventcount;
+int eventcount_flag = 0;
+
+void *eventcount_waiter(void *arg) {
+    while (!__atomic_load_n(&eventcount_flag, __ATOMIC_ACQUIRE)) {
+        uint32_t key = fossil_eventcount_prepare_wait(&test_eventcount);
+        if (__atomic_load_n(&eventcount_flag, __ATOMIC_ACQUIRE)) {
+            fossil_eventcount_cancel_wait(&test_eventcount);
+            break;
+        }
+        fossil_eventcount_wait(&test_eventcount, key);
+    }
+    return NULL;
+}
+
+void *profiled_locker(void *arg) {
+    for (int i = 0; i < 1000; i++) {
+        fossil_mutex_lock(&test_mutex);
+        shared_counter++;
+        fossil_mutex_unlock(&test_mutex);
+    }
+    return NULL;
+}
+
+#define BARRIER_TEST_THREADS 8
+#define BARRIER_TEST_PHASES 200
+
+fossil_barrier_t test_barrier;
+fossil_latch_t test_latch;
+static int barrier_arrivals[BARRIER_TEST_PHASES];
+static int barrier_errors = 0;
+static int barrier_serial = 0;
+
+// Every thread must see all arrivals of a phase once it leaves the barrier.
+void *barrier_worker(void *arg) {
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    for (int phase = 0; phase < BARRIER_TEST_PHASES; phase++) {
+        __atomic_fetch_add(&barrier_arrivals[phase], 1, __ATOMIC_RELAXED);
+        int32_t result = test_barrier.nodes ? fossil_barrier_wait_id(&test_barrier, id)
+                                            : fossil_barrier_wait(&test_barrier);
+        if (result == 1) __atomic_fetch_add(&barrier_serial, 1, __ATOMIC_RELAXED);
+        if (result < 0 || __atomic_load_n(&barrier_arrivals[phase], __ATOMIC_RELAXED) != BARRIER_TEST_THREADS) {
+            __atomic_fetch_add(&barrier_errors, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+void *latch_worker(void *arg) {
+    __atomic_fetch_add((int *)arg, 1, __ATOMIC_RELAXED);
+    fossil_latch_arrive_and_wait(&test_latch);
+    return NULL;
+}
+
+static void barrier_run(void) {
+    fossil_thread_t threads[BARRIER_TEST_THREADS];
+    memset(barrier_arrivals, 0, sizeof(barrier_arrivals));
+    barrier_errors = 0;
+    barrier_serial = 0;
+    for (uintptr_t i = 0; i < BARRIER_TEST_THREADS; i++) {
+        fossil_thread_create(&threads[i], NULL, barrier_worker, (void *)i);
+    }
+    for (int i = 0; i < BARRIER_TEST_THREADS; i++) {
+        fossil_thread_join(threads[i], NULL);
+    }
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -132,6 +200,111 @@ FOSSIL_TEST(fossil_semaphore_thread_sync) {
     ASSUME_ITS_EQUAL_I32(1, value);
 }
 
+// Test Case 1: Notify without waiters is a no-op
+FOSSIL_TEST(fossil_eventcount_notify_idle) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_eventcount_create(&test_eventcount));
+    ASSUME_ITS_EQUAL_I32(0, fossil_eventcount_notify(&test_eventcount));
+    ASSUME_ITS_EQUAL_I32(0, test_eventcount.epoch);
+    ASSUME_ITS_EQUAL_I32(0, fossil_eventcount_destroy(&test_eventcount));
+}
+
+// Test Case 2: Notify wakes a parked waiter
+FOSSIL_TEST(fossil_eventcount_wait_notify) {
+    fossil_thread_t thread;
+    eventcount_flag = 0;
+    fossil_eventcount_create(&test_eventcount);
+    fossil_thread_create(&thread, NULL, eventcount_waiter, NULL);
+
+    __atomic_store_n(&eventcount_flag, 1, __ATOMIC_RELEASE);
+    ASSUME_ITS_EQUAL_I32(0, fossil_eventcount_notify(&test_eventcount));
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(thread, NULL));
+    ASSUME_ITS_EQUAL_I32(0, fossil_eventcount_destroy(&test_eventcount));
+}
+
+// Test Case 1: Profiler attributes every sampled acquisition to the lock
+FOSSIL_TEST(fossil_lock_profile_counts) {
+    fossil_thread_t threads[2];
+    fossil_lock_profile_entry_t entries[16];
+
+    if (fossil_lock_profile_enable(1) != 0) return; // Compiled out.
+    fossil_lock_profile_reset();
+
+    for (int i = 0; i < 2; i++) {
+        fossil_thread_create(&threads[i], NULL, profiled_locker, NULL);
+    }
+    for (int i = 0; i < 2; i++) {
+        fossil_thread_join(threads[i], NULL);
+    }
+    fossil_lock_profile_enable(0);
+
+    uint64_t acquisitions = 0;
+    int32_t count = fossil_lock_profile_snapshot(entries, 16);
+    ASSUME_ITS_TRUE(count > 0);
+    for (int32_t i = 0; i < count; i++) {
+        if (entries[i].lock == &test_mutex) {
+            acquisitions += entries[i].acquisitions;
+            ASSUME_ITS_TRUE(entries[i].contended <= entries[i].acquisitions);
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(2000, acquisitions);
+
+    // Samples keep the weight of the period they were taken under.
+    fossil_lock_profile_enable(8);
+    count = fossil_lock_profile_snapshot(entries, 16);
+    fossil_lock_profile_enable(0);
+    acquisitions = 0;
+    for (int32_t i = 0; i < count; i++) {
+        if (entries[i].lock == &test_mutex) acquisitions += entries[i].acquisitions;
+    }
+    ASSUME_ITS_EQUAL_I32(2000, acquisitions);
+}
+
+// Test Case 1: A flat barrier separates every phase
+FOSSIL_TEST(fossil_barrier_phases) {
+    ASSUME_ITS_EQUAL_I32(-1, fossil_barrier_create(&test_barrier, 0));
+    ASSUME_ITS_EQUAL_I32(0, fossil_barrier_create(&test_barrier, BARRIER_TEST_THREADS));
+    barrier_run();
+    ASSUME_ITS_EQUAL_I32(0, barrier_errors);
+    ASSUME_ITS_EQUAL_I32(BARRIER_TEST_PHASES, barrier_serial);
+    ASSUME_ITS_EQUAL_I32(0, fossil_barrier_destroy(&test_barrier));
+}
+
+// Test Case 2: A tree barrier with an uneven last group, parking immediately
+FOSSIL_TEST(fossil_barrier_tree_phases) {
+    ASSUME_ITS_EQUAL_I32(-1, fossil_barrier_create_tree(&test_barrier, BARRIER_TEST_THREADS, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_barrier_create_tree(&test_barrier, BARRIER_TEST_THREADS, 3));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_barrier_wait(&test_barrier));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_barrier_wait_id(&test_barrier, BARRIER_TEST_THREADS));
+    ASSUME_ITS_EQUAL_I32(0, fossil_barrier_set_spin(&test_barrier, 0));
+    barrier_run();
+    ASSUME_ITS_EQUAL_I32(0, barrier_errors);
+    ASSUME_ITS_EQUAL_I32(BARRIER_TEST_PHASES, barrier_serial);
+    ASSUME_ITS_EQUAL_I32(0, fossil_barrier_destroy(&test_barrier));
+}
+
+// Test Case 3: A latch releases its waiters once it reaches zero
+FOSSIL_TEST(fossil_latch_count_down_wait) {
+    fossil_thread_t threads[4];
+    int arrived = 0;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_latch_create(&test_latch, 6));
+    ASSUME_ITS_EQUAL_I32(-1, fossil_latch_count_down(&test_latch, 7));
+    for (int i = 0; i < 4; i++) {
+        fossil_thread_create(&threads[i], NULL, latch_worker, &arrived);
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_latch_count_down(&test_latch, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_latch_count_down(&test_latch, 1));
+    ASSUME_ITS_EQUAL_I32(0, fossil_latch_wait(&test_latch));
+    ASSUME_ITS_EQUAL_I32(1, fossil_latch_try_wait(&test_latch));
+    ASSUME_ITS_EQUAL_I32(4, __atomic_load_n(&arrived, __ATOMIC_RELAXED));
+
+    for (int i = 0; i < 4; i++) {
+        fossil_thread_join(threads[i], NULL);
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_latch_destroy(&test_latch));
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -143,4 +316,10 @@ FOSSIL_TEST_GROUP(c_sync_tests) {
     ADD_TESTF(fossil_semaphore_init_post, fixture_sync);
     ADD_TESTF(fossil_semaphore_wait_case, fixture_sync);
     ADD_TESTF(fossil_semaphore_thread_sync, fixture_sync);
+    ADD_TEST(fossil_eventcount_notify_idle);
+    ADD_TEST(fossil_eventcount_wait_notify);
+    ADD_TESTF(fossil_lock_profile_counts, fixture_sync);
+    ADD_TEST(fossil_barrier_phases);
+    ADD_TEST(fossil_barrier_tree_phases);
+    ADD_TEST(fossil_latch_count_down_wait);
 }
\ No newline at end of file
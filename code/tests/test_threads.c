@@ -16,6 +16,7 @@
 #include <fossil/xassume.h>
 
 #include "fossil/threads/framework.h"
+#include <sched.h>
 
 // Test variables
 fossil_thread_t test_thread;
@@ -27,6 +28,25 @@ void *test_task(void *arg) {
     return NULL;
 }
 
+static _Thread_local int thread_marker;
+static int detached_done = 0;
+
+// Returns an address unique to the kernel thread running it.
+void *marker_task(void *arg) {
+    (void)arg;
+    return &thread_marker;
+}
+
+void *echo_task(void *arg) {
+    return arg;
+}
+
+void *detached_task(void *arg) {
+    (void)arg;
+    __atomic_fetch_add(&detached_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -54,6 +74,50 @@ FOSSIL_TEST(fossil_thread_create_with_attr) {
     fossil_thread_attr_erase(&test_attr);
 }
 
+// Test Case 4: Joined threads are reused and keep their join semantics
+FOSSIL_TEST(fossil_thread_cache_reuse) {
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_cache_enable(4));
+
+    void *first = NULL;
+    int reused = 0;
+    for (int i = 0; i < 50; i++) {
+        void *marker = NULL;
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&test_thread, NULL, marker_task, NULL));
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(test_thread, &marker));
+        if (!first) first = marker;
+        else if (marker == first) reused++;
+    }
+    // Join parks the thread before returning, so every create reuses it.
+    ASSUME_ITS_EQUAL_I32(49, reused);
+
+    // Concurrent threads each get their own return value back.
+    fossil_thread_t threads[8];
+    int values[8];
+    for (int i = 0; i < 8; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&threads[i], NULL, echo_task, &values[i]));
+    }
+    for (int i = 0; i < 8; i++) {
+        void *result = NULL;
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(threads[i], &result));
+        ASSUME_ITS_TRUE(result == &values[i]);
+    }
+
+    // Detached threads return to the cache on their own.
+    detached_done = 0;
+    for (int i = 0; i < 8; i++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&threads[i], NULL, detached_task, NULL));
+        ASSUME_ITS_EQUAL_I32(0, fossil_thread_detach(threads[i]));
+    }
+    while (__atomic_load_n(&detached_done, __ATOMIC_ACQUIRE) < 8) sched_yield();
+
+    // A thread started while the cache was on can be joined after it is off.
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_create(&test_thread, NULL, echo_task, &values[0]));
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_cache_disable());
+    void *result = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_join(test_thread, &result));
+    ASSUME_ITS_TRUE(result == &values[0]);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -62,4 +126,5 @@ FOSSIL_TEST_GROUP(c_threaded_tests) {
     ADD_TEST(fossil_thread_create_and_join);
     ADD_TEST(fossil_thread_create_null_task);
     ADD_TEST(fossil_thread_create_with_attr);
+    ADD_TEST(fossil_thread_cache_reuse);
 }
@@ -0,0 +1,120 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * performance, cross-platform applications and libraries. The code contained
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/unittest/framework.h>
+#include <fossil/mockup/framework.h>
+#include <fossil/xassume.h>
+
+#include "fossil/threads/framework.h"
+#include <string.h>
+
+// Test variables
+fossil_thread_pool_t trace_pool;
+
+void *trace_task(void *arg) {
+    __atomic_fetch_add((int *)arg, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+void *trace_named_thread(void *arg) {
+    fossil_trace_thread_name((const char *)arg);
+    fossil_trace_record(FOSSIL_TRACE_USER, NULL, 1);
+    return NULL;
+}
+
+static void trace_named_round(const char *name) {
+    fossil_thread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        fossil_thread_create(&threads[i], NULL, trace_named_thread, (void *)name);
+    }
+    for (int i = 0; i < 4; i++) {
+        fossil_thread_join(threads[i], NULL);
+    }
+}
+
+static int trace_contains(FILE *file, const char *needle) {
+    char buffer[4096];
+    size_t length = strlen(needle);
+    rewind(file);
+    while (fgets(buffer, sizeof(buffer), file)) {
+        if (strncmp(buffer, needle, length) == 0 || strstr(buffer, needle)) return 1;
+    }
+    return 0;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Test Case 1: Pool tasks show up as submit events and task slices
+FOSSIL_TEST(fossil_trace_pool_lifecycle) {
+    int counter = 0;
+    if (fossil_trace_start(1024) != 0) return; // Compiled out.
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_create(&trace_pool, 2));
+    for (int i = 0; i < 16; i++) {
+        fossil_thread_pool_submit(&trace_pool, trace_task, &counter);
+    }
+    ASSUME_ITS_EQUAL_I32(0, fossil_thread_pool_destroy(&trace_pool));
+    ASSUME_ITS_EQUAL_I32(0, fossil_trace_stop());
+
+    FILE *file = tmpfile();
+    ASSUME_NOT_CNULL(file);
+    ASSUME_ITS_EQUAL_I32(0, fossil_trace_dump(file));
+    ASSUME_ITS_TRUE(trace_contains(file, "\"traceEvents\""));
+    ASSUME_ITS_TRUE(trace_contains(file, "\"name\":\"submit\""));
+    ASSUME_ITS_TRUE(trace_contains(file, "\"ph\":\"B\",\"name\":\"task\""));
+    ASSUME_ITS_TRUE(trace_contains(file, "pool worker"));
+    fclose(file);
+}
+
+// Test Case 2: Recording while stopped leaves no events behind
+FOSSIL_TEST(fossil_trace_stopped_is_silent) {
+    if (fossil_trace_start(64) != 0) return; // Compiled out.
+    fossil_trace_stop();
+    fossil_trace_record(FOSSIL_TRACE_USER, NULL, 42);
+
+    FILE *file = tmpfile();
+    ASSUME_NOT_CNULL(file);
+    ASSUME_ITS_EQUAL_I32(0, fossil_trace_dump(file));
+    ASSUME_ITS_FALSE(trace_contains(file, "\"name\":\"user\""));
+    fclose(file);
+}
+
+// Test Case 3: Rings of exited threads are reused and names are escaped
+FOSSIL_TEST(fossil_trace_reused_escaped_names) {
+    if (fossil_trace_start(64) != 0) return; // Compiled out.
+    trace_named_round("first");
+    fossil_trace_stop();
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_trace_start(64));
+    trace_named_round("say \"hi\" \\ bye");
+    fossil_trace_stop();
+
+    FILE *file = tmpfile();
+    ASSUME_NOT_CNULL(file);
+    ASSUME_ITS_EQUAL_I32(0, fossil_trace_dump(file));
+    ASSUME_ITS_TRUE(trace_contains(file, "\"name\":\"say \\\"hi\\\" \\\\ bye\""));
+    ASSUME_ITS_FALSE(trace_contains(file, "\"name\":\"first\""));
+    fclose(file);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_trace_tests) {
+    ADD_TEST(fossil_trace_pool_lifecycle);
+    ADD_TEST(fossil_trace_stopped_is_silent);
+    ADD_TEST(fossil_trace_reused_escaped_names);
+}
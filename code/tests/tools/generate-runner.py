@@ -12,7 +12,7 @@ class TestRunnerGenerator:
 
         for root, _, files in os.walk(self.directory):
             for file in files:
-                if file.startswith("test_") and file.endswith(".c"):
+                if file.startswith("test_") and file.endswith((".c", ".cpp")):
                     with open(os.path.join(root, file), "r") as f:
                         content = f.read()
                         matches = re.findall(pattern, content)